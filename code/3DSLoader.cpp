@@ -1000,14 +1000,11 @@ void Discreet3DSImporter::ParseMeshChunk()
 	case Discreet3DS::CHUNK_VERTLIST:
 		{
 		// This is the list of all vertices in the current mesh
-		int num = (int)(uint16_t)stream->GetI2();
-		mMesh.mPositions.reserve(num);
-		while (num-- > 0)	{
-			aiVector3D v;
-			v.x = stream->GetF4();
-			v.y = stream->GetF4();
-			v.z = stream->GetF4();
-			mMesh.mPositions.push_back(v);
+		const unsigned int num = (uint16_t)stream->GetI2();
+		const size_t base = mMesh.mPositions.size();
+		mMesh.mPositions.resize(base+num);
+		if (num)	{
+			stream->GetArray((float*)&mMesh.mPositions[base],num*3);
 		}}
 		break;
 	case Discreet3DS::CHUNK_TRMATRIX:
@@ -1032,31 +1029,38 @@ void Discreet3DSImporter::ParseMeshChunk()
 	case Discreet3DS::CHUNK_MAPLIST:
 		{
 		// This is the list of all UV coords in the current mesh
-		int num = (int)(uint16_t)stream->GetI2();
-		mMesh.mTexCoords.reserve(num);
-		while (num-- > 0)	{
-			aiVector3D v;
-			v.x = stream->GetF4();
-			v.y = stream->GetF4();
-			mMesh.mTexCoords.push_back(v);
+		const unsigned int num = (uint16_t)stream->GetI2();
+		if (!num)	{
+			break;
+		}
+
+		std::vector<float> uv(num*2);
+		stream->GetArray(&uv[0],uv.size());
+
+		mMesh.mTexCoords.reserve(mMesh.mTexCoords.size()+num);
+		for (unsigned int i = 0; i < num; ++i)	{
+			mMesh.mTexCoords.push_back(aiVector3D(uv[i*2],uv[i*2+1],0.f));
 		}}
 		break;
 
 	case Discreet3DS::CHUNK_FACELIST:
 		{
 		// This is the list of all faces in the current mesh
-		int num = (int)(uint16_t)stream->GetI2();
-		mMesh.mFaces.reserve(num);
-		while (num-- > 0)	{
-			// 3DS faces are ALWAYS triangles
-			mMesh.mFaces.push_back(D3DS::Face());
-			D3DS::Face& sFace = mMesh.mFaces.back();
-
-			sFace.mIndices[0] = (uint16_t)stream->GetI2();
-			sFace.mIndices[1] = (uint16_t)stream->GetI2();
-			sFace.mIndices[2] = (uint16_t)stream->GetI2();
-
-			stream->IncPtr(2); // skip edge visibility flag
+		const unsigned int num = (uint16_t)stream->GetI2();
+		if (num)	{
+			// 3DS faces are ALWAYS triangles, followed by the edge visibility flag we skip
+			std::vector<uint16_t> indices(num*3);
+			stream->GetStridedArray(&indices[0],num,3,8);
+
+			mMesh.mFaces.reserve(mMesh.mFaces.size()+num);
+			for (unsigned int i = 0; i < num; ++i)	{
+				mMesh.mFaces.push_back(D3DS::Face());
+				D3DS::Face& sFace = mMesh.mFaces.back();
+
+				sFace.mIndices[0] = indices[i*3];
+				sFace.mIndices[1] = indices[i*3+1];
+				sFace.mIndices[2] = indices[i*3+2];
+			}
 		}
 
 		// Resize the material array (0xcdcdcdcd marks the default material; so if a face is 
@@ -0,0 +1,180 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2012, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms, 
+with or without modification, are permitted provided that the 
+following conditions are met:
+
+* Redistributions of source code must retain the above
+copyright notice, this list of conditions and the
+following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the
+following disclaimer in the documentation and/or other
+materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+contributors may be used to endorse or promote products
+derived from this software without specific prior
+written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  AnimMeshBuilder.cpp
+ *  @brief Implementation of a little class to store the key frames of vertex-animated models
+ */
+
+#include "AssimpPCH.h"
+#include "../include/assimp/scene.h"
+#include "AnimMeshBuilder.h"
+#include "TinyFormatter.h"
+
+using namespace Assimp;
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Check whether two key frames of the same mesh are bitwise identical 
+bool IsSameFrame(const aiAnimMesh* a, const aiAnimMesh* b)
+{
+	ai_assert(a->mNumVertices == b->mNumVertices);
+
+	const size_t size = a->mNumVertices * sizeof(aiVector3D);
+	if (!a->mVertices != !b->mVertices || !a->mNormals != !b->mNormals) {
+		return false;
+	}
+	if (a->mVertices && ::memcmp(a->mVertices,b->mVertices,size)) {
+		return false;
+	}
+	if (a->mNormals && ::memcmp(a->mNormals,b->mNormals,size)) {
+		return false;
+	}
+	return true;
+}
+
+} // ! anon
+
+// ------------------------------------------------------------------------------------------------
+AnimMeshBuilder::AnimMeshBuilder(double ticksPerSecond)
+	: mTicksPerSecond(ticksPerSecond)
+{
+}
+
+// ------------------------------------------------------------------------------------------------
+AnimMeshBuilder::~AnimMeshBuilder()
+{
+	// delete all key frames which have not been handed over to a scene
+	for (TrackMap::iterator it = mTracks.begin(); it != mTracks.end(); ++it) {
+		for (std::vector<aiAnimMesh*>::iterator f = (*it).second.mFrames.begin(); f != (*it).second.mFrames.end(); ++f) {
+			delete *f;
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+aiAnimMesh* AnimMeshBuilder::NewFrame(const aiMesh* pMesh)
+{
+	aiAnimMesh* frame = new aiAnimMesh();
+	frame->mNumVertices = pMesh->mNumVertices;
+	frame->mVertices = new aiVector3D[pMesh->mNumVertices];
+	if (pMesh->HasNormals()) {
+		frame->mNormals = new aiVector3D[pMesh->mNumVertices];
+	}
+	return frame;
+}
+
+// ------------------------------------------------------------------------------------------------
+void AnimMeshBuilder::AddFrame(const aiMesh* pMesh, aiAnimMesh* pFrame)
+{
+	Track& track = mTracks[pMesh];
+
+	// reuse the previous key frame if nothing moved
+	if (!track.mFrames.empty() && IsSameFrame(track.mFrames[track.mKeys.back()],pFrame)) {
+		delete pFrame;
+		track.mKeys.push_back(track.mKeys.back());
+		return;
+	}
+
+	track.mKeys.push_back(static_cast<unsigned int>(track.mFrames.size()));
+	track.mFrames.push_back(pFrame);
+}
+
+// ------------------------------------------------------------------------------------------------
+void AnimMeshBuilder::Finish(aiScene* pScene)
+{
+	if (mTracks.empty()) {
+		return;
+	}
+
+	std::vector<aiMeshAnim*> channels;
+	unsigned int numKeys = 0, numFrames = 0;
+
+	// process meshes in scene order to get a deterministic channel order
+	for (unsigned int i = 0; i < pScene->mNumMeshes; ++i) {
+		aiMesh* mesh = pScene->mMeshes[i];
+
+		TrackMap::iterator it = mTracks.find(mesh);
+		if (it == mTracks.end()) {
+			continue;
+		}
+		Track& track = (*it).second;
+		ai_assert(!mesh->mNumAnimMeshes);
+
+		mesh->mNumAnimMeshes = static_cast<unsigned int>(track.mFrames.size());
+		mesh->mAnimMeshes = new aiAnimMesh*[mesh->mNumAnimMeshes];
+		std::copy(track.mFrames.begin(),track.mFrames.end(),mesh->mAnimMeshes);
+
+		if (!mesh->mName.length) {
+			mesh->mName.Set((Formatter::format(),"$AnimMesh",i));
+		}
+
+		aiMeshAnim* channel = new aiMeshAnim();
+		channel->mName = mesh->mName;
+		channel->mNumKeys = static_cast<unsigned int>(track.mKeys.size());
+		channel->mKeys = new aiMeshKey[channel->mNumKeys];
+		for (unsigned int k = 0; k < channel->mNumKeys; ++k) {
+			channel->mKeys[k] = aiMeshKey(static_cast<double>(k),track.mKeys[k]);
+		}
+
+		channels.push_back(channel);
+		numKeys = std::max(numKeys,channel->mNumKeys);
+		numFrames += mesh->mNumAnimMeshes;
+
+		mTracks.erase(it);
+	}
+	ai_assert(mTracks.empty());
+
+	aiAnimation* anim = new aiAnimation();
+	anim->mDuration = numKeys ? numKeys - 1. : 0.;
+	anim->mTicksPerSecond = mTicksPerSecond;
+	anim->mNumMeshChannels = static_cast<unsigned int>(channels.size());
+	anim->mMeshChannels = new aiMeshAnim*[anim->mNumMeshChannels];
+	std::copy(channels.begin(),channels.end(),anim->mMeshChannels);
+
+	aiAnimation** anims = new aiAnimation*[pScene->mNumAnimations+1];
+	std::copy(pScene->mAnimations,pScene->mAnimations+pScene->mNumAnimations,anims);
+	anims[pScene->mNumAnimations++] = anim;
+	delete[] pScene->mAnimations;
+	pScene->mAnimations = anims;
+
+	DefaultLogger::get()->debug((Formatter::format(),"AnimMeshBuilder: ",numKeys," key frames, ",
+		numFrames," distinct frames in ",anim->mNumMeshChannels," meshes"));
+}
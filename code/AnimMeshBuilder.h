@@ -0,0 +1,121 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2012, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms, 
+with or without modification, are permitted provided that the 
+following conditions are met:
+
+* Redistributions of source code must retain the above
+copyright notice, this list of conditions and the
+following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the
+following disclaimer in the documentation and/or other
+materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+contributors may be used to endorse or promote products
+derived from this software without specific prior
+written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file AnimMeshBuilder.h
+ *  Declares AnimMeshBuilder, a little utility to store the key frames of
+ *  vertex-animated models as aiAnimMesh instances.
+ */
+
+#ifndef AI_ANIMMESHBUILDER_H_INC
+#define AI_ANIMMESHBUILDER_H_INC
+
+#include <vector>
+#include <map>
+#include "../include/assimp/mesh.h"
+
+struct aiScene;
+
+namespace Assimp	{
+
+// ---------------------------------------------------------------------------
+/** 
+ * This little helper class collects the key frames of vertex-animated meshes
+ * (i.e. MD2, MD3, MDL, MDC) and attaches them to their host meshes as 
+ * #aiAnimMesh instances. A single #aiAnimation with one #aiMeshAnim channel
+ * per animated mesh is appended to the scene. 
+ *
+ * Key frames are expected to contain only the vertex components which are 
+ * actually animated (usually positions and normals), all other data is
+ * shared with the host mesh. If a key frame does not differ from the previous
+ * key frame of the same mesh, it is dropped and its key refers to the 
+ * previous #aiAnimMesh instead. Storage thus grows with the amount of motion
+ * in the model rather than with its number of frames.
+ */
+class AnimMeshBuilder
+{
+public:
+
+	// -------------------------------------------------------------------
+	/** @param ticksPerSecond Playback rate of the key frames, one key 
+	 *    frame is one tick. */
+	AnimMeshBuilder(double ticksPerSecond);
+
+	~AnimMeshBuilder();
+
+public:
+
+	// -------------------------------------------------------------------
+	/** Allocates an empty key frame for a mesh. Storage for positions
+	 *  and normals (if the host mesh has normals) is allocated, but not 
+	 *  initialized.
+	 *  @param pMesh Host mesh */
+	static aiAnimMesh* NewFrame(const aiMesh* pMesh);
+
+	// -------------------------------------------------------------------
+	/** Adds the next key frame of a mesh. 
+	 *  @param pMesh Host mesh
+	 *  @param pFrame Key frame data, usually obtained via NewFrame().
+	 *    Ownership is transferred to the AnimMeshBuilder. */
+	void AddFrame(const aiMesh* pMesh, aiAnimMesh* pFrame);
+
+	// -------------------------------------------------------------------
+	/** Attaches all key frames to their host meshes and adds the 
+	 *  animation to the scene. Unnamed host meshes receive a name
+	 *  since mesh animation channels refer to meshes by their names.
+	 *  @param pScene Scene containing all meshes passed to AddFrame(). */
+	void Finish(aiScene* pScene);
+
+protected:
+
+	struct Track
+	{
+		std::vector<aiAnimMesh*> mFrames;
+		std::vector<unsigned int> mKeys;
+	};
+
+	typedef std::map<const aiMesh*, Track> TrackMap;
+	TrackMap mTracks;
+
+	double mTicksPerSecond;
+};
+
+} // end of namespace Assimp
+
+#endif // AI_ANIMMESHBUILDER_H_INC
@@ -3,6 +3,7 @@
 
 #include "AssimpPCH.h"
 #include "./../include/assimp/version.h"
+#include "SceneCombiner.h"
 
 static const unsigned int MajorVersion = 3;
 static const unsigned int MinorVersion = 1;
@@ -94,6 +95,9 @@ ASSIMP_API aiScene::aiScene()
 // ------------------------------------------------------------------------------------------------
 ASSIMP_API aiScene::~aiScene()
 {
+	// arrays shared with other scenes are not ours to delete
+	Assimp::SceneCombiner::ReleaseSharedData(this);
+
 	// delete all sub-objects recursively
 	delete mRootNode;
 
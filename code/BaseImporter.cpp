@@ -48,6 +48,12 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "FileSystemFilter.h"
 
 #include "Importer.h"
+#include "SceneCombiner.h"
+#include "Hash.h"
+
+#ifndef ASSIMP_BUILD_BOOST_WORKAROUND
+#	include <boost/thread/mutex.hpp>
+#endif
 
 using namespace Assimp;
 
@@ -466,12 +472,133 @@ namespace Assimp
 	};
 }
 
+// ------------------------------------------------------------------------------------------------
+namespace {
+
+	// An entry in the process-wide scene cache. Besides the import settings, the
+	// key includes the size and a hash of the file contents. IOSystem has no way
+	// to query modification times, so this is how outdated entries are detected.
+	struct CachedScene
+	{
+		CachedScene()
+			: flags(), fileSize(), hash(), scene(), memory()
+		{}
+
+		std::string file;
+		unsigned int flags;
+		BatchLoader::PropertyMap map;
+		size_t fileSize;
+		uint32_t hash;
+
+		aiScene* scene;
+		size_t memory;
+
+		bool Matches(const CachedScene& other) const {
+			return fileSize == other.fileSize && hash == other.hash && flags == other.flags &&
+				file == other.file && map == other.map;
+		}
+	};
+
+	// ------------------------------------------------------------------------------------------------
+	// Process-wide cache of the external scenes loaded by BatchLoader. Entries
+	// are kept in least-recently-used order, the oldest ones are dropped as
+	// soon as their total size exceeds the limit. The cache keeps its own
+	// copies, callers always receive a copy they own. All of these copies
+	// share their vertex and animation data until they are modified.
+	//
+	// Importer instances may be used on different threads even if assimp
+	// itself is built without threading support, so the cache is always 
+	// locked. This needs boost::thread, builds using the boost workaround
+	// have no cache, see BatchLoader::SetCacheSize().
+	class SceneCache
+	{
+	public:
+
+		SceneCache()
+			: limit()
+			, total()
+		{}
+
+		~SceneCache() {
+			limit = 0;
+			Evict();
+		}
+
+		void SetLimit(size_t bytes) {
+#ifndef ASSIMP_BUILD_BOOST_WORKAROUND
+			boost::mutex::scoped_lock lock(mutex);
+#endif
+			limit = bytes;
+			Evict();
+		}
+
+		// Get a copy of a cached scene, NULL if there is none
+		aiScene* Get(const CachedScene& key) {
+#ifndef ASSIMP_BUILD_BOOST_WORKAROUND
+			boost::mutex::scoped_lock lock(mutex);
+#endif
+			for (std::list<CachedScene>::iterator it = entries.begin(); it != entries.end(); ++it) {
+				if ((*it).Matches(key)) {
+					entries.splice(entries.begin(),entries,it);
+
+					aiScene* scene;
+					SceneCombiner::CopySceneShared(&scene,entries.front().scene);
+					return scene;
+				}
+			}
+			return NULL;
+		}
+
+		// Add a copy of a scene unless it is already cached or too large
+		void Add(const CachedScene& key, aiScene* scene, size_t memory) {
+#ifndef ASSIMP_BUILD_BOOST_WORKAROUND
+			boost::mutex::scoped_lock lock(mutex);
+#endif
+			if (memory > limit) {
+				return;
+			}
+			for (std::list<CachedScene>::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+				if ((*it).Matches(key)) {
+					return;
+				}
+			}
+
+			entries.push_front(key);
+			SceneCombiner::CopySceneShared(&entries.front().scene,scene);
+			entries.front().memory = memory;
+
+			total += memory;
+			Evict();
+		}
+
+	private:
+
+		void Evict() {
+			while (total > limit) {
+				total -= entries.back().memory;
+				delete entries.back().scene;
+				entries.pop_back();
+			}
+		}
+
+		std::list<CachedScene> entries;
+		size_t limit, total;
+
+#ifndef ASSIMP_BUILD_BOOST_WORKAROUND
+		boost::mutex mutex;
+#endif
+	};
+
+	SceneCache sceneCache;
+}
+
 // ------------------------------------------------------------------------------------------------
 // BatchLoader::pimpl data structure
 struct Assimp::BatchData
 {
 	BatchData()
 		:	next_id(0xffff)
+		,	useCache(false)
 	{}
 
 	// IO system to be used for all imports
@@ -488,6 +615,9 @@ struct Assimp::BatchData
 
 	// Id for next item
 	unsigned int next_id;
+
+	// Use the process-wide scene cache?
+	bool useCache;
 };
 
 // ------------------------------------------------------------------------------------------------
@@ -563,6 +693,21 @@ aiScene* BatchLoader::GetImport		(unsigned int which)
 	return NULL;
 }
 
+// ------------------------------------------------------------------------------------------------
+void BatchLoader::SetCacheSize(unsigned int megabytes)
+{
+#ifndef ASSIMP_BUILD_BOOST_WORKAROUND
+	data->useCache = megabytes > 0;
+	if (data->useCache) {
+		sceneCache.SetLimit(static_cast<size_t>(megabytes) << 20);
+	}
+#else
+	if (megabytes) {
+		DefaultLogger::get()->warn("Scene cache is not available, boost::thread is required");
+	}
+#endif
+}
+
 // ------------------------------------------------------------------------------------------------
 void BatchLoader::LoadAll()
 {
@@ -573,6 +718,32 @@ void BatchLoader::LoadAll()
 #ifdef ASSIMP_BUILD_DEBUG
 		pp |= aiProcess_ValidateDataStructure;
 #endif
+
+		// look the file up in the scene cache, if it can't be read the importer will report this
+		CachedScene key;
+		bool haveKey = false;
+		if (data->useCache) {
+			boost::scoped_ptr<IOStream> file(data->pIOSystem->Open((*it).file));
+			if (file) {
+				std::vector<char> buffer(file->FileSize());
+				if (buffer.empty() || buffer.size() == file->Read(&buffer[0],1,buffer.size())) {
+					key.file = (*it).file;
+					key.flags = pp;
+					key.map = (*it).map;
+					key.fileSize = buffer.size();
+					key.hash = buffer.empty() ? 0 : SuperFastHash(&buffer[0],static_cast<uint32_t>(buffer.size()));
+					haveKey = true;
+
+					(*it).scene = sceneCache.Get(key);
+				}
+			}
+		}
+
+		if ((*it).scene) {
+			DefaultLogger::get()->info("Using cached copy of external file " + (*it).file);
+			(*it).loaded = true;
+			continue;
+		}
 		// setup config properties if necessary
 		ImporterPimpl* pimpl = data->pImporter->Pimpl();
 		pimpl->mFloatProperties  = (*it).map.floats;
@@ -586,7 +757,14 @@ void BatchLoader::LoadAll()
 			DefaultLogger::get()->info("File: " + (*it).file);
 		}
 		data->pImporter->ReadFile((*it).file,pp);
+
+		aiMemoryInfo mem;
+		data->pImporter->GetMemoryRequirements(mem);
 		(*it).scene = data->pImporter->GetOrphanedScene();
+
+		if (haveKey && (*it).scene) {
+			sceneCache.Add(key,(*it).scene,mem.total);
+		}
 		(*it).loaded = true;
 
 		DefaultLogger::get()->info("%%% END EXTERNAL FILE %%%");
@@ -217,6 +217,7 @@ void DNAParser :: Parse ()
 
 	dna.AddPrimitiveStructures();
 	dna.RegisterConverters();
+	dna.ResolveReferences();
 }
 
 
@@ -274,13 +275,13 @@ boost::shared_ptr< ElemBase > DNA :: ConvertBlobToStructure(
 	const FileDatabase& db
 ) const 
 {
-	std::map<std::string, FactoryPair >::const_iterator it = converters.find(structure.name);
-	if (it == converters.end()) {
+	const FactoryPair builders = GetBlobToStructureConverter(structure,db);
+	if (!builders.first) {
 		return boost::shared_ptr< ElemBase >();
 	}
 
-	boost::shared_ptr< ElemBase > ret = (structure.*((*it).second.first))();
-	(structure.*((*it).second.second))(ret,db);
+	boost::shared_ptr< ElemBase > ret = (structure.*(builders.first))();
+	(structure.*(builders.second))(ret,db);
 	
 	return ret;
 }
@@ -291,10 +292,32 @@ DNA::FactoryPair DNA :: GetBlobToStructureConverter(
 	const FileDatabase& /*db*/
 ) const 
 {
+	// fast path for our own structures, see ResolveReferences()
+	if (!structure_converters.empty() && &structure >= &structures.front() && &structure <= &structures.back()) {
+		return structure_converters[&structure - &structures.front()];
+	}
+
 	std::map<std::string,  FactoryPair>::const_iterator it = converters.find(structure.name);
 	return it == converters.end() ? FactoryPair() : (*it).second;
 }
 
+// ------------------------------------------------------------------------------------------------
+void DNA :: ResolveReferences()
+{
+	structure_converters.resize(structures.size());
+	for (size_t i = 0; i < structures.size(); ++i) {
+		Structure& s = structures[i];
+		for_each(Field& f, s.fields) {
+			f.type_struct = Get(f.type);
+		}
+
+		std::map<std::string,  FactoryPair>::const_iterator it = converters.find(s.name);
+		if (it != converters.end()) {
+			structure_converters[i] = (*it).second;
+		}
+	}
+}
+
 // basing on http://www.blender.org/development/architecture/notes-on-sdna/
 // ------------------------------------------------------------------------------------------------
 void DNA :: AddPrimitiveStructures()
@@ -311,29 +334,34 @@ void DNA :: AddPrimitiveStructures()
 	structures.push_back( Structure() );
 	structures.back().name = "int";
 	structures.back().size = 4;
+	structures.back().primitive = PrimitiveType_Int;
 
 	indices["short"] = structures.size();
 	structures.push_back( Structure() );
 	structures.back().name = "short";
 	structures.back().size = 2;
+	structures.back().primitive = PrimitiveType_Short;
 
 
 	indices["char"] = structures.size();
 	structures.push_back( Structure() );
 	structures.back().name = "char";
 	structures.back().size = 1;
+	structures.back().primitive = PrimitiveType_Char;
 
 
 	indices["float"] = structures.size();
 	structures.push_back( Structure() );
 	structures.back().name = "float";
 	structures.back().size = 4;
+	structures.back().primitive = PrimitiveType_Float;
 
 
 	indices["double"] = structures.size();
 	structures.push_back( Structure() );
 	structures.back().name = "double";
 	structures.back().size = 8;
+	structures.back().primitive = PrimitiveType_Double;
 
 	// no long, seemingly.
 }
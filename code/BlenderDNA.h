@@ -61,6 +61,7 @@ namespace Assimp	{
 
 	namespace Blender {
 		class  FileDatabase;
+		class  Structure;
 		struct FileBlockHead;
 
 		template <template <typename> class TOUT>
@@ -168,6 +169,25 @@ struct Field
 
 	/** Any of the #FieldFlags enumerated values */
 	unsigned int flags;
+
+	/** Structure definition for #type, NULL if there is none. 
+	 *  Set by DNA::ResolveReferences(). */
+	const Structure* type_struct;
+};
+
+// -------------------------------------------------------------------------------
+/** Primitive data types. These are represented by dummy structures (see 
+ *  DNA::AddPrimitiveStructures()), the converters for primitive values
+ *  dispatch on this rather than on the structure name. */
+// -------------------------------------------------------------------------------
+enum PrimitiveType
+{
+	PrimitiveType_None,
+	PrimitiveType_Int,
+	PrimitiveType_Short,
+	PrimitiveType_Char,
+	PrimitiveType_Float,
+	PrimitiveType_Double
 };
 
 // -------------------------------------------------------------------------------
@@ -204,7 +224,8 @@ class Structure
 public:
 
 	Structure()
-		:	cache_idx(-1)
+		:	primitive(PrimitiveType_None)
+		,	cache_idx(-1)
 	{}
 
 public:
@@ -215,6 +236,7 @@ public:
 	std::map<std::string, size_t> indices;
 
 	size_t size;
+	PrimitiveType primitive;
 
 public:
 
@@ -228,6 +250,13 @@ public:
 	/** Access a field of the structure by its index */
 	inline const Field& operator [] (const size_t i) const;
 
+	// --------------------------------------------------------
+	/** Access a field of the structure by a name which remains at the
+	 *  same address, i.e. a string literal in one of the converters. 
+	 *  Lookups are cached by that address, so names are compared only
+	 *  once per call site. Raises an import error on failure. */
+	inline const Field& GetField (const char* ss) const;
+
 	// --------------------------------------------------------
 	inline bool operator== (const Structure& other) const {
 		return name == other.name; // name is meant to be an unique identifier
@@ -299,8 +328,15 @@ public:
 	void ReadField(T& out, const char* name, 
 		const FileDatabase& db) const;
 
+	// note: all the ReadFieldXXX() functions expect `name` to be a string 
+	// literal, see GetField().
+
 private:
 
+	// --------------------------------------------------------
+	static inline const Structure& GetFieldType(const Field& f, 
+		const FileDatabase& db);
+
 	// --------------------------------------------------------
 	template <template <typename> class TOUT, typename T>
 	bool ResolvePointer(TOUT<T>& out, const Pointer & ptrval, 
@@ -364,6 +400,7 @@ private:
 private:
 
 	mutable size_t cache_idx;
+	mutable std::map<const char*, const Field*> field_cache;
 };
 
 // --------------------------------------------------------
@@ -423,6 +460,10 @@ public:
 	vector<Structure > structures;
 	std::map<std::string, size_t> indices;
 
+	// converters for all entries in `structures`, by index.
+	// Set by ResolveReferences().
+	std::vector<FactoryPair> structure_converters;
+
 public:
 
 	// --------------------------------------------------------
@@ -451,6 +492,14 @@ public:
 	 *  known at compile time (consier Object::data).*/
 	void RegisterConverters();
 
+	// --------------------------------------------------------
+	/** Resolve the structure definitions for the types of all fields
+	 *  and the converters for all structures, so they need not be
+	 *  looked up by name during conversion. Call this once all
+	 *  structures and converters have been added, the structures
+	 *  may not be changed afterwards. */
+	void ResolveReferences();
+
 
 	// --------------------------------------------------------
 	/** Take an input blob from the stream, interpret it according to 
@@ -68,6 +68,26 @@ const Field* Structure :: Get (const std::string& ss) const
 	return it == indices.end() ? NULL : &fields[(*it).second];
 }
 
+//--------------------------------------------------------------------------------
+const Field& Structure :: GetField (const char* ss) const
+{
+	std::map<const char*, const Field*>::const_iterator it = field_cache.find(ss);
+	if (it != field_cache.end()) {
+		return *(*it).second;
+	}
+
+	// failed lookups are not cached, the exception is expensive anyway
+	const Field& f = (*this)[std::string(ss)];
+	field_cache[ss] = &f;
+	return f;
+}
+
+//--------------------------------------------------------------------------------
+const Structure& Structure :: GetFieldType(const Field& f, const FileDatabase& db)
+{
+	return f.type_struct ? *f.type_struct : db.dna[f.type];
+}
+
 //--------------------------------------------------------------------------------
 const Field& Structure :: operator [] (const size_t i) const 
 {
@@ -100,8 +120,8 @@ void Structure :: ReadFieldArray(T (& out)[M], const char* name, const FileDatab
 {
 	const StreamReaderAny::pos old = db.reader->GetCurrentPos();
 	try {
-		const Field& f = (*this)[name];
-		const Structure& s = db.dna[f.type];
+		const Field& f = GetField(name);
+		const Structure& s = GetFieldType(f,db);
 
 		// is the input actually an array?
 		if (!(f.flags & FieldFlag_Array)) {
@@ -139,8 +159,8 @@ void Structure :: ReadFieldArray2(T (& out)[M][N], const char* name, const FileD
 {
 	const StreamReaderAny::pos old = db.reader->GetCurrentPos();
 	try {
-		const Field& f = (*this)[name];
-		const Structure& s = db.dna[f.type];
+		const Field& f = GetField(name);
+		const Structure& s = GetFieldType(f,db);
 
 		// is the input actually an array?
 		if (!(f.flags & FieldFlag_Array)) {
@@ -187,7 +207,7 @@ bool Structure :: ReadFieldPtr(TOUT<T>& out, const char* name, const FileDatabas
 	Pointer ptrval;
 	const Field* f;
 	try {
-		f = &(*this)[name];
+		f = &GetField(name);
 
 		// sanity check, should never happen if the genblenddna script is right
 		if (!(f->flags & FieldFlag_Pointer)) {
@@ -232,7 +252,7 @@ bool Structure :: ReadFieldPtr(TOUT<T> (&out)[N], const char* name,
 	Pointer ptrval[N];
 	const Field* f;
 	try {
-		f = &(*this)[name];
+		f = &GetField(name);
 
 		// sanity check, should never happen if the genblenddna script is right
 		if ((FieldFlag_Pointer|FieldFlag_Pointer) != (f->flags & (FieldFlag_Pointer|FieldFlag_Pointer))) {
@@ -282,9 +302,9 @@ void Structure :: ReadField(T& out, const char* name, const FileDatabase& db) co
 {
 	const StreamReaderAny::pos old = db.reader->GetCurrentPos();
 	try {
-		const Field& f = (*this)[name];
+		const Field& f = GetField(name);
 		// find the structure definition pertaining to this field
-		const Structure& s = db.dna[f.type];
+		const Structure& s = GetFieldType(f,db);
 
 		db.reader->IncPtr(f.offset);
 		s.Convert(out,db);
@@ -312,7 +332,7 @@ bool Structure :: ResolvePointer(TOUT<T>& out, const Pointer & ptrval, const Fil
 	if (!ptrval.val) { 
 		return false;
 	}
-	const Structure& s = db.dna[f.type];
+	const Structure& s = GetFieldType(f,db);
 	// find the file block the pointer is pointing to
 	const FileBlockHead* block = LocateFileBlockForAddress(ptrval,db);
 
@@ -554,22 +574,23 @@ template <> struct static_cast_silent<double> {
 // ------------------------------------------------------------------------------------------------
 template <typename T> inline void ConvertDispatcher(T& out, const Structure& in,const FileDatabase& db) 
 {
-	if (in.name == "int") {
+	switch (in.primitive) {
+	case PrimitiveType_Int:
 		out = static_cast_silent<T>()(db.reader->GetU4());
-	}
-	else if (in.name == "short") {
+		break;
+	case PrimitiveType_Short:
 		out = static_cast_silent<T>()(db.reader->GetU2());
-	}
-	else if (in.name == "char") {
+		break;
+	case PrimitiveType_Char:
 		out = static_cast_silent<T>()(db.reader->GetU1());
-	}
-	else if (in.name == "float") {
+		break;
+	case PrimitiveType_Float:
 		out = static_cast<T>(db.reader->GetF4());
-	}
-	else if (in.name == "double") {
+		break;
+	case PrimitiveType_Double:
 		out = static_cast<T>(db.reader->GetF8());
-	}
-	else {
+		break;
+	default:
 		throw DeadlyImportError("Unknown source for conversion to primitive data type: "+in.name);
 	}
 }
@@ -584,12 +605,12 @@ template <> inline void Structure :: Convert<int>    (int& dest,const FileDataba
 template <> inline void Structure :: Convert<short>  (short& dest,const FileDatabase& db) const
 {
 	// automatic rescaling from short to float and vice versa (seems to be used by normals)
-	if (name == "float") {
+	if (primitive == PrimitiveType_Float) {
 		dest = static_cast<short>(db.reader->GetF4() * 32767.f);
 		//db.reader->IncPtr(-4);
 		return;
 	}
-	else if (name == "double") {
+	else if (primitive == PrimitiveType_Double) {
 		dest = static_cast<short>(db.reader->GetF8() * 32767.);
 		//db.reader->IncPtr(-8);
 		return;
@@ -601,11 +622,11 @@ template <> inline void Structure :: Convert<short>  (short& dest,const FileData
 template <> inline void Structure :: Convert<char>   (char& dest,const FileDatabase& db) const
 {
 	// automatic rescaling from char to float and vice versa (seems useful for RGB colors)
-	if (name == "float") {
+	if (primitive == PrimitiveType_Float) {
 		dest = static_cast<char>(db.reader->GetF4() * 255.f);
 		return;
 	}
-	else if (name == "double") {
+	else if (primitive == PrimitiveType_Double) {
 		dest = static_cast<char>(db.reader->GetF8() * 255.f);
 		return;
 	}
@@ -616,12 +637,12 @@ template <> inline void Structure :: Convert<char>   (char& dest,const FileDatab
 template <> inline void Structure :: Convert<float>  (float& dest,const FileDatabase& db) const
 {
 	// automatic rescaling from char to float and vice versa (seems useful for RGB colors)
-	if (name == "char") {
+	if (primitive == PrimitiveType_Char) {
 		dest = db.reader->GetI1() / 255.f;
 		return;
 	}
 	// automatic rescaling from short to float and vice versa (used by normals)
-	else if (name == "short") {
+	else if (primitive == PrimitiveType_Short) {
 		dest = db.reader->GetI2() / 32767.f;
 		return;
 	}
@@ -631,11 +652,11 @@ template <> inline void Structure :: Convert<float>  (float& dest,const FileData
 // ------------------------------------------------------------------------------------------------
 template <> inline void Structure :: Convert<double> (double& dest,const FileDatabase& db) const
 {
-	if (name == "char") {
+	if (primitive == PrimitiveType_Char) {
 		dest = db.reader->GetI1() / 255.;
 		return;
 	}
-	else if (name == "short") {
+	else if (primitive == PrimitiveType_Short) {
 		dest = db.reader->GetI2() / 32767.;
 		return;
 	}
@@ -54,7 +54,6 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "BlenderBMesh.h"
 
 #include "StreamReader.h"
-#include "MemoryIOWrapper.h"
 
 // zlib is needed for compressed blend files 
 #ifndef ASSIMP_BUILD_NO_COMPRESSED_BLEND
@@ -138,35 +137,145 @@ void BlenderImporter::SetupProperties(const Importer* /*pImp*/)
 	// nothing to be done for the moment
 }
 
-struct free_it
+#ifndef ASSIMP_BUILD_NO_COMPRESSED_BLEND
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Incrementally inflates a gzip-compressed IOStream. The compressed data is pulled from the 
+// stream in small chunks as needed, so it never needs to be held in memory as a whole.
+class GzipInflater
 {
-	free_it(void* free) : free(free) {}
-	~free_it() {
-		::free(this->free);
+public:
+
+	enum { CHUNK_SIZE = 64 * 1024 };
+
+	GzipInflater(IOStream& stream)
+		: stream(stream)
+		, in(CHUNK_SIZE)
+		, done()
+	{
+		zstream.opaque = Z_NULL;
+		zstream.zalloc = Z_NULL;
+		zstream.zfree  = Z_NULL;
+		zstream.data_type = Z_BINARY;
+		zstream.next_in = Z_NULL;
+		zstream.avail_in = 0;
+
+		// http://hewgill.com/journal/entries/349-how-to-decompress-gzip-stream-with-zlib
+		if (inflateInit2(&zstream, 16+MAX_WBITS) != Z_OK) {
+			throw DeadlyImportError("BLEND: Failed to initialize zlib");
+		}
 	}
 
-	void* free;
+	~GzipInflater() {
+		inflateEnd(&zstream);
+	}
+
+public:
+
+	// --------------------------------------------------------------------------------------------
+	// Uncompressed size as stored in the gzip trailer. This is only a hint: the field holds
+	// the size modulo 2^32 and may be garbage if the file is broken, so it is clamped to what
+	// deflate can produce from the file at most (about 1032:1). Restores the file pointer.
+	static size_t GetSizeHint(IOStream& stream) {
+		const size_t pos = stream.Tell(), size = stream.FileSize();
+		uint32_t isize = 0;
+		if (size >= 4 && stream.Seek(size-4,aiOrigin_SET) == aiReturn_SUCCESS) {
+			uint8_t trailer[4];
+			if (stream.Read(trailer,4,1) == 1) {
+				// http://www.gzip.org/zlib/rfc-gzip.html#header-trailer
+				isize = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | (trailer[3] << 24);
+			}
+		}
+		stream.Seek(pos,aiOrigin_SET);
+		return static_cast<size_t>(std::min(static_cast<uint64_t>(isize),static_cast<uint64_t>(size)*1032));
+	}
+
+	// --------------------------------------------------------------------------------------------
+	// Inflate up to `size` bytes into `out`. Returns the number of bytes written, which is
+	// less than `size` only once the end of the compressed data has been reached.
+	size_t Inflate(void* out, size_t size) {
+		zstream.next_out = reinterpret_cast<Bytef*>(out);
+		zstream.avail_out = static_cast<uInt>(size);
+
+		while (zstream.avail_out && !done) {
+			if (!zstream.avail_in) {
+				zstream.avail_in = static_cast<uInt>(stream.Read(&in[0],1,CHUNK_SIZE));
+				zstream.next_in = &in[0];
+			}
+
+			const int ret = inflate(&zstream, Z_NO_FLUSH);
+			if (ret == Z_STREAM_END) {
+				done = true;
+			}
+			else if (ret != Z_OK) {
+				throw DeadlyImportError("BLEND: Failure decompressing this file using gzip, seemingly it is NOT a compressed .BLEND file");
+			}
+		}
+		return size - zstream.avail_out;
+	}
+
+	// --------------------------------------------------------------------------------------------
+	bool IsDone() const {
+		return done;
+	}
+
+private:
+
+	IOStream& stream;
+	z_stream zstream;
+	std::vector<Bytef> in;
+	bool done;
 };
 
+// ------------------------------------------------------------------------------------------------
+// Inflate everything left in the stream into a buffer allocated with new[]. The buffer is sized
+// from the given capacity hint and only grown (geometrically) if the hint turns out to be wrong.
+int8_t* InflateAll(GzipInflater& inflater, size_t capacity, size_t& total)
+{
+	int8_t* dest = new int8_t[capacity];
+	total = 0;
+	try {
+		while (!inflater.IsDone()) {
+			if (total == capacity) {
+				int8_t* const grown = new int8_t[capacity * 2];
+				::memcpy(grown,dest,total);
+				delete[] dest;
+				dest = grown;
+				capacity *= 2;
+			}
+			total += inflater.Inflate(dest + total,capacity - total);
+		}
+	}
+	catch (...) {
+		delete[] dest;
+		throw;
+	}
+	return dest;
+}
+
+} // ! anon
+#endif
+
 // ------------------------------------------------------------------------------------------------
 // Imports the given file into the given scene structure. 
 void BlenderImporter::InternReadFile( const std::string& pFile, 
 	aiScene* pScene, IOSystem* pIOHandler)
 {
-#ifndef ASSIMP_BUILD_NO_COMPRESSED_BLEND
-	Bytef* dest = NULL;
-	free_it free_it_really(dest);
-#endif
-
 	FileDatabase file; 
 	boost::shared_ptr<IOStream> stream(pIOHandler->Open(pFile,"rb"));
 	if (!stream) {
 		ThrowException("Could not open file for reading");
 	}
 
+	// BLENDER magic, pointer size, endianess and version
+	char header[12] = {0};
 	char magic[8] = {0};
 	stream->Read(magic,7,1);
-	if (strcmp(magic,"BLENDER")) {
+	if (!strcmp(magic,"BLENDER")) {
+		stream->Read(header+7,5,1);
+	}
+	else {
 		// Check for presence of the gzip header. If yes, assume it is a
 		// compressed blend file and try uncompressing it, else fail. This is to
 		// avoid uncompressing random files which our loader might end up with.
@@ -183,70 +292,40 @@ void BlenderImporter::InternReadFile( const std::string& pFile,
 			ThrowException("Unsupported GZIP compression method");
 		}
 
-		// http://www.gzip.org/zlib/rfc-gzip.html#header-trailer
-		stream->Seek(0L,aiOrigin_SET);
-		boost::shared_ptr<StreamReaderLE> reader = boost::shared_ptr<StreamReaderLE>(new StreamReaderLE(stream));
-
-		// build a zlib stream
-		z_stream zstream;
-		zstream.opaque = Z_NULL;
-		zstream.zalloc = Z_NULL;
-		zstream.zfree  = Z_NULL;
-		zstream.data_type = Z_BINARY;
-
-		// http://hewgill.com/journal/entries/349-how-to-decompress-gzip-stream-with-zlib
-		inflateInit2(&zstream, 16+MAX_WBITS);
-
-		zstream.next_in   = reinterpret_cast<Bytef*>( reader->GetPtr() );
-		zstream.avail_in  = reader->GetRemainingSize();
-
-		size_t total = 0l;
-
-		// and decompress the data .... do 1k chunks in the hope that we won't kill the stack
-#define MYBLOCK 1024
-		Bytef block[MYBLOCK];
-		int ret;
-		do {
-			zstream.avail_out = MYBLOCK;
-			zstream.next_out = block;
-			ret = inflate(&zstream, Z_NO_FLUSH);
-
-			if (ret != Z_STREAM_END && ret != Z_OK) {
-				ThrowException("Failure decompressing this file using gzip, seemingly it is NOT a compressed .BLEND file");
-			}
-			const size_t have = MYBLOCK - zstream.avail_out;
-			total += have;
-			dest = reinterpret_cast<Bytef*>( realloc(dest,total) );
-			memcpy(dest + total - have,block,have);
-		} 
-		while (ret != Z_STREAM_END);
-
-		// terminate zlib
-		inflateEnd(&zstream);
+		// The uncompressed size from the gzip trailer is used to allocate the output buffer
+		// up front, so large files neither need to be read into memory in compressed form
+		// nor repeatedly reallocated while inflating. The buffer is then handed over to
+		// the StreamReader without making another copy.
+		const size_t size_hint = GzipInflater::GetSizeHint(*stream);
 
-		// replace the input stream with a memory stream
-		stream.reset(new MemoryIOStream(reinterpret_cast<uint8_t*>(dest),total)); 
+		stream->Seek(0L,aiOrigin_SET);
+		GzipInflater inflater(*stream);
 
-		// .. and retry
-		stream->Read(magic,7,1);
-		if (strcmp(magic,"BLENDER")) {
+		if (inflater.Inflate(header,12) != 12 || strncmp(header,"BLENDER",7)) {
 			ThrowException("Found no BLENDER magic word in decompressed GZIP file");
 		}
+
+		size_t total = 0;
+		int8_t* const dest = InflateAll(inflater,std::max(size_hint,static_cast<size_t>(12 + 1)) - 12,total);
+
+		// release the input file as early as possible
+		stream.reset();
+		file.reader = boost::shared_ptr<StreamReaderAny>(new StreamReaderAny(dest,total,header[8]=='v'));
 #endif
 	}
 
-	file.i64bit = (stream->Read(magic,1,1),magic[0]=='-');
-	file.little = (stream->Read(magic,1,1),magic[0]=='v');
-
-	stream->Read(magic,3,1);
-	magic[3] = '\0';
+	file.i64bit = header[7]=='-';
+	file.little = header[8]=='v';
 
-	LogInfo((format(),"Blender version is ",magic[0],".",magic+1,
+	LogInfo((format(),"Blender version is ",header[9],".",std::string(header+10,2),
 		" (64bit: ",file.i64bit?"true":"false",
 		", little endian: ",file.little?"true":"false",")"
 	));
 
-	ParseBlendFile(file,stream);
+	if (!file.reader) {
+		file.reader = boost::shared_ptr<StreamReaderAny>(new StreamReaderAny(stream,file.little));
+	}
+	ParseBlendFile(file);
 
 	Scene scene;
 	ExtractScene(scene,file);
@@ -255,10 +334,8 @@ void BlenderImporter::InternReadFile( const std::string& pFile,
 }
 
 // ------------------------------------------------------------------------------------------------
-void BlenderImporter::ParseBlendFile(FileDatabase& out, boost::shared_ptr<IOStream> stream) 
+void BlenderImporter::ParseBlendFile(FileDatabase& out) 
 {
-	out.reader = boost::shared_ptr<StreamReaderAny>(new StreamReaderAny(stream,out.little));
-
 	DNAParser dna_reader(out);
 	const DNA* dna = NULL;
 
@@ -125,9 +125,7 @@ protected:
 	);
 
 	// --------------------
-	void ParseBlendFile(Blender::FileDatabase& out, 
-		boost::shared_ptr<IOStream> stream
-	);
+	void ParseBlendFile(Blender::FileDatabase& out);
 
 	// --------------------
 	void ExtractScene(Blender::Scene& out, 
@@ -1033,16 +1033,13 @@ void COBImporter::ReadPolH_Binary(COB::Scene& out, StreamReaderLE& reader, const
 	ReadBasicNodeInfo_Binary(msh,reader,nfo);
 
 	msh.vertex_positions.resize(reader.GetI4());
-	for_each(aiVector3D& v,msh.vertex_positions) {
-		v.x = reader.GetF4();
-		v.y = reader.GetF4();
-		v.z = reader.GetF4();
+	if (!msh.vertex_positions.empty()) {
+		reader.GetArray((float*)&msh.vertex_positions[0],msh.vertex_positions.size()*3);
 	}
 
 	msh.texture_coords.resize(reader.GetI4());
-	for_each(aiVector2D& v,msh.texture_coords) {
-		v.x = reader.GetF4();
-		v.y = reader.GetF4();
+	if (!msh.texture_coords.empty()) {
+		reader.GetArray((float*)&msh.texture_coords[0],msh.texture_coords.size()*2);
 	}
 
 	const size_t numf = reader.GetI4();
@@ -311,6 +311,10 @@ struct SubMesh
 {
 	std::string mMaterial; ///< subgroup identifier
 	size_t mNumFaces; ///< number of faces in this submesh
+	size_t mFaceStart; ///< index of the first face in Mesh::mFaceSize
+	size_t mIndexStart; ///< index of the first face corner in Mesh::mFaceIndices
+	size_t mVertexStart; ///< index of the first vertex of this submesh
+	size_t mNumVertices; ///< number of unique vertices in this submesh
 };
 
 /** Contains data for a single mesh */
@@ -331,7 +335,8 @@ struct Mesh
 	// Vertex data addressed by vertex indices
 	std::vector<InputChannel> mPerVertexData; 
 
-	// actual mesh data, assembled on encounter of a <p> element. Verbose format, not indexed
+	// actual mesh data, assembled on encounter of a <p> element. Each vertex is unique
+	// within its submesh: corners sharing all of their <p> indices share the vertex
 	std::vector<aiVector3D> mPositions;
 	std::vector<aiVector3D> mNormals;
 	std::vector<aiVector3D> mTangents;
@@ -345,9 +350,11 @@ struct Mesh
 	// 1 == point, 2 == line, 3 == triangle, 4+ == poly
 	std::vector<size_t> mFaceSize;
 	
-	// Position indices for all faces in the sequence given in mFaceSize - 
-	// necessary for bone weight assignment
-	std::vector<size_t> mFacePosIndices;
+	// Vertex indices for all face corners in the sequence given in mFaceSize
+	std::vector<size_t> mFaceIndices;
+
+	// Position indices for all vertices - necessary for bone weight assignment
+	std::vector<size_t> mVertexPosIndices;
 
 	// Submeshes in this mesh, each with a given material
 	std::vector<SubMesh> mSubMeshes;
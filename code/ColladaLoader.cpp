@@ -69,11 +69,21 @@ static const aiImporterDesc desc = {
 	"dae" 
 };
 
+// ------------------------------------------------------------------------------------------------
+// Copies the vertex attributes selected by the given index list into a new array
+template <typename Type>
+static Type* GatherVertexData( const std::vector<Type>& pSource, const std::vector<size_t>& pIndices)
+{
+	Type* out = new Type[pIndices.size()];
+	for( size_t a = 0; a < pIndices.size(); ++a)
+		out[a] = pSource[pIndices[a]];
+	return out;
+}
 
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 ColladaLoader::ColladaLoader()
-: noSkeletonMesh(), ignoreUpDirection(false)
+: noSkeletonMesh(), ignoreUpDirection(false), onDemandLibraries(true), sharedVertices(false)
 {}
 
 // ------------------------------------------------------------------------------------------------
@@ -109,6 +119,8 @@ void ColladaLoader::SetupProperties(const Importer* pImp)
 {
 	noSkeletonMesh = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_NO_SKELETON_MESHES,0) != 0;
 	ignoreUpDirection = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_COLLADA_IGNORE_UP_DIRECTION,0) != 0;
+	onDemandLibraries = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_COLLADA_ON_DEMAND_LIBRARIES,1) != 0;
+	sharedVertices = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_COLLADA_SHARED_VERTICES,0) != 0;
 }
 
 
@@ -135,7 +147,7 @@ void ColladaLoader::InternReadFile( const std::string& pFile, aiScene* pScene, I
 	mTextures.clear();
 
 	// parse the input file
-	ColladaParser parser( pIOHandler, pFile);
+	ColladaParser parser( pIOHandler, pFile, onDemandLibraries);
 
 	if( !parser.mRootNode)
 		throw DeadlyImportError( "Collada: File came out empty. Something is wrong here.");
@@ -191,6 +203,9 @@ void ColladaLoader::InternReadFile( const std::string& pFile, aiScene* pScene, I
 	// store all animations
 	StoreAnimations( pScene, parser);
 
+	// meshes are indexed already, vertices are shared between faces
+	if( sharedVertices)
+		pScene->mFlags |= AI_SCENE_FLAGS_NON_VERBOSE_FORMAT;
 
 	// If no meshes have been loaded, it's probably just an animated skeleton.
 	if (!pScene->mNumMeshes) {
@@ -454,7 +469,6 @@ void ColladaLoader::BuildMeshesForNode( const ColladaParser& pParser, const Coll
 		}
 
 		// build a mesh for each of its subgroups
-		size_t vertexStart = 0, faceStart = 0;
 		for( size_t sm = 0; sm < srcMesh->mSubMeshes.size(); ++sm)
 		{
 			const Collada::SubMesh& submesh = srcMesh->mSubMeshes[sm];
@@ -511,13 +525,12 @@ void ColladaLoader::BuildMeshesForNode( const ColladaParser& pParser, const Coll
 			else
 			{
 				// else we have to add the mesh to the collection and store its newly assigned index at the node
-				aiMesh* dstMesh = CreateMesh( pParser, srcMesh, submesh, srcController, vertexStart, faceStart);
+				aiMesh* dstMesh = CreateMesh( pParser, srcMesh, submesh, srcController);
 
 				// store the mesh, and store its new index in the node
 				newMeshRefs.push_back( mMeshes.size());
 				mMeshIndexByID[index] = mMeshes.size();
 				mMeshes.push_back( dstMesh);
-				vertexStart += dstMesh->mNumVertices; faceStart += submesh.mNumFaces;
 
 				// assign the material index
 				dstMesh->mMaterialIndex = matIdx;
@@ -541,58 +554,49 @@ void ColladaLoader::BuildMeshesForNode( const ColladaParser& pParser, const Coll
 // ------------------------------------------------------------------------------------------------
 // Creates a mesh for the given ColladaMesh face subset and returns the newly created mesh
 aiMesh* ColladaLoader::CreateMesh( const ColladaParser& pParser, const Collada::Mesh* pSrcMesh, const Collada::SubMesh& pSubMesh, 
-	const Collada::Controller* pSrcController, size_t pStartVertex, size_t pStartFace)
+	const Collada::Controller* pSrcController)
 {
 	aiMesh* dstMesh = new aiMesh;
     
     dstMesh->mName = pSrcMesh->mName;
 
-	// count the vertices addressed by its faces
-	const size_t numVertices = std::accumulate( pSrcMesh->mFaceSize.begin() + pStartFace,
-		pSrcMesh->mFaceSize.begin() + pStartFace + pSubMesh.mNumFaces, 0);
+	// count the corners of its faces
+	const std::vector<size_t>::const_iterator faceSizes = pSrcMesh->mFaceSize.begin() + pSubMesh.mFaceStart;
+	const size_t numCorners = std::accumulate( faceSizes, faceSizes + pSubMesh.mNumFaces, (size_t)0);
+
+	// the source vertex for each output vertex. Either the submesh's vertices as they are, or, 
+	// if the output is going to be verbose, one vertex per face corner
+	const size_t numVertices = sharedVertices ? pSubMesh.mNumVertices : numCorners;
+	std::vector<size_t> vertexMap( numVertices);
+	for( size_t a = 0; a < numVertices; ++a)
+		vertexMap[a] = sharedVertices ? pSubMesh.mVertexStart + a : pSrcMesh->mFaceIndices[pSubMesh.mIndexStart + a];
 
 	// copy positions
 	dstMesh->mNumVertices = numVertices;
-	dstMesh->mVertices = new aiVector3D[numVertices];
-	std::copy( pSrcMesh->mPositions.begin() + pStartVertex, pSrcMesh->mPositions.begin() + 
-		pStartVertex + numVertices, dstMesh->mVertices);
+	dstMesh->mVertices = GatherVertexData( pSrcMesh->mPositions, vertexMap);
 
 	// normals, if given. HACK: (thom) Due to the glorious Collada spec we never 
 	// know if we have the same number of normals as there are positions. So we 
 	// also ignore any vertex attribute if it has a different count
-	if( pSrcMesh->mNormals.size() >= pStartVertex + numVertices)
-	{
-		dstMesh->mNormals = new aiVector3D[numVertices];
-		std::copy( pSrcMesh->mNormals.begin() + pStartVertex, pSrcMesh->mNormals.begin() +
-			pStartVertex + numVertices, dstMesh->mNormals);
-	}
+	const size_t vertexEnd = pSubMesh.mVertexStart + pSubMesh.mNumVertices;
+	if( pSrcMesh->mNormals.size() >= vertexEnd)
+		dstMesh->mNormals = GatherVertexData( pSrcMesh->mNormals, vertexMap);
 
 	// tangents, if given. 
-	if( pSrcMesh->mTangents.size() >= pStartVertex + numVertices)
-	{
-		dstMesh->mTangents = new aiVector3D[numVertices];
-		std::copy( pSrcMesh->mTangents.begin() + pStartVertex, pSrcMesh->mTangents.begin() + 
-			pStartVertex + numVertices, dstMesh->mTangents);
-	}
+	if( pSrcMesh->mTangents.size() >= vertexEnd)
+		dstMesh->mTangents = GatherVertexData( pSrcMesh->mTangents, vertexMap);
 
 	// bitangents, if given. 
-	if( pSrcMesh->mBitangents.size() >= pStartVertex + numVertices)
-	{
-		dstMesh->mBitangents = new aiVector3D[numVertices];
-		std::copy( pSrcMesh->mBitangents.begin() + pStartVertex, pSrcMesh->mBitangents.begin() + 
-			pStartVertex + numVertices, dstMesh->mBitangents);
-	}
+	if( pSrcMesh->mBitangents.size() >= vertexEnd)
+		dstMesh->mBitangents = GatherVertexData( pSrcMesh->mBitangents, vertexMap);
 
 	// same for texturecoords, as many as we have
 	// empty slots are not allowed, need to pack and adjust UV indexes accordingly
 	for( size_t a = 0, real = 0; a < AI_MAX_NUMBER_OF_TEXTURECOORDS; a++)
 	{
-		if( pSrcMesh->mTexCoords[a].size() >= pStartVertex + numVertices)
+		if( pSrcMesh->mTexCoords[a].size() >= vertexEnd)
 		{
-			dstMesh->mTextureCoords[real] = new aiVector3D[numVertices];
-			for( size_t b = 0; b < numVertices; ++b)
-				dstMesh->mTextureCoords[real][b] = pSrcMesh->mTexCoords[a][pStartVertex+b];
-			
+			dstMesh->mTextureCoords[real] = GatherVertexData( pSrcMesh->mTexCoords[a], vertexMap);
 			dstMesh->mNumUVComponents[real] = pSrcMesh->mNumUVComponents[a];
 			++real;
 		}
@@ -601,26 +605,25 @@ aiMesh* ColladaLoader::CreateMesh( const ColladaParser& pParser, const Collada::
 	// same for vertex colors, as many as we have. again the same packing to avoid empty slots
 	for( size_t a = 0, real = 0; a < AI_MAX_NUMBER_OF_COLOR_SETS; a++)
 	{
-		if( pSrcMesh->mColors[a].size() >= pStartVertex + numVertices)
+		if( pSrcMesh->mColors[a].size() >= vertexEnd)
 		{
-			dstMesh->mColors[real] = new aiColor4D[numVertices];
-			std::copy( pSrcMesh->mColors[a].begin() + pStartVertex, pSrcMesh->mColors[a].begin() + pStartVertex + numVertices,dstMesh->mColors[real]);
+			dstMesh->mColors[real] = GatherVertexData( pSrcMesh->mColors[a], vertexMap);
 			++real;
 		}
 	}
 
-	// create faces. Due to the fact that each face uses unique vertices, we can simply count up on each vertex
-	size_t vertex = 0;
+	// create faces. In verbose format each face uses unique vertices, we can simply count up on each vertex
+	size_t corner = pSubMesh.mIndexStart;
 	dstMesh->mNumFaces = pSubMesh.mNumFaces;
 	dstMesh->mFaces = new aiFace[dstMesh->mNumFaces];
 	for( size_t a = 0; a < dstMesh->mNumFaces; ++a)
 	{
-		size_t s = pSrcMesh->mFaceSize[ pStartFace + a];
+		size_t s = faceSizes[a];
 		aiFace& face = dstMesh->mFaces[a];
 		face.mNumIndices = s;
 		face.mIndices = new unsigned int[s];
-		for( size_t b = 0; b < s; ++b)
-			face.mIndices[b] = vertex++;
+		for( size_t b = 0; b < s; ++b, ++corner)
+			face.mIndices[b] = sharedVertices ? pSrcMesh->mFaceIndices[corner] - pSubMesh.mVertexStart : corner - pSubMesh.mIndexStart;
 	}
 
 	// create bones if given
@@ -667,11 +670,11 @@ aiMesh* ColladaLoader::CreateMesh( const ColladaParser& pParser, const Collada::
 		}
 
 		// now for each vertex put the corresponding vertex weights into each bone's weight collection
-		for( size_t a = pStartVertex; a < pStartVertex + numVertices; ++a)
+		for( size_t a = 0; a < numVertices; ++a)
 		{
 			// which position index was responsible for this vertex? that's also the index by which
 			// the controller assigns the vertex weights
-			size_t orgIndex = pSrcMesh->mFacePosIndices[a];
+			size_t orgIndex = pSrcMesh->mVertexPosIndices[vertexMap[a]];
 			// find the vertex weights for this vertex
 			IndexPairVector::const_iterator iit = weightStartPerVertex[orgIndex];
 			size_t pairCount = pSrcController->mWeightCounts[orgIndex];
@@ -687,7 +690,7 @@ aiMesh* ColladaLoader::CreateMesh( const ColladaParser& pParser, const Collada::
 				if( weight > 0.0f)
 				{
 					aiVertexWeight w;
-					w.mVertexId = a - pStartVertex;
+					w.mVertexId = a;
 					w.mWeight = weight;
 					dstBones[jointIndex].push_back( w);
 				}
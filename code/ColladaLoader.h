@@ -114,7 +114,7 @@ protected:
 
 	/** Creates a mesh for the given ColladaMesh face subset and returns the newly created mesh */
 	aiMesh* CreateMesh( const ColladaParser& pParser, const Collada::Mesh* pSrcMesh, const Collada::SubMesh& pSubMesh, 
-		const Collada::Controller* pSrcController, size_t pStartVertex, size_t pStartFace);
+		const Collada::Controller* pSrcController);
 
 	/** Builds cameras for the given node and references them */
 	void BuildCamerasForNode( const ColladaParser& pParser, const Collada::Node* pNode, 
@@ -235,6 +235,8 @@ protected:
 
 	bool noSkeletonMesh;
 	bool ignoreUpDirection;
+	bool onDemandLibraries;
+	bool sharedVertices;
 };
 
 } // end of namespace Assimp
@@ -53,10 +53,67 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 using namespace Assimp;
 using namespace Assimp::Collada;
 
+namespace {
+
+	// names of the elements in ColladaParser::ElementId, in the same order
+	const char* const ElementNames[] = {
+		"mesh",
+		"source",
+		"float_array",
+		"IDREF_array",
+		"Name_array",
+		"technique_common",
+		"accessor",
+		"vertices",
+		"input",
+		"vcount",
+		"p",
+		"lines",
+		"linestrips",
+		"polygons",
+		"polylist",
+		"triangles",
+		"trifans",
+		"tristrips"
+	};
+
+	// ------------------------------------------------------------------------------------------------
+	// hash of the <p> indices which make up a vertex
+	inline size_t HashIndexTuple( const size_t* pTuple, size_t pNumOffsets)
+	{
+		size_t hash = 2166136261u;
+		for( size_t a = 0; a < pNumOffsets; ++a)
+			hash = (hash ^ pTuple[a]) * 16777619u;
+		return hash ^ (hash >> 15);
+	}
+
+	// ------------------------------------------------------------------------------------------------
+	// Grows the vertex hash table to at least the given size and re-inserts all known index tuples
+	void GrowIndexTupleHash( std::vector<size_t>& pHash, const std::vector<size_t>& pTuples, size_t pNumOffsets, size_t pMinSize)
+	{
+		size_t size = std::max( pHash.size(), (size_t)64);
+		while( size < pMinSize)
+			size *= 2;
+		if( size == pHash.size())
+			return;
+
+		pHash.assign( size, 0);
+		const size_t numTuples = pTuples.size() / pNumOffsets;
+		for( size_t a = 0; a < numTuples; ++a)
+		{
+			size_t slot = HashIndexTuple( &pTuples[a * pNumOffsets], pNumOffsets) & (size - 1);
+			while( pHash[slot])
+				slot = (slot + 1) & (size - 1);
+			pHash[slot] = a + 1;
+		}
+	}
+}
+
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
-ColladaParser::ColladaParser( IOSystem* pIOHandler, const std::string& pFile)
+ColladaParser::ColladaParser( IOSystem* pIOHandler, const std::string& pFile, bool pOnDemand)
 	: mFileName( pFile)
+	, mReadOnDemand( pOnDemand)
 {
 	mRootNode = NULL;
 	mUnitSize = 1.0f;
@@ -71,13 +128,15 @@ ColladaParser::ColladaParser( IOSystem* pIOHandler, const std::string& pFile)
     throw DeadlyImportError( "Failed to open file " + pFile + ".");
 
 	// generate a XML reader for it
-  boost::scoped_ptr<CIrrXML_IOStreamReader> mIOWrapper( new CIrrXML_IOStreamReader( file.get()));
-	mReader = irr::io::createIrrXMLReader( mIOWrapper.get());
-	if( !mReader)
-		ThrowException( "Collada: Unable to open file.");
+	BOOST_STATIC_ASSERT( sizeof(ElementNames)/sizeof(ElementNames[0]) == Elem_Count);
+	mReader = new FastXMLReader( file.get(), ElementNames, Elem_Count);
 
 	// start reading
 	ReadContents();
+
+	// and pick up everything the scene needs which has been skipped in the first pass
+	if( mReadOnDemand)
+		ReadDeferredElements();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -193,6 +252,139 @@ void ColladaParser::ReadStructure()
 	}
 }
 
+// ------------------------------------------------------------------------------------------------
+// Parses the deferred library entries reachable from the root node
+void ColladaParser::ReadDeferredElements()
+{
+	// no scene to instance, nothing is referenced. The loader complains about this anyways.
+	if( !mRootNode)
+		return;
+
+	std::set<const Node*> visited;
+	std::set<std::string> nodeNames, meshRefs;
+	CollectReferences( mRootNode, visited, nodeNames, meshRefs);
+
+	const size_t numDeferred = mDeferredGeometries.size() + mDeferredControllers.size() + mDeferredAnimations.size();
+	size_t numRead = 0;
+
+	// <instance_geometry> and <instance_controller> both end up in the node's mesh list
+	for( std::set<std::string>::const_iterator it = meshRefs.begin(); it != meshRefs.end(); ++it)
+	{
+		std::string meshID = *it;
+
+		DeferredLibrary::iterator cit = mDeferredControllers.find( *it);
+		if( cit != mDeferredControllers.end())
+		{
+			mReader->restoreElement( cit->second);
+			mDeferredControllers.erase( cit);
+			ReadControllerElement();
+			++numRead;
+
+			// a skin pulls in the mesh it refers to
+			meshID = mControllerLibrary[*it].mMeshId;
+		}
+
+		DeferredLibrary::iterator git = mDeferredGeometries.find( meshID);
+		if( git != mDeferredGeometries.end())
+		{
+			mReader->restoreElement( git->second);
+			mDeferredGeometries.erase( git);
+			ReadGeometryElement();
+			++numRead;
+		}
+	}
+
+	// animations are only of interest if they affect one of the nodes in the scene. Keep the file order.
+	for( std::vector<FastXMLReader::ElementMark>::const_iterator it = mDeferredAnimations.begin(); it != mDeferredAnimations.end(); ++it)
+	{
+		if( IsAnimationTargeting( *it, nodeNames))
+		{
+			mReader->restoreElement( *it);
+			ReadAnimation( &mAnims);
+			++numRead;
+		}
+	}
+
+	mDeferredGeometries.clear();
+	mDeferredControllers.clear();
+	mDeferredAnimations.clear();
+
+	DefaultLogger::get()->debug( boost::str( boost::format( "Collada: %d of %d library entries are referenced by the scene") 
+		% numRead % numDeferred));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Collects the IDs, names and SIDs of all nodes and the mesh/controller references reachable 
+// from the given node
+void ColladaParser::CollectReferences( const Node* pNode, std::set<const Node*>& pVisited,
+	std::set<std::string>& pNodeNames, std::set<std::string>& pMeshRefs) const
+{
+	// node instances might form cycles in broken files
+	if( !pVisited.insert( pNode).second)
+		return;
+
+	// the loader resolves animation targets by ID or name, SIDs are added to stay on the safe side
+	if( !pNode->mID.empty())
+		pNodeNames.insert( pNode->mID);
+	if( !pNode->mName.empty())
+		pNodeNames.insert( pNode->mName);
+	if( !pNode->mSID.empty())
+		pNodeNames.insert( pNode->mSID);
+
+	for( std::vector<MeshInstance>::const_iterator it = pNode->mMeshes.begin(); it != pNode->mMeshes.end(); ++it)
+		pMeshRefs.insert( it->mMeshOrController);
+
+	for( std::vector<Node*>::const_iterator it = pNode->mChildren.begin(); it != pNode->mChildren.end(); ++it)
+		CollectReferences( *it, pVisited, pNodeNames, pMeshRefs);
+
+	// instances which can't be found in the node library are resolved by name by the loader, 
+	// which only searches the hierarchy we are walking anyways
+	for( std::vector<NodeInstance>::const_iterator it = pNode->mNodeInstances.begin(); it != pNode->mNodeInstances.end(); ++it)
+	{
+		NodeLibrary::const_iterator nit = mNodeLibrary.find( it->mNode);
+		if( nit != mNodeLibrary.end())
+			CollectReferences( nit->second, pVisited, pNodeNames, pMeshRefs);
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+// Checks whether the deferred animation targets one of the given node IDs, names or SIDs
+bool ColladaParser::IsAnimationTargeting( const FastXMLReader::ElementMark& pMark, const std::set<std::string>& pNodeNames) const
+{
+	// The contents haven't been tokenized yet, so look for the raw target="nodeID/transformSID" 
+	// attributes of the animation's channels. 
+	const char* cur = pMark.contentsBegin, *end = pMark.contentsEnd;
+	for( ; cur + 8 < end; ++cur)
+	{
+		if( ::strncmp( cur, "target", 6) != 0 || !IsSpaceOrNewLine( cur[-1]))
+			continue;
+
+		cur += 6;
+		while( cur < end && IsSpaceOrNewLine( *cur))
+			++cur;
+		if( cur == end || *cur != '=')
+			continue;
+		++cur;
+		while( cur < end && IsSpaceOrNewLine( *cur))
+			++cur;
+		if( cur == end || (*cur != '\"' && *cur != '\''))
+			continue;
+
+		const char quote = *cur++;
+		const char* const begin = cur;
+		while( cur < end && *cur != quote && *cur != '/' && *cur != '&')
+			++cur;
+
+		// be conservative with entity references, we'd need to decode them first
+		if( cur < end && *cur == '&')
+			return true;
+
+		if( pNodeNames.find( std::string( begin, cur)) != pNodeNames.end())
+			return true;
+	}
+	return false;
+}
+
 // ------------------------------------------------------------------------------------------------
 // Reads asset informations such as coordinate system informations and legal blah
 void ColladaParser::ReadAssetInfo()
@@ -260,8 +452,16 @@ void ColladaParser::ReadAnimationLibrary()
 		{
 			if( IsElement( "animation"))
 			{
-				// delegate the reading. Depending on the inner elements it will be a container or a anim channel
-				ReadAnimation( &mAnims);
+				if( mReadOnDemand)
+				{
+					// just remember where it is, ReadDeferredElements() decides whether it's needed
+					mDeferredAnimations.push_back( FastXMLReader::ElementMark());
+					mReader->deferElement( mDeferredAnimations.back());
+				} else
+				{
+					// delegate the reading. Depending on the inner elements it will be a container or a anim channel
+					ReadAnimation( &mAnims);
+				}
 			} else
 			{
 				// ignore the rest
@@ -445,15 +645,12 @@ void ColladaParser::ReadControllerLibrary()
 		{
 			if( IsElement( "controller"))
 			{
-				// read ID. Ask the spec if it's neccessary or optional... you might be surprised.
-				int attrID = GetAttribute( "id");
-				std::string id = mReader->getAttributeValue( attrID);
-
-				// create an entry and store it in the library under its ID
-				mControllerLibrary[id] = Controller();
-
-				// read on from there
-				ReadController( mControllerLibrary[id]);
+				if( mReadOnDemand)
+				{
+					int attrID = GetAttribute( "id");
+					mReader->deferElement( mDeferredControllers[mReader->getAttributeValue( attrID)]);
+				} else
+					ReadControllerElement();
 			} else
 			{
 				// ignore the rest
@@ -470,6 +667,21 @@ void ColladaParser::ReadControllerLibrary()
 	}
 }
 
+// ------------------------------------------------------------------------------------------------
+// Reads a <controller> element and stores it in the library
+void ColladaParser::ReadControllerElement()
+{
+	// read ID. Ask the spec if it's neccessary or optional... you might be surprised.
+	int attrID = GetAttribute( "id");
+	std::string id = mReader->getAttributeValue( attrID);
+
+	// create an entry and store it in the library under its ID
+	mControllerLibrary[id] = Controller();
+
+	// read on from there
+	ReadController( mControllerLibrary[id]);
+}
+
 // ------------------------------------------------------------------------------------------------
 // Reads a controller into the given mesh structure
 void ColladaParser::ReadController( Collada::Controller& pController)
@@ -1482,26 +1694,12 @@ void ColladaParser::ReadGeometryLibrary()
 		{
 			if( IsElement( "geometry"))
 			{
-				// read ID. Another entry which is "optional" by design but obligatory in reality
-				int indexID = GetAttribute( "id");
-				std::string id = mReader->getAttributeValue( indexID);
-
-				// TODO: (thom) support SIDs
-				// ai_assert( TestAttribute( "sid") == -1);
-
-				// create a mesh and store it in the library under its ID
-				Mesh* mesh = new Mesh;
-				mMeshLibrary[id] = mesh;
-                
-                // read the mesh name if it exists
-                const int nameIndex = TestAttribute("name");
-                if(nameIndex != -1)
-                {
-                    mesh->mName = mReader->getAttributeValue(nameIndex);
-                }
-
-				// read on from there
-				ReadGeometry( mesh);
+				if( mReadOnDemand)
+				{
+					int indexID = GetAttribute( "id");
+					mReader->deferElement( mDeferredGeometries[mReader->getAttributeValue( indexID)]);
+				} else
+					ReadGeometryElement();
 			} else
 			{
 				// ignore the rest
@@ -1518,6 +1716,32 @@ void ColladaParser::ReadGeometryLibrary()
 	}
 }
 
+// ------------------------------------------------------------------------------------------------
+// Reads a <geometry> element and stores the mesh in the library
+void ColladaParser::ReadGeometryElement()
+{
+	// read ID. Another entry which is "optional" by design but obligatory in reality
+	int indexID = GetAttribute( "id");
+	std::string id = mReader->getAttributeValue( indexID);
+
+	// TODO: (thom) support SIDs
+	// ai_assert( TestAttribute( "sid") == -1);
+
+	// create a mesh and store it in the library under its ID
+	Mesh* mesh = new Mesh;
+	mMeshLibrary[id] = mesh;
+    
+    // read the mesh name if it exists
+    const int nameIndex = TestAttribute("name");
+    if(nameIndex != -1)
+    {
+        mesh->mName = mReader->getAttributeValue(nameIndex);
+    }
+
+	// read on from there
+	ReadGeometry( mesh);
+}
+
 // ------------------------------------------------------------------------------------------------
 // Reads a geometry from the geometry library.
 void ColladaParser::ReadGeometry( Collada::Mesh* pMesh)
@@ -1560,34 +1784,33 @@ void ColladaParser::ReadMesh( Mesh* pMesh)
 	{
 		if( mReader->getNodeType() == irr::io::EXN_ELEMENT)
 		{
-			if( IsElement( "source"))
+			switch( mReader->getNodeId())
 			{
+			case Elem_Source:
 				// we have professionals dealing with this
 				ReadSource();
-			}
-			else if( IsElement( "vertices"))
-			{
+				break;
+			case Elem_Vertices:
 				// read per-vertex mesh data
 				ReadVertexData( pMesh);
-			}
-			else if( IsElement( "triangles") || IsElement( "lines") || IsElement( "linestrips")
-				|| IsElement( "polygons") || IsElement( "polylist") || IsElement( "trifans") || IsElement( "tristrips")) 
-			{
+				break;
+			case Elem_Triangles: case Elem_Lines: case Elem_LineStrips: case Elem_Polygons:
+			case Elem_Polylist: case Elem_TriFans: case Elem_TriStrips:
 				// read per-index mesh data and faces setup
 				ReadIndexData( pMesh);
-			} else
-			{
+				break;
+			default:
 				// ignore the rest
 				SkipElement();
 			}
 		}
 		else if( mReader->getNodeType() == irr::io::EXN_ELEMENT_END)
 		{
-			if( strcmp( mReader->getNodeName(), "technique_common") == 0)
+			if( mReader->getNodeId() == Elem_TechniqueCommon)
 			{
 				// end of another meaningless element - read over it
 			} 
-			else if( strcmp( mReader->getNodeName(), "mesh") == 0)
+			else if( mReader->getNodeId() == Elem_Mesh)
 			{
 				// end of <mesh> element - we're done here
 				break;
@@ -1611,31 +1834,30 @@ void ColladaParser::ReadSource()
 	{
 		if( mReader->getNodeType() == irr::io::EXN_ELEMENT)
 		{
-			if( IsElement( "float_array") || IsElement( "IDREF_array") || IsElement( "Name_array"))
+			switch( mReader->getNodeId())
 			{
+			case Elem_FloatArray: case Elem_IDREFArray: case Elem_NameArray:
 				ReadDataArray();
-			}
-			else if( IsElement( "technique_common"))
-			{
+				break;
+			case Elem_TechniqueCommon:
 				// I don't care for your profiles 
-			}
-			else if( IsElement( "accessor"))
-			{
+				break;
+			case Elem_Accessor:
 				ReadAccessor( sourceID);
-			} else
-			{
+				break;
+			default:
 				// ignore the rest
 				SkipElement();
 			}
 		}
 		else if( mReader->getNodeType() == irr::io::EXN_ELEMENT_END)
 		{
-			if( strcmp( mReader->getNodeName(), "source") == 0)
+			if( mReader->getNodeId() == Elem_Source)
 			{
 				// end of <source> - we're done
 				break;
 			}
-			else if( strcmp( mReader->getNodeName(), "technique_common") == 0)
+			else if( mReader->getNodeId() == Elem_TechniqueCommon)
 			{
 				// end of another meaningless element - read over it
 			} else
@@ -1652,7 +1874,7 @@ void ColladaParser::ReadSource()
 void ColladaParser::ReadDataArray()
 {
 	std::string elmName = mReader->getNodeName();
-	bool isStringArray = (elmName == "IDREF_array" || elmName == "Name_array");
+	bool isStringArray = (mReader->getNodeId() == Elem_IDREFArray || mReader->getNodeId() == Elem_NameArray);
   bool isEmptyElement = mReader->isEmptyElement();
 
 	// read attributes
@@ -1673,36 +1895,25 @@ void ColladaParser::ReadDataArray()
 		if( isStringArray)
 		{
 			data.mStrings.reserve( count);
-			std::string s;
 
 			for( unsigned int a = 0; a < count; a++)
 			{
 				if( *content == 0)
 					ThrowException( "Expected more values while reading IDREF_array contents.");
 
-				s.clear();
+				const char* const begin = content;
 				while( !IsSpaceOrNewLine( *content))
-					s += *content++;
-				data.mStrings.push_back( s);
+					++content;
+				data.mStrings.push_back( std::string( begin, content));
 
 				SkipSpacesAndLineEnd( &content);
 			}
 		} else
 		{
-			data.mValues.reserve( count);
-
-			for( unsigned int a = 0; a < count; a++)
-			{
-				if( *content == 0)
-					ThrowException( "Expected more values while reading float_array contents.");
-
-				float value;
-				// read a number
-				content = fast_atoreal_move<float>( content, value);
-				data.mValues.push_back( value);
-				// skip whitespace after it
-				SkipSpacesAndLineEnd( &content);
-			}
+			// the text content is zero-terminated in the reader's buffer, parse it in one go
+			data.mValues.resize( count);
+			if( count && fast_atoreal_array( content, &data.mValues[0], count) != count)
+				ThrowException( "Expected more values while reading float_array contents.");
 		}
 	}
 
@@ -1861,25 +2072,30 @@ void ColladaParser::ReadIndexData( Mesh* pMesh)
 	if( attrMaterial > -1)
 		subgroup.mMaterial = mReader->getAttributeValue( attrMaterial);
 	subgroup.mNumFaces = numPrimitives;
+	subgroup.mFaceStart = pMesh->mFaceSize.size();
+	subgroup.mIndexStart = pMesh->mFaceIndices.size();
+	subgroup.mVertexStart = pMesh->mVertexPosIndices.size();
+	subgroup.mNumVertices = 0;
 	pMesh->mSubMeshes.push_back( subgroup);
 
+	// vertices are shared within the submesh only
+	mVertexTuples.clear();
+	mVertexTupleHash.clear();
+
 	// distinguish between polys and triangles
 	std::string elementName = mReader->getNodeName();
+	const unsigned int elementId = mReader->getNodeId();
 	PrimitiveType primType = Prim_Invalid;
-	if( IsElement( "lines"))
-		primType = Prim_Lines;
-	else if( IsElement( "linestrips"))
-		primType = Prim_LineStrip;
-	else if( IsElement( "polygons"))
-		primType = Prim_Polygon;
-	else if( IsElement( "polylist"))
-		primType = Prim_Polylist;
-	else if( IsElement( "triangles"))
-		primType = Prim_Triangles;
-	else if( IsElement( "trifans"))
-		primType = Prim_TriFans;
-	else if( IsElement( "tristrips"))
-		primType = Prim_TriStrips;
+	switch( elementId)
+	{
+		case Elem_Lines: primType = Prim_Lines; break;
+		case Elem_LineStrips: primType = Prim_LineStrip; break;
+		case Elem_Polygons: primType = Prim_Polygon; break;
+		case Elem_Polylist: primType = Prim_Polylist; break;
+		case Elem_Triangles: primType = Prim_Triangles; break;
+		case Elem_TriFans: primType = Prim_TriFans; break;
+		case Elem_TriStrips: primType = Prim_TriStrips; break;
+	}
 
 	ai_assert( primType != Prim_Invalid);
 
@@ -1888,11 +2104,12 @@ void ColladaParser::ReadIndexData( Mesh* pMesh)
 	{
 		if( mReader->getNodeType() == irr::io::EXN_ELEMENT)
 		{
-			if( IsElement( "input"))
+			const unsigned int id = mReader->getNodeId();
+			if( id == Elem_Input)
 			{
 				ReadInputChannel( perIndexData);
 			} 
-			else if( IsElement( "vcount"))
+			else if( id == Elem_VCount)
 			{
 				if( !mReader->isEmptyElement())
 				{
@@ -1900,22 +2117,15 @@ void ColladaParser::ReadIndexData( Mesh* pMesh)
 					{
 						// case <polylist> - specifies the number of indices for each polygon
 						const char* content = GetTextContent();
-						vcount.reserve( numPrimitives);
-						for( unsigned int a = 0; a < numPrimitives; a++)
-						{
-							if( *content == 0)
-								ThrowException( "Expected more values while reading <vcount> contents.");
-							// read a number
-							vcount.push_back( (size_t) strtoul10( content, &content));
-							// skip whitespace after it
-							SkipSpacesAndLineEnd( &content);
-						}
+						vcount.resize( numPrimitives);
+						if( strtol10_array( content, &vcount[0], numPrimitives) != numPrimitives)
+							ThrowException( "Expected more values while reading <vcount> contents.");
 					}
 
 					TestClosing( "vcount");
 				}
 			}
-			else if( IsElement( "p"))
+			else if( id == Elem_P)
 			{
 				if( !mReader->isEmptyElement())
 				{
@@ -1929,7 +2139,7 @@ void ColladaParser::ReadIndexData( Mesh* pMesh)
 		} 
 		else if( mReader->getNodeType() == irr::io::EXN_ELEMENT_END)
 		{
-			if( mReader->getNodeName() != elementName)
+			if( mReader->getNodeId() != elementId)
 				ThrowException( boost::str( boost::format( "Expected end of <%s> element.") % elementName));
 
 			break;
@@ -2025,15 +2235,25 @@ void ColladaParser::ReadPrimitives( Mesh* pMesh, std::vector<InputChannel>& pPer
 	if (pNumPrimitives > 0)	// It is possible to not contain any indicies
 	{
 		const char* content = GetTextContent();
-		while( *content != 0)
+		if( expectedPointCount > 0)
+		{
+			// we know the index count upfront, parse all of them in one go. Read one more 
+			// than expected to catch excess indices.
+			const size_t expected = expectedPointCount * numOffsets;
+			indices.resize( expected + 1);
+			indices.resize( strtol10_array( content, &indices[0], expected + 1));
+		}
+		else 
 		{
-			// read a value. 
-			// Hack: (thom) Some exporters put negative indices sometimes. We just try to carry on anyways.
-			int value = std::max( 0, strtol10( content, &content));
-			indices.push_back( size_t( value));
-			// skip whitespace after it
-			SkipSpacesAndLineEnd( &content);
+			std::vector<int> chunk( 4096);
+			for( size_t n; (n = strtol10_array( content, &chunk[0], chunk.size(), &content)) > 0; )
+				indices.insert( indices.end(), chunk.begin(), chunk.begin() + n);
 		}
+
+		// Hack: (thom) Some exporters put negative indices sometimes. We just try to carry on anyways.
+		for( std::vector<size_t>::iterator it = indices.begin(); it != indices.end(); ++it)
+			if( static_cast<ptrdiff_t>( *it) < 0)
+				*it = 0;
 	}
 
 	// complain if the index count doesn't fit
@@ -2042,6 +2262,10 @@ void ColladaParser::ReadPrimitives( Mesh* pMesh, std::vector<InputChannel>& pPer
 	else if( expectedPointCount == 0 && (indices.size() % numOffsets) != 0)
 		ThrowException( "Expected different index count in <p> element.");
 
+	// the per-vertex offset is also needed to assign bone weights
+	if( perVertexOffset == SIZE_MAX && !indices.empty())
+		ThrowException( "Missing VERTEX input in primitive specification.");
+
 	// find the data for all sources
   for( std::vector<InputChannel>::iterator it = pMesh->mPerVertexData.begin(); it != pMesh->mPerVertexData.end(); ++it)
 	{
@@ -2081,16 +2305,21 @@ void ColladaParser::ReadPrimitives( Mesh* pMesh, std::vector<InputChannel>& pPer
 	}
 
 
-	// now assemble vertex data according to those indices
+	// now assemble vertex data according to those indices. Corners with identical index tuples share 
+	// a vertex, its data is extracted only once
 	std::vector<size_t>::const_iterator idx = indices.begin();
+	SubMesh& subgroup = pMesh->mSubMeshes.back();
+	const size_t numCorners = indices.size() / numOffsets;
+	GrowIndexTupleHash( mVertexTupleHash, mVertexTuples, numOffsets, (subgroup.mNumVertices + numCorners) * 2);
+	const size_t hashMask = mVertexTupleHash.size() - 1;
 
 	// For continued primitives, the given count does not come all in one <p>, but only one primitive per <p>
 	size_t numPrimitives = pNumPrimitives;
 	if( pPrimType == Prim_TriFans || pPrimType == Prim_Polygon)
 		numPrimitives = 1;
 
-	pMesh->mFaceSize.reserve( numPrimitives);
-	pMesh->mFacePosIndices.reserve( indices.size() / numOffsets);
+	pMesh->mFaceSize.reserve( pMesh->mFaceSize.size() + numPrimitives);
+	pMesh->mFaceIndices.reserve( pMesh->mFaceIndices.size() + numCorners);
 
 	for( size_t a = 0; a < numPrimitives; a++)
 	{
@@ -2123,21 +2352,35 @@ void ColladaParser::ReadPrimitives( Mesh* pMesh, std::vector<InputChannel>& pPer
 		// gather that number of vertices
 		for( size_t b = 0; b < numPoints; b++)
 		{
-			// read all indices for this vertex. Yes, in a hacky local array
-			ai_assert( numOffsets < 20 && perVertexOffset < 20);
-			size_t vindex[20];
-			for( size_t offsets = 0; offsets < numOffsets; ++offsets)
-				vindex[offsets] = *idx++;
-
-			// extract per-vertex channels using the global per-vertex offset
-      for( std::vector<InputChannel>::iterator it = pMesh->mPerVertexData.begin(); it != pMesh->mPerVertexData.end(); ++it)
-        ExtractDataObjectFromChannel( *it, vindex[perVertexOffset], pMesh);
-			// and extract per-index channels using there specified offset
-      for( std::vector<InputChannel>::iterator it = pPerIndexChannels.begin(); it != pPerIndexChannels.end(); ++it)
-				ExtractDataObjectFromChannel( *it, vindex[it->mOffset], pMesh);
-
-			// store the vertex-data index for later assignment of bone vertex weights
-			pMesh->mFacePosIndices.push_back( vindex[perVertexOffset]);
+			// all indices for this vertex, they're stored consecutively
+			const size_t* vindex = &*idx;
+			idx += numOffsets;
+
+			// look up the index tuple, the corner refers to an existing vertex if found
+			size_t slot = HashIndexTuple( vindex, numOffsets) & hashMask;
+			for( ; mVertexTupleHash[slot]; slot = (slot + 1) & hashMask)
+			{
+				if( std::equal( vindex, vindex + numOffsets, &mVertexTuples[(mVertexTupleHash[slot] - 1) * numOffsets]))
+					break;
+			}
+
+			if( !mVertexTupleHash[slot])
+			{
+				mVertexTuples.insert( mVertexTuples.end(), vindex, vindex + numOffsets);
+				mVertexTupleHash[slot] = ++subgroup.mNumVertices;
+
+				// extract per-vertex channels using the global per-vertex offset
+				for( std::vector<InputChannel>::iterator it = pMesh->mPerVertexData.begin(); it != pMesh->mPerVertexData.end(); ++it)
+					ExtractDataObjectFromChannel( *it, vindex[perVertexOffset], pMesh);
+				// and extract per-index channels using there specified offset
+				for( std::vector<InputChannel>::iterator it = pPerIndexChannels.begin(); it != pPerIndexChannels.end(); ++it)
+					ExtractDataObjectFromChannel( *it, vindex[it->mOffset], pMesh);
+
+				// store the vertex-data index for later assignment of bone vertex weights
+				pMesh->mVertexPosIndices.push_back( vindex[perVertexOffset]);
+			}
+
+			pMesh->mFaceIndices.push_back( subgroup.mVertexStart + mVertexTupleHash[slot] - 1);
 		}
 	}
 
@@ -45,7 +45,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef AI_COLLADAPARSER_H_INC
 #define AI_COLLADAPARSER_H_INC
 
-#include "irrXMLWrapper.h"
+#include "FastXMLReader.h"
 #include "ColladaHelper.h"
 
 namespace Assimp
@@ -62,8 +62,9 @@ class ColladaParser
 	friend class ColladaLoader;
 
 protected:
-	/** Constructor from XML file */
-	ColladaParser( IOSystem* pIOHandler, const std::string& pFile);
+	/** Constructor from XML file. If pOnDemand is set, geometries, controllers
+	    and animations are only parsed if the visual scene refers to them */
+	ColladaParser( IOSystem* pIOHandler, const std::string& pFile, bool pOnDemand);
 
 	/** Destructor */
 	~ColladaParser();
@@ -74,6 +75,18 @@ protected:
 	/** Reads the structure of the file */
 	void ReadStructure();
 
+	/** Parses the deferred library entries reachable from the root node */
+	void ReadDeferredElements();
+
+	/** Collects the IDs, names and SIDs of all nodes and the mesh/controller 
+	    references reachable from the given node, following node instances */
+	void CollectReferences( const Collada::Node* pNode, std::set<const Collada::Node*>& pVisited,
+		std::set<std::string>& pNodeNames, std::set<std::string>& pMeshRefs) const;
+
+	/** Checks whether the deferred animation targets one of the given node IDs, 
+	    names or SIDs */
+	bool IsAnimationTargeting( const FastXMLReader::ElementMark& pMark, const std::set<std::string>& pNodeNames) const;
+
 	/** Reads asset informations such as coordinate system informations and legal blah */
 	void ReadAssetInfo();
 
@@ -89,6 +102,9 @@ protected:
 	/** Reads the skeleton controller library */
 	void ReadControllerLibrary();
 
+	/** Reads a <controller> element and stores it in the library */
+	void ReadControllerElement();
+
 	/** Reads a controller into the given mesh structure */
 	void ReadController( Collada::Controller& pController);
 
@@ -146,6 +162,9 @@ protected:
 	/** Reads the geometry library contents */
 	void ReadGeometryLibrary();
 
+	/** Reads a <geometry> element and stores the mesh in the library */
+	void ReadGeometryElement();
+
 	/** Reads a geometry from the geometry library. */
 	void ReadGeometry( Collada::Mesh* pMesh);
 
@@ -257,7 +276,33 @@ protected:
 	std::string mFileName;
 
 	/** XML reader, member for everyday use */
-	irr::io::IrrXMLReader* mReader;
+	FastXMLReader* mReader;
+
+	/** Elements the geometry parsing code dispatches on by their interned id,
+	    see FastXMLReader::getNodeId(). Keep in sync with the name table in ColladaParser.cpp */
+	enum ElementId
+	{
+		Elem_Mesh,
+		Elem_Source,
+		Elem_FloatArray,
+		Elem_IDREFArray,
+		Elem_NameArray,
+		Elem_TechniqueCommon,
+		Elem_Accessor,
+		Elem_Vertices,
+		Elem_Input,
+		Elem_VCount,
+		Elem_P,
+		Elem_Lines,
+		Elem_LineStrips,
+		Elem_Polygons,
+		Elem_Polylist,
+		Elem_Triangles,
+		Elem_TriFans,
+		Elem_TriStrips,
+
+		Elem_Count
+	};
 
 	/** All data arrays found in the file by ID. Might be referred to by actually 
 	    everyone. Collada, you are a steaming pile of indirection. */
@@ -300,6 +345,22 @@ protected:
 	typedef std::map<std::string, Collada::Controller> ControllerLibrary;
 	ControllerLibrary mControllerLibrary;
 
+	/** Parse library entries only if they're referenced, see ReadDeferredElements() */
+	bool mReadOnDemand;
+
+	/** Geometries and controllers skipped in on-demand mode, by ID */
+	typedef std::map<std::string, FastXMLReader::ElementMark> DeferredLibrary;
+	DeferredLibrary mDeferredGeometries;
+	DeferredLibrary mDeferredControllers;
+
+	/** Top-level animations skipped in on-demand mode, in file order */
+	std::vector<FastXMLReader::ElementMark> mDeferredAnimations;
+
+	/** Index tuples of the unique vertices of the submesh being read and an
+	    open-addressing hash table of their 1-based indices. See ReadPrimitives() */
+	std::vector<size_t> mVertexTuples;
+	std::vector<size_t> mVertexTupleHash;
+
 	/** Pointer to the root node. Don't delete, it just points to one of 
 	    the nodes in the node library. */
 	Collada::Node* mRootNode;
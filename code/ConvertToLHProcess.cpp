@@ -160,6 +160,27 @@ void MakeLeftHandedProcess::ProcessMesh( aiMesh* pMesh)
 		for( unsigned int a = 0; a < pMesh->mNumVertices; a++)
 			pMesh->mBitangents[a] *= -1.0f;
 	}
+
+	// mirror the frames of the vertex animation the same way
+	for( unsigned int i = 0; i < pMesh->mNumAnimMeshes; ++i)
+	{
+		aiAnimMesh* anim = pMesh->mAnimMeshes[i];
+		for( size_t a = 0; a < anim->mNumVertices; ++a)
+		{
+			if( anim->HasPositions())
+				anim->mVertices[a].z *= -1.0f;
+			if( anim->HasNormals())
+				anim->mNormals[a].z *= -1.0f;
+			if( anim->HasTangentsAndBitangents())
+			{
+				anim->mTangents[a].z *= -1.0f;
+				anim->mBitangents[a].z *= -1.0f;
+
+				// see above, bitangents are derived from the texture coords
+				anim->mBitangents[a] *= -1.0f;
+			}
+		}
+	}
 }
 
 // ------------------------------------------------------------------------------------------------
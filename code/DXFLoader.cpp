@@ -100,9 +100,27 @@ static const aiImporterDesc desc = {
 	"dxf" 
 };
 
+// ------------------------------------------------------------------------------------------------
+// Get the transformation from the coordinate system of a BLOCK to the one of an INSERT
+// referencing it: the base point of the block is moved to the origin, then the geometry
+// is scaled, rotated around the z axis and moved to the insertion point.
+static aiMatrix4x4 GetInsertTransform(const DXF::InsertBlock& insert, const DXF::Block& bl)
+{
+	aiMatrix4x4 trafo, tmp;
+	aiMatrix4x4::Translation(insert.pos,trafo);
+	if (insert.angle != 0.f) {
+		const float angle = insert.angle;
+		trafo *= aiMatrix4x4::RotationZ(AI_DEG_TO_RAD(angle),tmp);
+	}
+	trafo *= aiMatrix4x4::Scaling(insert.scale,tmp);
+	trafo *= aiMatrix4x4::Translation(-bl.base,tmp);
+	return trafo;
+}
+
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 DXFImporter::DXFImporter()
+: configInstanceBlocks()
 {}
 
 // ------------------------------------------------------------------------------------------------
@@ -117,6 +135,13 @@ bool DXFImporter::CanRead( const std::string& pFile, IOSystem* /*pIOHandler*/, b
 	return SimpleExtensionCheck(pFile,"dxf");
 }
 
+// ------------------------------------------------------------------------------------------------
+// Setup configuration properties
+void DXFImporter::SetupProperties(const Importer* pImp)
+{
+	configInstanceBlocks = pImp->GetPropertyBool(AI_CONFIG_IMPORT_DXF_INSTANCE_BLOCKS,false);
+}
+
 // ------------------------------------------------------------------------------------------------
 // Get a list of all supported file extensions
 const aiImporterDesc* DXFImporter::GetInfo () const
@@ -214,7 +239,6 @@ void DXFImporter::ConvertMeshes(aiScene* pScene, DXF::FileData& output)
 {
 	// the process of resolving all the INSERT statements can grow the
 	// polycount excessively, so log the original number.
-	// XXX Option to import blocks as separate nodes?
 	if (!DefaultLogger::isNullLogger()) {
 
 		unsigned int vcount = 0, icount = 0;
@@ -249,23 +273,74 @@ void DXFImporter::ConvertMeshes(aiScene* pScene, DXF::FileData& output)
 		throw DeadlyImportError("DXF: no ENTITIES data block loaded");
 	}
 
+	std::vector<aiMesh*> meshes;
+	std::vector<aiNode*> inserts;
+	std::vector<const DXF::Block*> path(1,entities);
+	unsigned int num_layers = 0;
+
+	try {
+		if (configInstanceBlocks) {
+			ConvertLines(*entities,meshes);
+			num_layers = static_cast<unsigned int>(meshes.size());
+
+			// convert each BLOCK only once and reference its meshes from one node per INSERT
+			std::map<const DXF::Block*, std::vector<unsigned int> > block_meshes;
+			BOOST_FOREACH (const DXF::InsertBlock& insert, entities->insertions) {
+				aiNode* const nd = ConvertInsertion(insert,blocks_by_name,block_meshes,meshes,path);
+				if (nd) {
+					inserts.push_back(nd);
+				}
+			}
+		}
+		else {
+			// now expand all block references in the primary ENTITIES block
+			// XXX this involves heavy memory copying, AI_CONFIG_IMPORT_DXF_INSTANCE_BLOCKS avoids it.
+			ExpandBlockReferences(*entities,*entities,aiMatrix4x4(),blocks_by_name,path);
+
+			ConvertLines(*entities,meshes);
+			num_layers = static_cast<unsigned int>(meshes.size());
+		}
+	}
+	catch(...) {
+		BOOST_FOREACH(aiMesh* mesh, meshes) {
+			delete mesh;
+		}
+		BOOST_FOREACH(aiNode* nd, inserts) {
+			delete nd;
+		}
+		throw;
+	}
+
+	if (meshes.empty()) {
+		BOOST_FOREACH(aiNode* nd, inserts) {
+			delete nd;
+		}
+		throw DeadlyImportError("DXF: this file contains no 3d data");
+	}
+
+	pScene->mNumMeshes = static_cast<unsigned int>(meshes.size());
+	pScene->mMeshes = new aiMesh*[ pScene->mNumMeshes ];
+	std::copy(meshes.begin(),meshes.end(),pScene->mMeshes);
+
+	GenerateHierarchy(pScene,num_layers,inserts);
+	GenerateMaterials(pScene,output);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+void DXFImporter::ConvertLines(const DXF::Block& bl, std::vector<aiMesh*>& meshes)
+{
 	typedef std::map<std::string, unsigned int> LayerMap;
 
 	LayerMap layers;
 	std::vector< std::vector< const DXF::PolyLine*> > corr;
 
-	// now expand all block references in the primary ENTITIES block
-	// XXX this involves heavy memory copying, consider a faster solution for future versions.
-	ExpandBlockReferences(*entities,blocks_by_name);
-
 	unsigned int cur = 0;
-	BOOST_FOREACH (boost::shared_ptr<const DXF::PolyLine> pl, entities->lines) {
+	BOOST_FOREACH (boost::shared_ptr<const DXF::PolyLine> pl, bl.lines) {
 		if (pl->positions.size()) {
 
 			std::map<std::string, unsigned int>::iterator it = layers.find(pl->layer);
 			if (it == layers.end()) {
-				++pScene->mNumMeshes;
-
 				layers[pl->layer] = cur++;
 
 				std::vector< const DXF::PolyLine* > pv;
@@ -279,14 +354,12 @@ void DXFImporter::ConvertMeshes(aiScene* pScene, DXF::FileData& output)
 		}
 	}
 
-	if (!pScene->mNumMeshes) {
-		throw DeadlyImportError("DXF: this file contains no 3d data");
-	}
-
-	pScene->mMeshes = new aiMesh*[ pScene->mNumMeshes ] ();
+	// one mesh per layer, in the order the layers first appear
+	const size_t base = meshes.size();
+	meshes.resize(base + layers.size(),NULL);
 
 	BOOST_FOREACH(const LayerMap::value_type& elem, layers){
-		aiMesh* const mesh =  pScene->mMeshes[elem.second] = new aiMesh();
+		aiMesh* const mesh = meshes[base + elem.second] = new aiMesh();
 		mesh->mName.Set(elem.first);
 
 		unsigned int cvert = 0,cface = 0;
@@ -345,52 +418,131 @@ void DXFImporter::ConvertMeshes(aiScene* pScene, DXF::FileData& output)
 		mesh->mPrimitiveTypes = prims;
 		mesh->mMaterialIndex = 0;
 	}
+}
 
-	GenerateHierarchy(pScene,output);
-	GenerateMaterials(pScene,output);
+
+// ------------------------------------------------------------------------------------------------
+aiNode* DXFImporter::ConvertInsertion(const DXF::InsertBlock& insert,
+	const DXF::BlockMap& blocks_by_name,
+	std::map<const DXF::Block*, std::vector<unsigned int> >& block_meshes,
+	std::vector<aiMesh*>& meshes,
+	std::vector<const DXF::Block*>& path)
+{
+	const DXF::Block* const bl = ResolveInsertion(insert,blocks_by_name,path);
+	if (!bl) {
+		return NULL;
+	}
+
+	// the geometry of a BLOCK is converted only once, all further INSERTs share it.
+	std::map<const DXF::Block*, std::vector<unsigned int> >::iterator it = block_meshes.find(bl);
+	if (it == block_meshes.end()) {
+		const unsigned int first = static_cast<unsigned int>(meshes.size());
+		ConvertLines(*bl,meshes);
+
+		it = block_meshes.insert(std::make_pair(bl,std::vector<unsigned int>())).first;
+		for (unsigned int i = first; i < meshes.size(); ++i) {
+			(*it).second.push_back(i);
+		}
+	}
+
+	aiNode* const nd = new aiNode();
+	nd->mName.Set(bl->name);
+	nd->mTransformation = GetInsertTransform(insert,*bl);
+
+	const std::vector<unsigned int>& indices = (*it).second;
+	if (!indices.empty()) {
+		nd->mMeshes = new unsigned int[ nd->mNumMeshes = static_cast<unsigned int>(indices.size()) ];
+		std::copy(indices.begin(),indices.end(),nd->mMeshes);
+	}
+
+	// nested INSERTs become child nodes
+	std::vector<aiNode*> children;
+	path.push_back(bl);
+	try {
+		BOOST_FOREACH (const DXF::InsertBlock& child, bl->insertions) {
+			aiNode* const cnd = ConvertInsertion(child,blocks_by_name,block_meshes,meshes,path);
+			if (cnd) {
+				cnd->mParent = nd;
+				children.push_back(cnd);
+			}
+		}
+	}
+	catch(...) {
+		BOOST_FOREACH(aiNode* cnd, children) {
+			delete cnd;
+		}
+		delete nd;
+		throw;
+	}
+	path.pop_back();
+
+	if (!children.empty()) {
+		nd->mChildren = new aiNode*[ nd->mNumChildren = static_cast<unsigned int>(children.size()) ];
+		std::copy(children.begin(),children.end(),nd->mChildren);
+	}
+	return nd;
 }
 
 
 // ------------------------------------------------------------------------------------------------
-void DXFImporter::ExpandBlockReferences(DXF::Block& bl,const DXF::BlockMap& blocks_by_name)
+const DXF::Block* DXFImporter::ResolveInsertion(const DXF::InsertBlock& insert,
+	const DXF::BlockMap& blocks_by_name,
+	const std::vector<const DXF::Block*>& path)
 {
-	BOOST_FOREACH (const DXF::InsertBlock& insert, bl.insertions) {
+	// first check if the referenced blocks exists ...
+	const DXF::BlockMap::const_iterator it = blocks_by_name.find(insert.name);
+	if (it == blocks_by_name.end()) {
+		DefaultLogger::get()->error((Formatter::format("DXF: Failed to resolve block reference: "),
+			insert.name,"; skipping"
+		));
+		return NULL;
+	}
 
-		// first check if the referenced blocks exists ...
-		const DXF::BlockMap::const_iterator it = blocks_by_name.find(insert.name);
-		if (it == blocks_by_name.end()) {
-			DefaultLogger::get()->error((Formatter::format("DXF: Failed to resolve block reference: "),
-				insert.name,"; skipping"
-			));
+	// ... and that it is not already being inserted further up the chain
+	if (std::find(path.begin(),path.end(),(*it).second) != path.end()) {
+		DefaultLogger::get()->error((Formatter::format("DXF: Recursive block reference: "),
+			insert.name,"; skipping"
+		));
+		return NULL;
+	}
+	return (*it).second;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+void DXFImporter::ExpandBlockReferences(DXF::Block& bl,
+	const DXF::Block& src,
+	const aiMatrix4x4& trafo,
+	const DXF::BlockMap& blocks_by_name,
+	std::vector<const DXF::Block*>& path)
+{
+	BOOST_FOREACH (const DXF::InsertBlock& insert, src.insertions) {
+
+		const DXF::Block* const bl_src = ResolveInsertion(insert,blocks_by_name,path);
+		if (!bl_src) {
 			continue;
 		}
 
-		// XXX this would be the place to implement recursive expansion if needed.
-		const DXF::Block& bl_src = *(*it).second;
+		// manual coordinate system transformation
+		const aiMatrix4x4 mat = trafo * GetInsertTransform(insert,*bl_src);
+		const bool transform = !mat.IsIdentity();
 		
-		BOOST_FOREACH (boost::shared_ptr<const DXF::PolyLine> pl_in, bl_src.lines) {
+		BOOST_FOREACH (boost::shared_ptr<const DXF::PolyLine> pl_in, bl_src->lines) {
 			boost::shared_ptr<DXF::PolyLine> pl_out = boost::shared_ptr<DXF::PolyLine>(new DXF::PolyLine(*pl_in));
 
-			if (bl_src.base.Length() || insert.scale.x!=1.f || insert.scale.y!=1.f || insert.scale.z!=1.f || insert.angle || insert.pos.Length()) {
-				// manual coordinate system transformation
-				// XXX order
-				aiMatrix4x4 trafo, tmp;
-				aiMatrix4x4::Translation(-bl_src.base,trafo);
-				trafo *= aiMatrix4x4::Scaling(insert.scale,tmp);
-				trafo *= aiMatrix4x4::Translation(insert.pos,tmp);
-
-				// XXX rotation currently ignored - I didn't find an appropriate sample model.
-				if (insert.angle != 0.f) {
-					DefaultLogger::get()->warn("DXF: BLOCK rotation not currently implemented");
-				}
-
+			if (transform) {
 				BOOST_FOREACH (aiVector3D& v, pl_out->positions) {
-					v *= trafo;
+					v *= mat;
 				}
 			}
 
 			bl.lines.push_back(pl_out);
 		}
+
+		// nested INSERTs are placed relative to the block which contains them
+		path.push_back(bl_src);
+		ExpandBlockReferences(bl,*bl_src,mat,blocks_by_name,path);
+		path.pop_back();
 	}
 }
 
@@ -423,20 +575,24 @@ void DXFImporter::GenerateMaterials(aiScene* pScene, DXF::FileData& /*output*/)
 
 
 // ------------------------------------------------------------------------------------------------
-void DXFImporter::GenerateHierarchy(aiScene* pScene, DXF::FileData& /*output*/)
+void DXFImporter::GenerateHierarchy(aiScene* pScene, 
+	unsigned int num_layers,
+	const std::vector<aiNode*>& inserts)
 {
-	// generate the output scene graph, which is just the root node with a single child for each layer.
+	// generate the output scene graph, which is just the root node with a single child for each layer,
+	// plus one child for each INSERT if blocks are kept as shared meshes.
 	pScene->mRootNode = new aiNode();
 	pScene->mRootNode->mName.Set("<DXF_ROOT>");
 
-	if (1 == pScene->mNumMeshes)	{
+	if (1 == num_layers && inserts.empty())	{
 		pScene->mRootNode->mMeshes = new unsigned int[ pScene->mRootNode->mNumMeshes = 1 ];
 		pScene->mRootNode->mMeshes[0] = 0;
 	}
 	else
 	{
-		pScene->mRootNode->mChildren = new aiNode*[ pScene->mRootNode->mNumChildren = pScene->mNumMeshes ];
-		for (unsigned int m = 0; m < pScene->mRootNode->mNumChildren;++m)	{
+		pScene->mRootNode->mNumChildren = num_layers + static_cast<unsigned int>(inserts.size());
+		pScene->mRootNode->mChildren = new aiNode*[ pScene->mRootNode->mNumChildren ];
+		for (unsigned int m = 0; m < num_layers;++m)	{
 			aiNode* p = pScene->mRootNode->mChildren[m] = new aiNode();
 			p->mName = pScene->mMeshes[m]->mName;
 
@@ -444,6 +600,10 @@ void DXFImporter::GenerateHierarchy(aiScene* pScene, DXF::FileData& /*output*/)
 			p->mMeshes[0] = m;
 			p->mParent = pScene->mRootNode;
 		}
+		for (unsigned int i = 0; i < inserts.size();++i)	{
+			aiNode* p = pScene->mRootNode->mChildren[num_layers + i] = inserts[i];
+			p->mParent = pScene->mRootNode;
+		}
 	}
 }
 
@@ -509,11 +669,10 @@ void DXFImporter::ParseBlock(DXF::LineReader& reader, DXF::FileData& output)
 			continue;
 		}
 
-		// XXX is this a valid case?
+		// nested block references, resolved when the blocks are expanded
 		if (reader.Is(0,"INSERT")) {
-			DefaultLogger::get()->warn("DXF: INSERT within a BLOCK not currently supported; skipping");
-			for( ;!reader.End() && !reader.Is(0,"ENDBLK"); ++reader);
-			break;
+			ParseInsertion(++reader,output);
+			continue;
 		}
 
 		else if (reader.Is(0,"3DFACE") || reader.Is(0,"LINE") || reader.Is(0,"3DLINE")) {
@@ -79,6 +79,13 @@ public:
 	bool CanRead( const std::string& pFile, IOSystem* pIOHandler, 
 		bool checkSig) const;
 
+	// -------------------------------------------------------------------
+	/** Called prior to ReadFile().
+	* The function is a request to the importer to update its configuration
+	* basing on the Importer's configuration property list.
+	*/
+	void SetupProperties(const Importer* pImp);
+
 protected:
 
 	// -------------------------------------------------------------------
@@ -134,9 +141,21 @@ private:
 	void ConvertMeshes(aiScene* pScene, 
 		DXF::FileData& output);
 
+	// -----------------------------------------------------
+	void ConvertLines(const DXF::Block& bl,
+		std::vector<aiMesh*>& meshes);
+
+	// -----------------------------------------------------
+	aiNode* ConvertInsertion(const DXF::InsertBlock& insert,
+		const DXF::BlockMap& blocks_by_name,
+		std::map<const DXF::Block*, std::vector<unsigned int> >& block_meshes,
+		std::vector<aiMesh*>& meshes,
+		std::vector<const DXF::Block*>& path);
+
 	// -----------------------------------------------------
 	void GenerateHierarchy(aiScene* pScene, 
-		DXF::FileData& output);
+		unsigned int num_layers,
+		const std::vector<aiNode*>& inserts);
 
 	// -----------------------------------------------------
 	void GenerateMaterials(aiScene* pScene, 
@@ -144,7 +163,20 @@ private:
 
 	// -----------------------------------------------------
 	void ExpandBlockReferences(DXF::Block& bl,
-		const DXF::BlockMap& blocks_by_name);
+		const DXF::Block& src,
+		const aiMatrix4x4& trafo,
+		const DXF::BlockMap& blocks_by_name,
+		std::vector<const DXF::Block*>& path);
+
+	// -----------------------------------------------------
+	const DXF::Block* ResolveInsertion(const DXF::InsertBlock& insert,
+		const DXF::BlockMap& blocks_by_name,
+		const std::vector<const DXF::Block*>& path);
+
+private:
+
+	/** Configuration option: keep BLOCKs as shared meshes */
+	bool configInstanceBlocks;
 };
 
 } // end of namespace Assimp
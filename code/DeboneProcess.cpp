@@ -460,5 +460,32 @@ void DeboneProcess::ApplyTransform(aiMesh* mesh, const aiMatrix4x4& mat)const
 				}
 			}
 		}
+
+		// the frames of the vertex animation move along with the mesh
+		for (unsigned int a = 0; a < mesh->mNumAnimMeshes; ++a) {
+			aiAnimMesh* anim = mesh->mAnimMeshes[a];
+			if (anim->HasPositions()) {
+				for (unsigned int i = 0; i < anim->mNumVertices; ++i) {
+					anim->mVertices[i] = mat * anim->mVertices[i];
+				}
+			}
+			if (anim->HasNormals() || anim->HasTangentsAndBitangents()) {
+				aiMatrix4x4 mWorldIT = mat;
+				mWorldIT.Inverse().Transpose();
+				aiMatrix3x3 m = aiMatrix3x3(mWorldIT);
+
+				if (anim->HasNormals()) {
+					for (unsigned int i = 0; i < anim->mNumVertices; ++i) {
+						anim->mNormals[i] = (m * anim->mNormals[i]).Normalize();
+					}
+				}
+				if (anim->HasTangentsAndBitangents()) {
+					for (unsigned int i = 0; i < anim->mNumVertices; ++i) {
+						anim->mTangents[i]   = (m * anim->mTangents[i]).Normalize();
+						anim->mBitangents[i] = (m * anim->mBitangents[i]).Normalize();
+					}
+				}
+			}
+		}
 	}
 }
@@ -53,9 +53,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #ifndef ASSIMP_BUILD_SINGLETHREADED
 #	include <boost/thread/thread.hpp>
-#	include <boost/thread/mutex.hpp>
+#	include <boost/thread/recursive_mutex.hpp>
 
-boost::mutex loggerMutex;
+// recursive, a log stream may log again while a message is written to it
+boost::recursive_mutex loggerMutex;
 #endif
 
 namespace Assimp	{
@@ -130,7 +131,7 @@ Logger *DefaultLogger::create(const char* name /*= "AssimpLog.txt"*/,
 {
 	// enter the mutex here to avoid concurrency problems
 #ifndef ASSIMP_BUILD_SINGLETHREADED
-	boost::mutex::scoped_lock lock(loggerMutex);
+	boost::recursive_mutex::scoped_lock lock(loggerMutex);
 #endif
 
 	if (m_pLogger && !isNullLogger() )
@@ -209,7 +210,7 @@ void DefaultLogger::set( Logger *logger )
 {
 	// enter the mutex here to avoid concurrency problems
 #ifndef ASSIMP_BUILD_SINGLETHREADED
-	boost::mutex::scoped_lock lock(loggerMutex);
+	boost::recursive_mutex::scoped_lock lock(loggerMutex);
 #endif
 
 	if (!logger)logger = &s_pNullLogger;
@@ -238,7 +239,7 @@ void DefaultLogger::kill()
 {
 	// enter the mutex here to avoid concurrency problems
 #ifndef ASSIMP_BUILD_SINGLETHREADED
-	boost::mutex::scoped_lock lock(loggerMutex);
+	boost::recursive_mutex::scoped_lock lock(loggerMutex);
 #endif
 
 	if (m_pLogger == &s_pNullLogger)return;
@@ -376,6 +377,15 @@ void DefaultLogger::WriteToStreams(const char *message,
 {
 	ai_assert(NULL != message);
 
+	// enter the mutex here to avoid concurrency problems, messages
+	// may come in from multiple worker threads of the same import
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+	boost::recursive_mutex::scoped_lock lock(loggerMutex);
+#endif
+
+	// a stream which logs itself overwrites lastMsg, so write a copy
+	char buffer[MAX_LOG_MESSAGE_LENGTH*2];
+
 	// Check whether this is a repeated message
 	if (! ::strncmp( message,lastMsg, lastLen-1))
 	{
@@ -393,7 +403,8 @@ void DefaultLogger::WriteToStreams(const char *message,
 		::memcpy(lastMsg,message,lastLen+1);
 		::strcat(lastMsg+lastLen,"\n");
 
-		message = lastMsg;
+		::memcpy(buffer,lastMsg,lastLen+2);
+		message = buffer;
 		noRepeatMsg = false;
 		++lastLen;
 	}
@@ -108,7 +108,7 @@ AnimationCurveNode::AnimationCurveNode(uint64_t id, const Element& element, cons
 	
 	// find target node
 	const char* whitelist[] = {"Model","NodeAttribute"};
-	const std::vector<const Connection*>& conns = doc.GetConnectionsBySourceSequenced(ID(),whitelist,2);
+	const ConnectionList& conns = doc.GetConnectionsBySourceSequenced(ID(),whitelist,2);
 
 	BOOST_FOREACH(const Connection* con, conns) {
 
@@ -169,7 +169,7 @@ const AnimationCurveMap& AnimationCurveNode::Curves() const
 {
 	if(curves.empty()) {
 		// resolve attached animation curves
-		const std::vector<const Connection*>& conns = doc.GetConnectionsByDestinationSequenced(ID(),"AnimationCurve");
+		const ConnectionList& conns = doc.GetConnectionsByDestinationSequenced(ID(),"AnimationCurve");
 
 		BOOST_FOREACH(const Connection* con, conns) {
 
@@ -224,7 +224,7 @@ AnimationCurveNodeList AnimationLayer::Nodes(const char* const * target_prop_whi
 	AnimationCurveNodeList nodes;
 
 	// resolve attached animation nodes
-	const std::vector<const Connection*>& conns = doc.GetConnectionsByDestinationSequenced(ID(),"AnimationCurveNode");
+	const ConnectionList& conns = doc.GetConnectionsByDestinationSequenced(ID(),"AnimationCurveNode");
 	nodes.reserve(conns.size());
 
 	BOOST_FOREACH(const Connection* con, conns) {
@@ -275,7 +275,7 @@ AnimationStack::AnimationStack(uint64_t id, const Element& element, const std::s
 	props = GetPropertyTable(doc,"AnimationStack.FbxAnimStack",element,sc, true);
 
 	// resolve attached animation layers
-	const std::vector<const Connection*>& conns = doc.GetConnectionsByDestinationSequenced(ID(),"AnimationLayer");
+	const ConnectionList& conns = doc.GetConnectionsByDestinationSequenced(ID(),"AnimationLayer");
 	layers.reserve(conns.size());
 
 	BOOST_FOREACH(const Connection* con, conns) {
@@ -47,6 +47,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <iterator>
 #include <sstream>
+#include <deque>
 #include <boost/tuple/tuple.hpp>
 
 #include "FBXParser.h"
@@ -55,6 +56,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "FBXUtil.h"
 #include "FBXProperties.h"
 #include "FBXImporter.h"
+#include "ParallelFor.h"
 
 namespace Assimp {
 namespace FBX {
@@ -166,7 +168,7 @@ private:
 	// collect and assign child nodes
 	void ConvertNodes(uint64_t id, aiNode& parent, const aiMatrix4x4& parent_transform = aiMatrix4x4())
 	{
-		const std::vector<const Connection*>& conns = doc.GetConnectionsByDestinationSequenced(id, "Model");
+		const ConnectionList& conns = doc.GetConnectionsByDestinationSequenced(id, "Model");
 
 		std::vector<aiNode*> nodes;
 		nodes.reserve(conns.size());
@@ -1970,12 +1972,23 @@ private:
 				GenerateNodeAnimations(node_anims, 
 					kv.first, 
 					kv.second, 
-					layer_map, 
-					max_time, 
-					min_time);
+					layer_map);
+			}
+
+			// the keys of all channels have only been allocated so far. Evaluating 
+			// them does not touch the FBX DOM anymore, so we can do this for all 
+			// channels in parallel.
+			BakeKeysJob job(*this);
+			ParallelFor(pending_keys.size(), job);
+
+			BOOST_FOREACH(const PendingKeys& pk, pending_keys) {
+				min_time = std::min(min_time, pk.min_time);
+				max_time = std::max(max_time, pk.max_time);
 			}
+			pending_keys.clear();
 		}
 		catch(std::exception&) {
+			pending_keys.clear();
 			std::for_each(node_anims.begin(), node_anims.end(), Util::delete_fun<aiNodeAnim>());
 			throw;
 		}
@@ -2005,9 +2018,7 @@ private:
 	void GenerateNodeAnimations(std::vector<aiNodeAnim*>& node_anims, 
 		const std::string& fixed_name, 
 		const std::vector<const AnimationCurveNode*>& curves, 
-		const LayerMap& layer_map, 
-		double& max_time,
-		double& min_time)
+		const LayerMap& layer_map)
 	{
 
 		NodeMap node_property_map;
@@ -2098,8 +2109,6 @@ private:
 			aiNodeAnim* const nd = GenerateSimpleNodeAnim(fixed_name, target, chain, 
 				node_property_map.end(), 
 				layer_map,
-				max_time,
-				min_time,
 				true // input is TRS order, assimp is SRT
 				);
 
@@ -2135,9 +2144,7 @@ private:
 					na = GenerateRotationNodeAnim(chain_name, 
 						target, 
 						(*chain[i]).second,
-						layer_map,
-						max_time,
-						min_time);
+						layer_map);
 
 					break;
 
@@ -2150,9 +2157,7 @@ private:
 					na = GenerateTranslationNodeAnim(chain_name, 
 						target, 
 						(*chain[i]).second,
-						layer_map,
-						max_time,
-						min_time);
+						layer_map);
 
 					// pivoting requires us to generate an implicit inverse channel to undo the pivot translation
 					if (comp == TransformationComp_RotationPivot) {
@@ -2163,8 +2168,6 @@ private:
 							target, 
 							(*chain[i]).second,
 							layer_map,
-							max_time,
-							min_time,
 							true);
 
 						ai_assert(inv);
@@ -2181,8 +2184,6 @@ private:
 							target, 
 							(*chain[i]).second,
 							layer_map,
-							max_time,
-							min_time,
 							true);
 
 						ai_assert(inv);
@@ -2199,9 +2200,7 @@ private:
 					na = GenerateScalingNodeAnim(chain_name, 
 						target, 
 						(*chain[i]).second,
-						layer_map,
-						max_time,
-						min_time);
+						layer_map);
 
 					break;
 
@@ -2270,14 +2269,12 @@ private:
 	aiNodeAnim* GenerateRotationNodeAnim(const std::string& name, 
 		const Model& target, 
 		const std::vector<const AnimationCurveNode*>& curves,
-		const LayerMap& layer_map,
-		double& max_time,
-		double& min_time)
+		const LayerMap& layer_map)
 	{
 		ScopeGuard<aiNodeAnim> na(new aiNodeAnim());
 		na->mNodeName.Set(name);
 
-		ConvertRotationKeys(na, curves, layer_map, max_time,min_time, target.RotationOrder());
+		ConvertRotationKeys(na, curves, layer_map, target.RotationOrder());
 
 		// dummy scaling key
 		na->mScalingKeys = new aiVectorKey[1];
@@ -2301,14 +2298,12 @@ private:
 	aiNodeAnim* GenerateScalingNodeAnim(const std::string& name, 
 		const Model& target, 
 		const std::vector<const AnimationCurveNode*>& curves,
-		const LayerMap& layer_map,
-		double& max_time,
-		double& min_time)
+		const LayerMap& layer_map)
 	{
 		ScopeGuard<aiNodeAnim> na(new aiNodeAnim());
 		na->mNodeName.Set(name);
 
-		ConvertScaleKeys(na, curves, layer_map, max_time,min_time);
+		ConvertScaleKeys(na, curves, layer_map);
 
 		// dummy rotation key
 		na->mRotationKeys = new aiQuatKey[1];
@@ -2333,20 +2328,12 @@ private:
 		const Model& target, 
 		const std::vector<const AnimationCurveNode*>& curves,
 		const LayerMap& layer_map,
-		double& max_time,
-		double& min_time,
 		bool inverse = false)
 	{
 		ScopeGuard<aiNodeAnim> na(new aiNodeAnim());
 		na->mNodeName.Set(name);
 
-		ConvertTranslationKeys(na, curves, layer_map, max_time,min_time);
-
-		if (inverse) {
-			for (unsigned int i = 0; i < na->mNumPositionKeys; ++i) {
-				na->mPositionKeys[i].mValue *= -1.0f;
-			}
-		}
+		ConvertTranslationKeys(na, curves, layer_map, inverse);
 
 		// dummy scaling key
 		na->mScalingKeys = new aiVectorKey[1];
@@ -2373,8 +2360,6 @@ private:
 		NodeMap::const_iterator chain[TransformationComp_MAXIMUM], 
 		NodeMap::const_iterator iter_end,
 		const LayerMap& layer_map,
-		double& max_time,
-		double& min_time,
 		bool reverse_order = false)
 
 	{
@@ -2420,34 +2405,27 @@ private:
 			joined.insert(joined.end(), translation.begin(), translation.end());
 			joined.insert(joined.end(), rotation.begin(), rotation.end());
 
-			const KeyTimeList& times = GetKeyTimeList(joined);
+			PendingKeys& pk = AddPendingKeys(na, PendingKeys::Type_TRStoSRT, target.RotationOrder());
+			pk.times = GetKeyTimeList(joined);
 
-			aiQuatKey* out_quat = new aiQuatKey[times.size()];
-			aiVectorKey* out_scale = new aiVectorKey[times.size()];
-			aiVectorKey* out_translation = new aiVectorKey[times.size()];
+			pk.scaling.swap(scaling);
+			pk.translation.swap(translation);
+			pk.rotation.swap(rotation);
 
-			ConvertTransformOrder_TRStoSRT(out_quat, out_scale, out_translation, 
-				scaling, 
-				translation, 
-				rotation, 
-				times,
-				max_time,
-				min_time,
-				target.RotationOrder(),
-				def_scale,
-				def_translate,
-				def_rot);
+			pk.def_scale = def_scale;
+			pk.def_translate = def_translate;
+			pk.def_rotation = def_rot;
 
 			// XXX remove duplicates / redundant keys which this operation did
 			// likely produce if not all three channels were equally dense.
 
-			na->mNumScalingKeys = static_cast<unsigned int>(times.size());
+			na->mNumScalingKeys = static_cast<unsigned int>(pk.times.size());
 			na->mNumRotationKeys = na->mNumScalingKeys;
 			na->mNumPositionKeys = na->mNumScalingKeys;
 
-			na->mScalingKeys = out_scale;
-			na->mRotationKeys = out_quat;
-			na->mPositionKeys = out_translation;
+			na->mScalingKeys = new aiVectorKey[pk.times.size()];
+			na->mRotationKeys = new aiQuatKey[pk.times.size()];
+			na->mPositionKeys = new aiVectorKey[pk.times.size()];
 		}
 		else {
 
@@ -2457,9 +2435,7 @@ private:
 			// to be set.
 			if(chain[TransformationComp_Scaling] != iter_end) {
 				ConvertScaleKeys(na, (*chain[TransformationComp_Scaling]).second, 
-					layer_map, 
-					max_time, 
-					min_time);
+					layer_map);
 			}
 			else {
 				na->mScalingKeys = new aiVectorKey[1];
@@ -2473,8 +2449,6 @@ private:
 			if(chain[TransformationComp_Rotation] != iter_end) {
 				ConvertRotationKeys(na, (*chain[TransformationComp_Rotation]).second, 
 					layer_map, 
-					max_time,
-					min_time,
 					target.RotationOrder());
 			}
 			else {
@@ -2489,9 +2463,7 @@ private:
 
 			if(chain[TransformationComp_Translation] != iter_end) {
 				ConvertTranslationKeys(na, (*chain[TransformationComp_Translation]).second, 
-					layer_map, 
-					max_time, 
-					min_time);
+					layer_map);
 			}
 			else {
 				na->mPositionKeys = new aiVectorKey[1];
@@ -2512,7 +2484,126 @@ private:
 	typedef boost::tuple< const KeyTimeList*, const KeyValueList*, unsigned int > KeyFrameList;
 	typedef std::vector<KeyFrameList> KeyFrameListList;
 
-	
+
+	/** Keys of a single aiNodeAnim which have been allocated, but not evaluated yet.
+	 *  The curves are collected while walking the FBX DOM, the actual interpolation
+	 *  is independent of the DOM and all other channels and thus runs in parallel,
+	 *  see ConvertAnimationStack(). */
+	struct PendingKeys
+	{
+		enum Type
+		{
+			Type_Scaling,
+			Type_Translation,
+			Type_Rotation,
+			Type_TRStoSRT
+		};
+
+		PendingKeys()
+			: type()
+			, na()
+			, order()
+			, inverse()
+			, min_time(1e10)
+			, max_time(-1e10)
+		{}
+
+		Type type;
+		aiNodeAnim* na;
+
+		KeyTimeList times;
+
+		// Type_Scaling, Type_Translation, Type_Rotation
+		KeyFrameListList inputs;
+
+		// Type_TRStoSRT
+		KeyFrameListList scaling, translation, rotation;
+		aiVector3D def_scale, def_translate;
+		aiQuaternion def_rotation;
+
+		Model::RotOrder order;
+		bool inverse;
+
+		// output
+		double min_time;
+		double max_time;
+	};
+
+
+	// ParallelFor() job to evaluate all pending keys
+	struct BakeKeysJob
+	{
+		explicit BakeKeysJob(Converter& conv) 
+			: conv(conv) 
+		{}
+
+		void operator()(size_t i) {
+			conv.BakeKeys(conv.pending_keys[i]);
+		}
+
+		Converter& conv;
+	};
+
+
+	// ------------------------------------------------------------------------------------------------
+	PendingKeys& AddPendingKeys(aiNodeAnim* na, PendingKeys::Type type, 
+		Model::RotOrder order = Model::RotOrder_EulerXYZ,
+		bool inverse = false)
+	{
+		pending_keys.push_back(PendingKeys());
+
+		PendingKeys& pk = pending_keys.back();
+		pk.type = type;
+		pk.na = na;
+		pk.order = order;
+		pk.inverse = inverse;
+		return pk;
+	}
+
+
+	// ------------------------------------------------------------------------------------------------
+	void BakeKeys(PendingKeys& pk)
+	{
+		aiNodeAnim* const na = pk.na;
+		switch(pk.type)
+		{
+		case PendingKeys::Type_Scaling:
+			InterpolateKeys(na->mScalingKeys, pk.times, pk.inputs, true, pk.max_time, pk.min_time);
+			break;
+
+		case PendingKeys::Type_Translation:
+			InterpolateKeys(na->mPositionKeys, pk.times, pk.inputs, false, pk.max_time, pk.min_time);
+
+			if (pk.inverse) {
+				for (unsigned int i = 0; i < na->mNumPositionKeys; ++i) {
+					na->mPositionKeys[i].mValue *= -1.0f;
+				}
+			}
+			break;
+
+		case PendingKeys::Type_Rotation:
+			InterpolateKeys(na->mRotationKeys, pk.times, pk.inputs, false, pk.max_time, pk.min_time, pk.order);
+			break;
+
+		case PendingKeys::Type_TRStoSRT:
+			ConvertTransformOrder_TRStoSRT(na->mRotationKeys, na->mScalingKeys, na->mPositionKeys, 
+				pk.scaling, 
+				pk.translation, 
+				pk.rotation, 
+				pk.times,
+				pk.max_time,
+				pk.min_time,
+				pk.order,
+				pk.def_scale,
+				pk.def_translate,
+				pk.def_rotation);
+			break;
+
+		default:
+			ai_assert(false);
+		}
+	}
+
 
 	// ------------------------------------------------------------------------------------------------
 	KeyFrameListList GetKeyframeList(const std::vector<const AnimationCurveNode*>& nodes)
@@ -2603,68 +2694,84 @@ private:
 
 
 	// ------------------------------------------------------------------------------------------------
-	void InterpolateKeys(aiVectorKey* valOut,const KeyTimeList& keys, const KeyFrameListList& inputs, 
-		const bool geom, 
-		double& max_time,
-		double& min_time)
-
+	// evaluate a single curve at the given key times and blend the results into out
+	void InterpolateCurve(float* out, const KeyTimeList& keys, const KeyFrameList& kfl, 
+		const bool geom)
 	{
-		ai_assert(keys.size());
-		ai_assert(valOut);
+		const size_t ksize = kfl.get<0>()->size();
+		ai_assert(ksize && kfl.get<1>()->size() == ksize);
 
-		std::vector<unsigned int> next_pos;
-		const size_t count = inputs.size();
+		const KeyTimeList::value_type* const times = &kfl.get<0>()->front();
+		const KeyValueList::value_type* const values = &kfl.get<1>()->front();
 
-		next_pos.resize(inputs.size(),0);
+		size_t next_pos = 0;
+		for (size_t i = 0, c = keys.size(); i < c; ++i) {
+			const KeyTimeList::value_type time = keys[i];
 
-		BOOST_FOREACH(KeyTimeList::value_type time, keys) {
-			float result[3] = {0.0f, 0.0f, 0.0f};
-			if(geom) {
-				result[0] = result[1] = result[2] = 1.0f;
+			if (ksize > next_pos && times[next_pos] == time) {
+				++next_pos; 
 			}
 
-			for (size_t i = 0; i < count; ++i) {
-				const KeyFrameList& kfl = inputs[i];
+			const size_t id0 = next_pos>0 ? next_pos-1 : 0;
+			const size_t id1 = next_pos==ksize ? ksize-1 : next_pos;
 
-				const size_t ksize = kfl.get<0>()->size();
-				if (ksize > next_pos[i] && kfl.get<0>()->at(next_pos[i]) == time) {
-					++next_pos[i]; 
-				}
+			// use lerp for interpolation
+			const KeyValueList::value_type valueA = values[id0];
+			const KeyValueList::value_type valueB = values[id1];
 
-				const size_t id0 = next_pos[i]>0 ? next_pos[i]-1 : 0;
-				const size_t id1 = next_pos[i]==ksize ? ksize-1 : next_pos[i];
+			const KeyTimeList::value_type timeA = times[id0];
+			const KeyTimeList::value_type timeB = times[id1];
 
-				// use lerp for interpolation
-				const KeyValueList::value_type valueA = kfl.get<1>()->at(id0);
-				const KeyValueList::value_type valueB = kfl.get<1>()->at(id1);
+			// do the actual interpolation in double-precision arithmetics
+			// because it is a bit sensitive to rounding errors.
+			const double factor = timeB == timeA ? 0. : static_cast<double>((time - timeA) / (timeB - timeA));
+			const float interpValue = static_cast<float>(valueA + (valueB - valueA) * factor);
 
-				const KeyTimeList::value_type timeA = kfl.get<0>()->at(id0);
-				const KeyTimeList::value_type timeB = kfl.get<0>()->at(id1);
+			if(geom) {
+				out[i] *= interpValue;
+			}
+			else {
+				out[i] += interpValue;
+			}
+		}
+	}
 
-				// do the actual interpolation in double-precision arithmetics
-				// because it is a bit sensitive to rounding errors.
-				const double factor = timeB == timeA ? 0. : static_cast<double>((time - timeA) / (timeB - timeA));
-				const float interpValue = static_cast<float>(valueA + (valueB - valueA) * factor);
 
-				if(geom) {
-					result[kfl.get<2>()] *= interpValue;
-				}
-				else {
-					result[kfl.get<2>()] += interpValue;
-				}
-			}
+	// ------------------------------------------------------------------------------------------------
+	void InterpolateKeys(aiVectorKey* valOut,const KeyTimeList& keys, const KeyFrameListList& inputs, 
+		const bool geom, 
+		double& max_time,
+		double& min_time)
+
+	{
+		ai_assert(keys.size());
+		ai_assert(valOut);
+
+		// evaluate curve by curve into one contiguous array per component. The
+		// curves are applied in the same order for every key, so the results
+		// are exactly those of a key by key evaluation.
+		const size_t count = keys.size();
+		std::vector<float> result(count * 3, geom ? 1.0f : 0.0f);
 
+		BOOST_FOREACH(const KeyFrameList& kfl, inputs) {
+			ai_assert(kfl.get<2>() < 3);
+			InterpolateCurve(&result[kfl.get<2>() * count], keys, kfl, geom);
+		}
+
+		const float* const x = &result[0];
+		const float* const y = x + count;
+		const float* const z = y + count;
+
+		for (size_t i = 0; i < count; ++i) {
 			// magic value to convert fbx times to seconds
-			valOut->mTime = CONVERT_FBX_TIME(time) * anim_fps;
+			valOut[i].mTime = CONVERT_FBX_TIME(keys[i]) * anim_fps;
 
-			min_time = std::min(min_time, valOut->mTime);
-			max_time = std::max(max_time, valOut->mTime);
+			min_time = std::min(min_time, valOut[i].mTime);
+			max_time = std::max(max_time, valOut[i].mTime);
 
-			valOut->mValue.x = result[0];
-			valOut->mValue.y = result[1];
-			valOut->mValue.z = result[2];
-			
-			++valOut;
+			valOut[i].mValue.x = x[i];
+			valOut[i].mValue.y = y[i];
+			valOut[i].mValue.z = z[i];
 		}
 	}
 
@@ -2782,9 +2889,9 @@ private:
 
 
 	// ------------------------------------------------------------------------------------------------
-	void ConvertScaleKeys(aiNodeAnim* na, const std::vector<const AnimationCurveNode*>& nodes, const LayerMap& layers,
-		double& maxTime,
-		double& minTime)
+	// note: the Convert*Keys() functions only allocate the output keys, they
+	// are evaluated later by BakeKeys().
+	void ConvertScaleKeys(aiNodeAnim* na, const std::vector<const AnimationCurveNode*>& nodes, const LayerMap& layers)
 	{
 		ai_assert(nodes.size());
 
@@ -2792,49 +2899,46 @@ private:
 		// layers should be multiplied with each other). There is a FBX 
 		// property in the layer to specify the behaviour, though.
 
-		const KeyFrameListList& inputs = GetKeyframeList(nodes);
-		const KeyTimeList& keys = GetKeyTimeList(inputs);
+		PendingKeys& pk = AddPendingKeys(na, PendingKeys::Type_Scaling);
+		pk.inputs = GetKeyframeList(nodes);
+		pk.times = GetKeyTimeList(pk.inputs);
 
-		na->mNumScalingKeys = static_cast<unsigned int>(keys.size());
-		na->mScalingKeys = new aiVectorKey[keys.size()];
-		InterpolateKeys(na->mScalingKeys, keys, inputs, true, maxTime, minTime);
+		na->mNumScalingKeys = static_cast<unsigned int>(pk.times.size());
+		na->mScalingKeys = new aiVectorKey[pk.times.size()];
 	}
 
 
 	// ------------------------------------------------------------------------------------------------
 	void ConvertTranslationKeys(aiNodeAnim* na, const std::vector<const AnimationCurveNode*>& nodes, 
 		const LayerMap& layers,
-		double& maxTime,
-		double& minTime)
+		bool inverse = false)
 	{
 		ai_assert(nodes.size());
 
 		// XXX see notes in ConvertScaleKeys()
-		const KeyFrameListList& inputs = GetKeyframeList(nodes);
-		const KeyTimeList& keys = GetKeyTimeList(inputs);
+		PendingKeys& pk = AddPendingKeys(na, PendingKeys::Type_Translation, Model::RotOrder_EulerXYZ, inverse);
+		pk.inputs = GetKeyframeList(nodes);
+		pk.times = GetKeyTimeList(pk.inputs);
 
-		na->mNumPositionKeys = static_cast<unsigned int>(keys.size());
-		na->mPositionKeys = new aiVectorKey[keys.size()];
-		InterpolateKeys(na->mPositionKeys, keys, inputs, false, maxTime, minTime);
+		na->mNumPositionKeys = static_cast<unsigned int>(pk.times.size());
+		na->mPositionKeys = new aiVectorKey[pk.times.size()];
 	}
 
 
 	// ------------------------------------------------------------------------------------------------
 	void ConvertRotationKeys(aiNodeAnim* na, const std::vector<const AnimationCurveNode*>& nodes, 
 		const LayerMap& layers, 
-		double& maxTime,
-		double& minTime,
 		Model::RotOrder order)
 	{
 		ai_assert(nodes.size());
 
 		// XXX see notes in ConvertScaleKeys()
-		const std::vector< KeyFrameList >& inputs = GetKeyframeList(nodes);
-		const KeyTimeList& keys = GetKeyTimeList(inputs);
+		PendingKeys& pk = AddPendingKeys(na, PendingKeys::Type_Rotation, order);
+		pk.inputs = GetKeyframeList(nodes);
+		pk.times = GetKeyTimeList(pk.inputs);
 
-		na->mNumRotationKeys = static_cast<unsigned int>(keys.size());
-		na->mRotationKeys = new aiQuatKey[keys.size()];
-		InterpolateKeys(na->mRotationKeys, keys, inputs, false, maxTime, minTime, order);
+		na->mNumRotationKeys = static_cast<unsigned int>(pk.times.size());
+		na->mRotationKeys = new aiQuatKey[pk.times.size()];
 	}
 
 
@@ -2913,6 +3017,9 @@ private:
 	typedef std::map<std::string, std::string> NameNameMap;
 	NameNameMap renamed_nodes;
 
+	// keys to be evaluated for the animation stack being converted
+	std::deque<PendingKeys> pending_keys;
+
 	double anim_fps;
 
 	aiScene* const out;
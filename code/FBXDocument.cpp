@@ -46,6 +46,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef ASSIMP_BUILD_NO_FBX_IMPORTER
 
 #include <functional>
+#include <numeric>
 
 #include "FBXParser.h"
 #include "FBXDocument.h"
@@ -55,17 +56,39 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "FBXDocumentUtil.h"
 #include "FBXProperties.h"
 
+#include "ParallelFor.h"
+
 namespace Assimp {
 namespace FBX {
 
 using namespace Util;
 
+namespace {
+
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+	// thrown if an object being prefetched references an object that is not available yet.
+	// Intentionally not derived from std::exception so it is not swallowed by DOM code.
+	struct DeferredConstruction {};
+
+	// ParallelFor() job to construct a set of independent objects
+	struct PrefetchObjectsJob
+	{
+		void operator()(size_t i) {
+			objects[i]->Prefetch();
+		}
+
+		std::vector<LazyObject*> objects;
+	};
+#endif
+}
+
 // ------------------------------------------------------------------------------------------------
 LazyObject::LazyObject(uint64_t id, const Element& element, const Document& doc)
 : doc(doc)
 , element(element)
 , id(id)
 , flags()
+, classId()
 {
 
 }
@@ -83,6 +106,18 @@ const Object* LazyObject::Get(bool dieOnError)
 		return NULL;
 	}
 
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+	if (doc.IsPrefetching()) {
+		// we're being resolved by another object that is prefetched on a worker thread.
+		// Only hand out objects that are complete, defer everything else to the converter.
+		boost::mutex::scoped_lock lock(doc.PrefetchMutex());
+		if (!object.get()) {
+			throw DeferredConstruction();
+		}
+		return object.get();
+	}
+#endif
+
 	if (object.get()) {
 		return object.get();
 	}
@@ -95,7 +130,63 @@ const Object* LazyObject::Get(bool dieOnError)
 		return object.get();
 	}
 
-	const Token& key = element.KeyToken();
+	std::string name, classtag;
+	ReadNameAndClassTag(name, classtag);
+
+	// prevent recursive calls
+	flags |= BEING_CONSTRUCTED;
+
+	try {
+		object.reset(CreateObject(name, classtag));
+	}
+	catch(std::exception& ex) {
+		flags &= ~BEING_CONSTRUCTED;
+		flags |= FAILED_TO_CONSTRUCT;
+
+		if(dieOnError || doc.Settings().strictMode) {
+			throw;
+		}
+
+		// note: the error message is already formatted, so raw logging is ok
+		if(!DefaultLogger::isNullLogger()) {
+			DefaultLogger::get()->error(ex.what());
+		}
+		return NULL;
+	}
+
+	if (!object.get()) {
+		//DOMError("failed to convert element to DOM object, class: " + classtag + ", name: " + name,&element);
+	}
+
+	flags &= ~BEING_CONSTRUCTED;
+	return object.get();
+}
+
+
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+// ------------------------------------------------------------------------------------------------
+void LazyObject::Prefetch()
+{
+	ai_assert(doc.IsPrefetching() && id != 0L);
+	try {
+		std::string name, classtag;
+		ReadNameAndClassTag(name, classtag);
+
+		const Object* const ob = CreateObject(name, classtag);
+
+		boost::mutex::scoped_lock lock(doc.PrefetchMutex());
+		object.reset(ob);
+	}
+	catch(...) {
+		// leave it to Get() to try again and report the error, if the object is needed at all
+	}
+}
+#endif
+
+
+// ------------------------------------------------------------------------------------------------
+void LazyObject::ReadNameAndClassTag(std::string& name, std::string& classtag) const
+{
 	const TokenList& tokens = element.Tokens();
 
 	if(tokens.size() < 3) {
@@ -103,7 +194,7 @@ const Object* LazyObject::Get(bool dieOnError)
 	}
 
 	const char* err;
-	std::string name = ParseTokenAsString(*tokens[1],err);
+	name = ParseTokenAsString(*tokens[1],err);
 	if (err) {
 		DOMError(err,&element);
 	} 
@@ -121,99 +212,80 @@ const Object* LazyObject::Get(bool dieOnError)
 		}
 	}
 
-	const std::string classtag = ParseTokenAsString(*tokens[2],err);
+	classtag = ParseTokenAsString(*tokens[2],err);
 	if (err) {
 		DOMError(err,&element);
 	} 
+}
 
-	// prevent recursive calls
-	flags |= BEING_CONSTRUCTED;
 
-	try {
-		// this needs to be relatively fast since it happens a lot,
-		// so avoid constructing strings all the time.
-		const char* obtype = key.begin();
-		const size_t length = static_cast<size_t>(key.end()-key.begin());
-		if (!strncmp(obtype,"Geometry",length)) {
-			if (!strcmp(classtag.c_str(),"Mesh")) {
-				object.reset(new MeshGeometry(id,element,name,doc));
-			}
-		}
-		else if (!strncmp(obtype,"NodeAttribute",length)) {
-			if (!strcmp(classtag.c_str(),"Camera")) {
-				object.reset(new Camera(id,element,doc,name));
-			}
-			else if (!strcmp(classtag.c_str(),"CameraSwitcher")) {
-				object.reset(new CameraSwitcher(id,element,doc,name));
-			}
-			else if (!strcmp(classtag.c_str(),"Light")) {
-				object.reset(new Light(id,element,doc,name));
-			}
-			else if (!strcmp(classtag.c_str(),"Null")) {
-				object.reset(new Null(id,element,doc,name));
-			}
-			else if (!strcmp(classtag.c_str(),"LimbNode")) {
-				object.reset(new LimbNode(id,element,doc,name));
-			}
-		}
-		else if (!strncmp(obtype,"Deformer",length)) {
-			if (!strcmp(classtag.c_str(),"Cluster")) {
-				object.reset(new Cluster(id,element,doc,name));
-			}
-			else if (!strcmp(classtag.c_str(),"Skin")) {
-				object.reset(new Skin(id,element,doc,name));
-			}
+// ------------------------------------------------------------------------------------------------
+const Object* LazyObject::CreateObject(const std::string& name, const std::string& classtag) const
+{
+	// this needs to be relatively fast since it happens a lot,
+	// so avoid constructing strings all the time.
+	const Token& key = element.KeyToken();
+	const char* obtype = key.begin();
+	const size_t length = static_cast<size_t>(key.end()-key.begin());
+	if (!strncmp(obtype,"Geometry",length)) {
+		if (!strcmp(classtag.c_str(),"Mesh")) {
+			return new MeshGeometry(id,element,name,doc);
 		}
-		else if (!strncmp(obtype,"Model",length)) {
-			// FK and IK effectors are not supported
-			if (strcmp(classtag.c_str(),"IKEffector") && strcmp(classtag.c_str(),"FKEffector")) {
-				object.reset(new Model(id,element,doc,name));
-			}
+	}
+	else if (!strncmp(obtype,"NodeAttribute",length)) {
+		if (!strcmp(classtag.c_str(),"Camera")) {
+			return new Camera(id,element,doc,name);
 		}
-		else if (!strncmp(obtype,"Material",length)) {
-			object.reset(new Material(id,element,doc,name));
+		else if (!strcmp(classtag.c_str(),"CameraSwitcher")) {
+			return new CameraSwitcher(id,element,doc,name);
 		}
-		else if (!strncmp(obtype,"Texture",length)) {
-			object.reset(new Texture(id,element,doc,name));
+		else if (!strcmp(classtag.c_str(),"Light")) {
+			return new Light(id,element,doc,name);
 		}
-		else if (!strncmp(obtype,"LayeredTexture",length)) {
-			object.reset(new LayeredTexture(id,element,doc,name));
+		else if (!strcmp(classtag.c_str(),"Null")) {
+			return new Null(id,element,doc,name);
 		}
-		else if (!strncmp(obtype,"AnimationStack",length)) {
-			object.reset(new AnimationStack(id,element,name,doc));
+		else if (!strcmp(classtag.c_str(),"LimbNode")) {
+			return new LimbNode(id,element,doc,name);
 		}
-		else if (!strncmp(obtype,"AnimationLayer",length)) {
-			object.reset(new AnimationLayer(id,element,name,doc));
+	}
+	else if (!strncmp(obtype,"Deformer",length)) {
+		if (!strcmp(classtag.c_str(),"Cluster")) {
+			return new Cluster(id,element,doc,name);
 		}
-		// note: order matters for these two
-		else if (!strncmp(obtype,"AnimationCurve",length)) {
-			object.reset(new AnimationCurve(id,element,name,doc));
+		else if (!strcmp(classtag.c_str(),"Skin")) {
+			return new Skin(id,element,doc,name);
 		}
-		else if (!strncmp(obtype,"AnimationCurveNode",length)) {
-			object.reset(new AnimationCurveNode(id,element,name,doc));
-		}	
 	}
-	catch(std::exception& ex) {
-		flags &= ~BEING_CONSTRUCTED;
-		flags |= FAILED_TO_CONSTRUCT;
-
-		if(dieOnError || doc.Settings().strictMode) {
-			throw;
+	else if (!strncmp(obtype,"Model",length)) {
+		// FK and IK effectors are not supported
+		if (strcmp(classtag.c_str(),"IKEffector") && strcmp(classtag.c_str(),"FKEffector")) {
+			return new Model(id,element,doc,name);
 		}
-
-		// note: the error message is already formatted, so raw logging is ok
-		if(!DefaultLogger::isNullLogger()) {
-			DefaultLogger::get()->error(ex.what());
-		}
-		return NULL;
 	}
-
-	if (!object.get()) {
-		//DOMError("failed to convert element to DOM object, class: " + classtag + ", name: " + name,&element);
+	else if (!strncmp(obtype,"Material",length)) {
+		return new Material(id,element,doc,name);
 	}
-
-	flags &= ~BEING_CONSTRUCTED;
-	return object.get();
+	else if (!strncmp(obtype,"Texture",length)) {
+		return new Texture(id,element,doc,name);
+	}
+	else if (!strncmp(obtype,"LayeredTexture",length)) {
+		return new LayeredTexture(id,element,doc,name);
+	}
+	else if (!strncmp(obtype,"AnimationStack",length)) {
+		return new AnimationStack(id,element,name,doc);
+	}
+	else if (!strncmp(obtype,"AnimationLayer",length)) {
+		return new AnimationLayer(id,element,name,doc);
+	}
+	// note: order matters for these two
+	else if (!strncmp(obtype,"AnimationCurve",length)) {
+		return new AnimationCurve(id,element,name,doc);
+	}
+	else if (!strncmp(obtype,"AnimationCurveNode",length)) {
+		return new AnimationCurveNode(id,element,name,doc);
+	}	
+	return NULL;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -252,6 +324,9 @@ FileGlobalSettings::~FileGlobalSettings()
 Document::Document(const Parser& parser, const ImportSettings& settings)
 : settings(settings)
 , parser(parser)
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+, prefetching()
+#endif
 {
 	// cannot use array default initialization syntax because vc8 fails on it
 	for (unsigned int i = 0; i < 7; ++i) {
@@ -268,6 +343,8 @@ Document::Document(const Parser& parser, const ImportSettings& settings)
 	// though, since this may require valid connections.
 	ReadObjects();
 	ReadConnections();
+
+	PrefetchObjects();
 }
 
 
@@ -277,6 +354,10 @@ Document::~Document()
 	BOOST_FOREACH(ObjectMap::value_type& v, objects) {
 		delete v.second;
 	}
+
+	BOOST_FOREACH(const Connection* c, connections) {
+		delete c;
+	}
 }
 
 
@@ -363,6 +444,7 @@ void Document::ReadObjects()
 	// add a dummy entry to represent the Model::RootNode object (id 0),
 	// which is only indirectly defined in the input file
 	objects[0] = new LazyObject(0L, *eobjects, *this);
+	objects[0]->classId = InternClass("Objects");
 
 	const Scope& sobjects = *eobjects->Compound();
 	BOOST_FOREACH(const ElementMap::value_type& el, sobjects.Elements()) {
@@ -390,7 +472,9 @@ void Document::ReadObjects()
 			DOMWarning("encountered duplicate object id, ignoring first occurrence",el.second);
 		}
 
-		objects[id] = new LazyObject(id, *el.second, *this);
+		LazyObject* const lazy = new LazyObject(id, *el.second, *this);
+		lazy->classId = InternClass(el.first);
+		objects[id] = lazy;
 
 		// grab all animation stacks upfront since there is no listing of them
 		if(!strcmp(el.first.c_str(),"AnimationStack")) {
@@ -400,6 +484,45 @@ void Document::ReadObjects()
 }
 
 
+// ------------------------------------------------------------------------------------------------
+void Document::PrefetchObjects()
+{
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+	// Mesh geometry and animation curves hold the bulk of the data in a file and do not depend
+	// on each other, so construct them upfront on all cores. Only objects which do not resolve
+	// links to other objects are picked, so the result is exactly the same as if the converter
+	// had constructed them on demand.
+	PrefetchObjectsJob job;
+	BOOST_FOREACH(const ObjectMap::value_type& v, objects) {
+		if (v.first == 0L) {
+			continue;
+		}
+
+		const Token& key = v.second->GetElement().KeyToken();
+		const size_t length = static_cast<size_t>(key.end()-key.begin());
+
+		if (length == 8 && !strncmp(key.begin(),"Geometry",length)) {
+			// geometry with a skin deformer attached resolves the entire skeleton
+			if (GetConnectionsByDestinationSequenced(v.first,"Deformer").empty()) {
+				job.objects.push_back(v.second);
+			}
+		}
+		else if (length == 14 && !strncmp(key.begin(),"AnimationCurve",length) && settings.readAnimations) {
+			job.objects.push_back(v.second);
+		}
+	}
+
+	if (job.objects.size() < 2) {
+		return;
+	}
+
+	prefetching = true;
+	ParallelFor(job.objects.size(), job);
+	prefetching = false;
+#endif
+}
+
+
 // ------------------------------------------------------------------------------------------------
 void Document::ReadPropertyTemplates()
 {
@@ -496,10 +619,11 @@ void Document::ReadConnections()
 		}
 
 		// add new connection
-		const Connection* const c = new Connection(insertionOrder++,src,dest,prop,*this);
-		src_connections.insert(ConnectionMap::value_type(src,c));  
-		dest_connections.insert(ConnectionMap::value_type(dest,c));  
+		connections.push_back(new Connection(insertionOrder++,src,dest,prop,*this));
 	}
+
+	BuildConnectionIndex(src_connections, true);
+	BuildConnectionIndex(dest_connections, false);
 }
 
 
@@ -532,89 +656,103 @@ LazyObject* Document::GetObject(uint64_t id) const
 	return it == objects.end() ? NULL : (*it).second;
 }
 
-#define MAX_CLASSNAMES 6
+// ------------------------------------------------------------------------------------------------
+unsigned int Document::InternClass(const std::string& name)
+{
+	return (*classIds.insert(std::make_pair(name, static_cast<unsigned int>(classIds.size()))).first).second;
+}
+
 
 // ------------------------------------------------------------------------------------------------
-std::vector<const Connection*> Document::GetConnectionsSequenced(uint64_t id, 
-	const ConnectionMap& conns) const
+void Document::BuildConnectionIndex(ConnectionIndex& index, bool is_src)
 {
-	std::vector<const Connection*> temp;
+	index.ids.reserve(connections.size());
+	BOOST_FOREACH(const Connection* c, connections) {
+		index.ids.push_back(is_src ? c->src : c->dest);
+	}
 
-	const std::pair<ConnectionMap::const_iterator,ConnectionMap::const_iterator> range = 
-		conns.equal_range(id);
+	std::sort(index.ids.begin(), index.ids.end());
+	index.ids.erase(std::unique(index.ids.begin(), index.ids.end()), index.ids.end());
 
-	temp.reserve(std::distance(range.first,range.second));
-	for (ConnectionMap::const_iterator it = range.first; it != range.second; ++it) {
-		temp.push_back((*it).second);
+	// count the connections per id, then place them in insertion order
+	std::vector<unsigned int> slots(connections.size());
+	index.offsets.assign(index.ids.size() + 1, 0);
+	for (size_t i = 0; i < connections.size(); ++i) {
+		const uint64_t id = is_src ? connections[i]->src : connections[i]->dest;
+		slots[i] = static_cast<unsigned int>(std::lower_bound(index.ids.begin(), index.ids.end(), id) - index.ids.begin());
+		++index.offsets[slots[i] + 1];
 	}
 
-	std::sort(temp.begin(), temp.end(), std::mem_fun(&Connection::Compare));
+	std::partial_sum(index.offsets.begin(), index.offsets.end(), index.offsets.begin());
 
-	return temp; // NRVO should handle this
+	std::vector<unsigned int> cursor(index.offsets.begin(), index.offsets.end() - 1);
+	index.entries.resize(connections.size());
+	for (size_t i = 0; i < connections.size(); ++i) {
+		const Connection* const c = connections[i];
+
+		ConnectionList::Entry& e = index.entries[cursor[slots[i]]++];
+		e.connection = c;
+		e.classId = (is_src ? c->LazyDestinationObject() : c->LazySourceObject()).ClassId();
+	}
 }
 
 
 // ------------------------------------------------------------------------------------------------
-std::vector<const Connection*> Document::GetConnectionsSequenced(uint64_t id, bool is_src, 
-	const ConnectionMap& conns, 
-	const char* const* classnames, 
-	size_t count) const
-
+ConnectionList Document::GetConnectionsSequenced(uint64_t id, const ConnectionIndex& index, 
+	const unsigned int* classes /*= NULL*/, 
+	size_t num_classes /*= 0*/) const
 {
-	ai_assert(classnames);
-	ai_assert(count != 0 && count <= MAX_CLASSNAMES);
-
-	size_t lenghts[MAX_CLASSNAMES];
-
-	const size_t c = count;
-	for (size_t i = 0; i < c; ++i) {
-		lenghts[i] = strlen(classnames[i]);
+	const std::vector<uint64_t>::const_iterator it = std::lower_bound(index.ids.begin(), index.ids.end(), id);
+	if (it == index.ids.end() || *it != id) {
+		return ConnectionList();
 	}
 
-	std::vector<const Connection*> temp;
+	const size_t i = std::distance(index.ids.begin(), it);
+	const ConnectionList::Entry* const entries = &index.entries[0];
+	return ConnectionList(entries + index.offsets[i], entries + index.offsets[i+1], classes, num_classes);
+}
+
 
-	const std::pair<ConnectionMap::const_iterator,ConnectionMap::const_iterator> range = 
-		conns.equal_range(id);
+// ------------------------------------------------------------------------------------------------
+ConnectionList Document::GetConnectionsSequenced(uint64_t id, 
+	const ConnectionIndex& index, 
+	const char* const* classnames, 
+	size_t count) const
 
-	temp.reserve(std::distance(range.first,range.second));
-	for (ConnectionMap::const_iterator it = range.first; it != range.second; ++it) {
-		const Token& key = (is_src 
-			? (*it).second->LazyDestinationObject()
-			: (*it).second->LazySourceObject()
-		).GetElement().KeyToken();
+{
+	ai_assert(classnames);
+	ai_assert(count != 0 && count <= ConnectionList::MAX_CLASSES);
 
-		const char* obtype = key.begin();
+	unsigned int classes[ConnectionList::MAX_CLASSES];
+	size_t num_classes = 0;
 
-		for (size_t i = 0; i < c; ++i) {
-			ai_assert(classnames[i]);
-			if(static_cast<size_t>(std::distance(key.begin(),key.end())) == lenghts[i] && !strncmp(classnames[i],obtype,lenghts[i])) {
-				obtype = NULL;
-				break;
-			}
-		}
+	for (size_t i = 0; i < count; ++i) {
+		ai_assert(classnames[i]);
 
-		if(obtype) {
-			continue;
+		const std::map<std::string, unsigned int>::const_iterator it = classIds.find(classnames[i]);
+		if (it != classIds.end()) {
+			classes[num_classes++] = (*it).second;
 		}
-
-		temp.push_back((*it).second);
 	}
 
-	std::sort(temp.begin(), temp.end(), std::mem_fun(&Connection::Compare));
-	return temp; // NRVO should handle this
+	// no object in the file is of any of these classes
+	if (!num_classes) {
+		return ConnectionList();
+	}
+	return GetConnectionsSequenced(id, index, classes, num_classes);
 }
 
 
 // ------------------------------------------------------------------------------------------------
-std::vector<const Connection*> Document::GetConnectionsBySourceSequenced(uint64_t source) const
+ConnectionList Document::GetConnectionsBySourceSequenced(uint64_t source) const
 {
-	return GetConnectionsSequenced(source, ConnectionsBySource());
+	return GetConnectionsSequenced(source, src_connections);
 }
 
 
 
 // ------------------------------------------------------------------------------------------------
-std::vector<const Connection*> Document::GetConnectionsBySourceSequenced(uint64_t dest, 
+ConnectionList Document::GetConnectionsBySourceSequenced(uint64_t dest, 
 	const char* classname) const
 {
 	const char* arr[] = {classname};
@@ -624,15 +762,15 @@ std::vector<const Connection*> Document::GetConnectionsBySourceSequenced(uint64_
 
 
 // ------------------------------------------------------------------------------------------------
-std::vector<const Connection*> Document::GetConnectionsBySourceSequenced(uint64_t source, 
+ConnectionList Document::GetConnectionsBySourceSequenced(uint64_t source, 
 	const char* const* classnames, size_t count) const
 {
-	return GetConnectionsSequenced(source, true, ConnectionsBySource(),classnames, count);
+	return GetConnectionsSequenced(source, src_connections, classnames, count);
 }
 
 
 // ------------------------------------------------------------------------------------------------
-std::vector<const Connection*> Document::GetConnectionsByDestinationSequenced(uint64_t dest, 
+ConnectionList Document::GetConnectionsByDestinationSequenced(uint64_t dest, 
 	const char* classname) const
 {
 	const char* arr[] = {classname};
@@ -641,18 +779,18 @@ std::vector<const Connection*> Document::GetConnectionsByDestinationSequenced(ui
 
 
 // ------------------------------------------------------------------------------------------------
-std::vector<const Connection*> Document::GetConnectionsByDestinationSequenced(uint64_t dest) const
+ConnectionList Document::GetConnectionsByDestinationSequenced(uint64_t dest) const
 {
-	return GetConnectionsSequenced(dest, ConnectionsByDestination());
+	return GetConnectionsSequenced(dest, dest_connections);
 }
 
 
 // ------------------------------------------------------------------------------------------------
-std::vector<const Connection*> Document::GetConnectionsByDestinationSequenced(uint64_t dest, 
+ConnectionList Document::GetConnectionsByDestinationSequenced(uint64_t dest, 
 	const char* const* classnames, size_t count) const
 
 {
-	return GetConnectionsSequenced(dest, false, ConnectionsByDestination(),classnames, count);
+	return GetConnectionsSequenced(dest, dest_connections, classnames, count);
 }
 
 
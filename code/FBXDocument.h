@@ -48,6 +48,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <map>
 #include <string>
 
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+#	include <boost/thread/mutex.hpp>
+#endif
+
 #include "FBXProperties.h"
 
 namespace Assimp {
@@ -111,6 +115,21 @@ public:
 		return doc;
 	}
 
+	// interned class name (i.e. element key) of the object, see Document::ReadObjects()
+	unsigned int ClassId() const {
+		return classId;
+	}
+
+private:
+
+	friend class Document;
+
+	// construct the object on a worker thread, see Document::PrefetchObjects()
+	void Prefetch();
+
+	void ReadNameAndClassTag(std::string& name, std::string& classtag) const;
+	const Object* CreateObject(const std::string& name, const std::string& classtag) const;
+
 private:
 
 	const Document& doc;
@@ -125,6 +144,7 @@ private:
 	};
 
 	unsigned int flags;
+	unsigned int classId;
 };
 
 
@@ -1203,7 +1223,134 @@ public:
 	typedef std::fbx_unordered_map<std::string, boost::shared_ptr<const PropertyTable> > PropertyTemplateMap;
 
 
-	typedef std::multimap<uint64_t, const Connection*> ConnectionMap;
+/** Range of the connections of an object, as returned by Document::GetConnectionsBySourceSequenced()
+ *  and Document::GetConnectionsByDestinationSequenced(). This is a lightweight view into the
+ *  document's connection index, ordered by insertion order and optionally filtered by the class
+ *  of the objects at the other end of the connections. */
+class ConnectionList
+{
+public:
+
+	static const size_t MAX_CLASSES = 6;
+
+	// entry in the document's connection index
+	struct Entry
+	{
+		const Connection* connection;
+
+		// class of the object at the other end of the connection
+		unsigned int classId;
+	};
+
+	class const_iterator
+	{
+	public:
+
+		typedef std::forward_iterator_tag iterator_category;
+		typedef const Connection* value_type;
+		typedef ptrdiff_t difference_type;
+		typedef const Connection* const* pointer;
+		typedef const Connection* const& reference;
+
+		const_iterator(const Entry* cur, const ConnectionList& list)
+			: cur(cur), list(&list) 
+		{}
+
+		reference operator*() const {
+			return cur->connection;
+		}
+
+		const_iterator& operator++() {
+			cur = list->Skip(cur + 1);
+			return *this;
+		}
+
+		const_iterator operator++(int) {
+			const const_iterator tmp = *this;
+			++*this;
+			return tmp;
+		}
+
+		bool operator== (const const_iterator& other) const {
+			return cur == other.cur;
+		}
+
+		bool operator!= (const const_iterator& other) const {
+			return cur != other.cur;
+		}
+
+	private:
+		const Entry* cur;
+		const ConnectionList* list;
+	};
+
+	typedef const_iterator iterator;
+	typedef const Connection* value_type;
+	typedef const Connection* const& reference;
+	typedef const Connection* const& const_reference;
+
+public:
+
+	ConnectionList()
+		: first(), last(), numClasses()
+	{}
+
+	ConnectionList(const Entry* first, const Entry* last, const unsigned int* classIds = NULL, size_t numClasses = 0)
+		: first(first), last(last), numClasses(numClasses)
+	{
+		ai_assert(numClasses <= MAX_CLASSES);
+		std::copy(classIds, classIds + numClasses, this->classIds);
+	}
+
+public:
+
+	const_iterator begin() const {
+		return const_iterator(Skip(first), *this);
+	}
+
+	const_iterator end() const {
+		return const_iterator(last, *this);
+	}
+
+	bool empty() const {
+		return Skip(first) == last;
+	}
+
+	size_t size() const {
+		if (!numClasses) {
+			return static_cast<size_t>(last - first);
+		}
+		size_t count = 0;
+		for (const_iterator it = begin(); it != end(); ++it) {
+			++count;
+		}
+		return count;
+	}
+
+private:
+
+	// advance to the next entry that passes the class filter
+	const Entry* Skip(const Entry* e) const {
+		if (numClasses) {
+			for (; e != last; ++e) {
+				for (size_t i = 0; i < numClasses; ++i) {
+					if (e->classId == classIds[i]) {
+						return e;
+					}
+				}
+			}
+		}
+		return e;
+	}
+
+private:
+
+	const Entry* first;
+	const Entry* last;
+
+	unsigned int classIds[MAX_CLASSES];
+	size_t numClasses;
+};
 
 
 /** DOM class for global document settings, a single instance per document can
@@ -1322,39 +1469,59 @@ public:
 		return settings;
 	}
 
-	const ConnectionMap& ConnectionsBySource() const {
-		return src_connections;
-	}
-
-	const ConnectionMap& ConnectionsByDestination() const {
-		return dest_connections;
-	}
-
 	// note: the implicit rule in all DOM classes is to always resolve
 	// from destination to source (since the FBX object hierarchy is,
 	// with very few exceptions, a DAG, this avoids cycles). In all
 	// cases that may involve back-facing edges in the object graph,
 	// use LazyObject::IsBeingConstructed() to check.
 
-	std::vector<const Connection*> GetConnectionsBySourceSequenced(uint64_t source) const;
-	std::vector<const Connection*> GetConnectionsByDestinationSequenced(uint64_t dest) const;
+	ConnectionList GetConnectionsBySourceSequenced(uint64_t source) const;
+	ConnectionList GetConnectionsByDestinationSequenced(uint64_t dest) const;
 
-	std::vector<const Connection*> GetConnectionsBySourceSequenced(uint64_t source, const char* classname) const;
-	std::vector<const Connection*> GetConnectionsByDestinationSequenced(uint64_t dest, const char* classname) const;
+	ConnectionList GetConnectionsBySourceSequenced(uint64_t source, const char* classname) const;
+	ConnectionList GetConnectionsByDestinationSequenced(uint64_t dest, const char* classname) const;
 
-	std::vector<const Connection*> GetConnectionsBySourceSequenced(uint64_t source, 
+	ConnectionList GetConnectionsBySourceSequenced(uint64_t source, 
 		const char* const* classnames, size_t count) const;
-	std::vector<const Connection*> GetConnectionsByDestinationSequenced(uint64_t dest, 
+	ConnectionList GetConnectionsByDestinationSequenced(uint64_t dest, 
 		const char* const* classnames, 
 		size_t count) const;
 
 	const std::vector<const AnimationStack*>& AnimationStacks() const;
 
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+	// true while objects are being constructed concurrently, see PrefetchObjects()
+	bool IsPrefetching() const {
+		return prefetching;
+	}
+
+	boost::mutex& PrefetchMutex() const {
+		return prefetchMutex;
+	}
+#endif
+
 private:
 
-	std::vector<const Connection*> GetConnectionsSequenced(uint64_t id, const ConnectionMap&) const;
-	std::vector<const Connection*> GetConnectionsSequenced(uint64_t id, bool is_src, 
-		const ConnectionMap&, 
+	/** CSR-style adjacency list of all connections, keyed by either
+	 *  source or destination object id */
+	struct ConnectionIndex
+	{
+		// sorted object ids
+		std::vector<uint64_t> ids;
+
+		// entries for ids[i] are [offsets[i],offsets[i+1]), in insertion order
+		std::vector<unsigned int> offsets;
+		std::vector<ConnectionList::Entry> entries;
+	};
+
+	unsigned int InternClass(const std::string& name);
+	void BuildConnectionIndex(ConnectionIndex& index, bool is_src);
+
+	ConnectionList GetConnectionsSequenced(uint64_t id, const ConnectionIndex& index, 
+		const unsigned int* classes = NULL, 
+		size_t num_classes = 0) const;
+	ConnectionList GetConnectionsSequenced(uint64_t id, 
+		const ConnectionIndex& index, 
 		const char* const* classnames, 
 		size_t count) const;
 
@@ -1365,6 +1532,7 @@ private:
 	void ReadPropertyTemplates();
 	void ReadConnections();
 	void ReadGlobalSettings();
+	void PrefetchObjects();
 
 private:
 
@@ -1374,8 +1542,14 @@ private:
 	const Parser& parser;
 
 	PropertyTemplateMap templates;
-	ConnectionMap src_connections;
-	ConnectionMap dest_connections;
+
+	// all connections in insertion order, owned by the document
+	std::vector<const Connection*> connections;
+	ConnectionIndex src_connections;
+	ConnectionIndex dest_connections;
+
+	// interned object classes
+	std::map<std::string, unsigned int> classIds;
 
 	unsigned int fbxVersion;
 	std::string creator;
@@ -1385,6 +1559,11 @@ private:
 	mutable std::vector<const AnimationStack*> animationStacksResolved;
 
 	boost::scoped_ptr<FileGlobalSettings> globals;
+
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+	bool prefetching;
+	mutable boost::mutex prefetchMutex;
+#endif
 };
 
 }
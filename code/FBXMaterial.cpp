@@ -94,7 +94,7 @@ Material::Material(uint64_t id, const Element& element, const Document& doc, con
 	props = GetPropertyTable(doc,templateName,element,sc);
 
 	// resolve texture links
-	const std::vector<const Connection*>& conns = doc.GetConnectionsByDestinationSequenced(ID());
+	const ConnectionList& conns = doc.GetConnectionsByDestinationSequenced(ID());
 	BOOST_FOREACH(const Connection* con, conns) {
 
 		// texture link to properties, not objects
@@ -236,11 +236,8 @@ LayeredTexture::~LayeredTexture()
 
 void LayeredTexture::fillTexture(const Document& doc)
 {
-	const std::vector<const Connection*>& conns = doc.GetConnectionsByDestinationSequenced(ID());
-	for(size_t i = 0; i < conns.size();++i)
-	{
-		const Connection* con = conns.at(i);
-
+	const ConnectionList& conns = doc.GetConnectionsByDestinationSequenced(ID());
+	BOOST_FOREACH(const Connection* con, conns) {
 		const Object* const ob = con->SourceObject();
 		if(!ob) {
 			DOMWarning("failed to read source object for texture link, ignoring",&element);
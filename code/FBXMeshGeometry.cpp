@@ -65,7 +65,7 @@ Geometry::Geometry(uint64_t id, const Element& element, const std::string& name,
 	: Object(id, element,name)
 	, skin()
 {
-	const std::vector<const Connection*>& conns = doc.GetConnectionsByDestinationSequenced(ID(),"Deformer");
+	const ConnectionList& conns = doc.GetConnectionsByDestinationSequenced(ID(),"Deformer");
 	BOOST_FOREACH(const Connection* con, conns) {
 		const Skin* const sk = ProcessSimpleConnection<Skin>(*con, false, "Skin -> Geometry", element);
 		if(sk) {
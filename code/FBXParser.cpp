@@ -58,8 +58,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "FBXUtil.h"
 
 #include "ParsingUtils.h"
+#include "ParallelFor.h"
 #include "fast_atof.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	include <emmintrin.h>
+#	define AI_FBX_USE_SSE2
+#endif
+
 using namespace Assimp;
 using namespace Assimp::FBX;
 
@@ -113,6 +119,88 @@ namespace {
 		ParseError(message);
 	}
 
+
+	// ------------------------------------------------------------------------------------------------
+	// size of a single element of a binary array, given its type signature. 0 for unknown types.
+	uint32_t BinaryArrayStride(char type)
+	{
+		switch(type)
+		{
+		case 'f':
+		case 'i':
+			return 4;
+
+		case 'd':
+		case 'l':
+			return 8;
+		};
+		return 0;
+	}
+
+
+	// ------------------------------------------------------------------------------------------------
+	// inflate a zlib/deflate data section of known uncompressed length
+	bool InflateData(const char* data, uint32_t comp_len, char* out, uint32_t full_length)
+	{
+		// zlib/deflate, next comes ZIP head (0x78 0x01)
+		// see http://www.ietf.org/rfc/rfc1950.txt
+		
+		z_stream zstream;
+		zstream.opaque = Z_NULL;
+		zstream.zalloc = Z_NULL;
+		zstream.zfree  = Z_NULL;
+		zstream.data_type = Z_BINARY;
+
+		// http://hewgill.com/journal/entries/349-how-to-decompress-gzip-stream-with-zlib
+		inflateInit(&zstream);
+
+		zstream.next_in   = reinterpret_cast<Bytef*>( const_cast<char*>(data) );
+		zstream.avail_in  = comp_len;
+
+		zstream.avail_out = full_length;
+		zstream.next_out = reinterpret_cast<Bytef*>(out);
+		const int ret = inflate(&zstream, Z_FINISH);
+
+		// terminate zlib
+		inflateEnd(&zstream);
+
+		return ret == Z_STREAM_END || ret == Z_OK;
+	}
+
+
+	// ------------------------------------------------------------------------------------------------
+	// ParallelFor() job to inflate a number of binary arrays into a common buffer
+	struct InflateArraysJob
+	{
+		struct Entry
+		{
+			TokenPtr token;
+			const char* data;
+			uint32_t comp_len;
+			uint32_t full_length;
+			size_t offset;
+			bool ok;
+		};
+
+		void operator()(size_t i) {
+			Entry& e = entries[i];
+			e.ok = InflateData(e.data, e.comp_len, out + e.offset, e.full_length);
+		}
+
+		std::vector<Entry> entries;
+		char* out;
+	};
+
+
+	// ------------------------------------------------------------------------------------------------
+	// order inflated arrays by the position of their tokens in the input buffer
+	struct CompareInflatedArrays
+	{
+		template <typename T>
+		bool operator()(const T& a, const char* b) const {
+			return a.token->begin() < b;
+		}
+	};
 }
 
 namespace Assimp {
@@ -120,7 +208,8 @@ namespace FBX {
 
 // ------------------------------------------------------------------------------------------------
 Element::Element(const Token& key_token, Parser& parser)
-: key_token(key_token)
+: parser(parser)
+, key_token(key_token)
 {
 	TokenPtr n = NULL;
 	do {
@@ -164,7 +253,7 @@ Element::Element(const Token& key_token, Parser& parser)
 // ------------------------------------------------------------------------------------------------
 Element::~Element()
 {
-	 // no need to delete tokens, they are owned by the parser
+	 // no need to delete tokens, they are owned by the TokenArena
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -212,14 +301,18 @@ Scope::~Scope()
 
 
 // ------------------------------------------------------------------------------------------------
-Parser::Parser (const TokenList& tokens, bool is_binary)
+Parser::Parser (const TokenArena& tokens, bool is_binary)
 : tokens(tokens)
 , last()
 , current()
-, cursor(tokens.begin())
+, cursor()
 , is_binary(is_binary)
 {
 	root.reset(new Scope(*this,true));
+
+	if(is_binary) {
+		InflateBinaryArrays();
+	}
 }
 
 
@@ -233,11 +326,11 @@ Parser::~Parser()
 TokenPtr Parser::AdvanceToNextToken()
 {
 	last = current;
-	if (cursor == tokens.end()) {
+	if (cursor == tokens.Size()) {
 		current = NULL;
 	}
 	else {
-		current = *cursor++;
+		current = &tokens[cursor++];
 	}
 	return current;
 }
@@ -257,6 +350,92 @@ TokenPtr Parser::LastToken() const
 }
 
 
+// ------------------------------------------------------------------------------------------------
+void Parser::InflateBinaryArrays()
+{
+	// Large binary files hold most of their payload in deflated arrays. Inflating them all upfront
+	// on all cores is much faster than inflating them one after another whenever the DOM asks for 
+	// them, and each array is inflated only once even if it is read several times.
+	InflateArraysJob job;
+	size_t total = 0;
+
+	for (size_t i = 0; i < tokens.Size(); ++i) {
+		const TokenPtr t = &tokens[i];
+		if (!t->IsBinary() || t->Type() != TokenType_DATA || t->end() - t->begin() < 13) {
+			continue;
+		}
+
+		// array type signature, element count, encoding, compressed length. Skip everything
+		// suspicious, ReadBinaryDataArray() reports the error once the array is accessed.
+		const char* data = t->begin();
+		const uint32_t stride = BinaryArrayStride(data[0]);
+		if (!stride) {
+			continue;
+		}
+
+		BE_NCONST uint32_t count = *reinterpret_cast<const uint32_t*>(data+1);
+		AI_SWAP4(count);
+
+		BE_NCONST uint32_t encmode = *reinterpret_cast<const uint32_t*>(data+5);
+		AI_SWAP4(encmode);
+
+		BE_NCONST uint32_t comp_len = *reinterpret_cast<const uint32_t*>(data+9);
+		AI_SWAP4(comp_len);
+
+		// deflate can't compress better than 1:1032
+		const uint64_t full_length = static_cast<uint64_t>(stride) * count;
+		if (encmode != 1 || !count || data + 13 + comp_len != t->end() || full_length > static_cast<uint64_t>(comp_len) * 1032) {
+			continue;
+		}
+
+		InflateArraysJob::Entry e;
+		e.token = t;
+		e.data = data + 13;
+		e.comp_len = comp_len;
+		e.full_length = static_cast<uint32_t>(full_length);
+		e.offset = total;
+		e.ok = false;
+		job.entries.push_back(e);
+
+		// keep all arrays 8-byte aligned
+		total += (e.full_length + 7) & ~7u;
+	}
+
+	if (job.entries.empty()) {
+		return;
+	}
+
+	inflated_data.resize(total);
+	job.out = &inflated_data[0];
+	ParallelFor(job.entries.size(), job);
+
+	inflated_arrays.reserve(job.entries.size());
+	BOOST_FOREACH(const InflateArraysJob::Entry& e, job.entries) {
+		if (e.ok) {
+			InflatedArray a;
+			a.token = e.token;
+			a.begin = job.out + e.offset;
+			inflated_arrays.push_back(a);
+		}
+	}
+
+	if(DefaultLogger::get()) {
+		DefaultLogger::get()->debug((Formatter::format(),"FBX-Parser: inflated ",inflated_arrays.size(),
+			" binary arrays, ",total," bytes"));
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+const char* Parser::GetInflatedArray(const Token& t) const
+{
+	const std::vector<InflatedArray>::const_iterator it = std::lower_bound(inflated_arrays.begin(),
+		inflated_arrays.end(), t.begin(), CompareInflatedArrays());
+
+	return it != inflated_arrays.end() && (*it).token == &t ? (*it).begin : NULL;
+}
+
+
 // ------------------------------------------------------------------------------------------------
 uint64_t ParseTokenAsID(const Token& t, const char*& err_out)
 {
@@ -493,10 +672,13 @@ void ReadBinaryDataArrayHead(const char*& data, const char* end, char& type, uin
 
 
 // ------------------------------------------------------------------------------------------------
-// read binary data array, assume cursor points to the 'compression mode' field (i.e. behind the header)
-void ReadBinaryDataArray(char type, uint32_t count, const char*& data, const char* end, 
+// read binary data array, assume cursor points to the 'compression mode' field (i.e. behind the header).
+// If dest is given, the uncompressed data is written to it. Otherwise, the returned data is either
+// stored in buff or has been inflated upfront by the parser.
+const char* ReadBinaryDataArray(char type, uint32_t count, const char*& data, const char* end, 
 	std::vector<char>& buff, 
-	const Element& el)
+	const Element& el,
+	char* dest = NULL)
 {
 	ai_assert(static_cast<size_t>(end-data) >= 4); // runtime check for this happens at tokenization stage
 
@@ -512,58 +694,41 @@ void ReadBinaryDataArray(char type, uint32_t count, const char*& data, const cha
 	ai_assert(data + comp_len == end);
 
 	// determine the length of the uncompressed data by looking at the type signature
-	uint32_t stride = 0;
-	switch(type)
-	{
-	case 'f':
-	case 'i':
-		stride = 4;
-		break;
+	const uint32_t stride = BinaryArrayStride(type);
+	ai_assert(stride);
 
-	case 'd':
-	case 'l':
-		stride = 8;
-		break;
+	const uint32_t full_length = stride * count;
 
-	default:
-		ai_assert(false);
-	};
+	if(encmode == 1) {
+		// the parser has usually inflated it already
+		const char* const inflated = el.GetParser().GetInflatedArray(*el.Tokens()[0]);
+		if (inflated) {
+			data += comp_len;
+			if (dest) {
+				::memcpy(dest, inflated, full_length);
+				return dest;
+			}
+			return inflated;
+		}
+	}
 
-	const uint32_t full_length = stride * count;
-	buff.resize(full_length);
+	if (!dest) {
+		buff.resize(full_length);
+		dest = &buff[0];
+	}
 
 	if(encmode == 0) {
-		ai_assert(full_length == comp_len);
+		if(full_length != comp_len) {
+			ParseError("length of uncompressed data section does not match the element count (binary)",&el);
+		}
 
 		// plain data, no compression
-		std::copy(data, end, buff.begin());
+		std::copy(data, end, dest);
 	}
 	else if(encmode == 1) {
-		// zlib/deflate, next comes ZIP head (0x78 0x01)
-		// see http://www.ietf.org/rfc/rfc1950.txt
-		
-		z_stream zstream;
-		zstream.opaque = Z_NULL;
-		zstream.zalloc = Z_NULL;
-		zstream.zfree  = Z_NULL;
-		zstream.data_type = Z_BINARY;
-
-		// http://hewgill.com/journal/entries/349-how-to-decompress-gzip-stream-with-zlib
-		inflateInit(&zstream);
-
-		zstream.next_in   = reinterpret_cast<Bytef*>( const_cast<char*>(data) );
-		zstream.avail_in  = comp_len;
-
-		zstream.avail_out = buff.size();
-		zstream.next_out = reinterpret_cast<Bytef*>(&*buff.begin());
-		const int ret = inflate(&zstream, Z_FINISH);
-
-		if (ret != Z_STREAM_END && ret != Z_OK) {
+		if (!InflateData(data, comp_len, dest, full_length)) {
 			ParseError("failure decompressing compressed data section");
 		}
-
-		// terminate zlib
-		inflateEnd(&zstream);
 	}
 #ifdef ASSIMP_BUILD_DEBUG
 	else {
@@ -574,6 +739,83 @@ void ReadBinaryDataArray(char type, uint32_t count, const char*& data, const cha
 
 	data += comp_len;
 	ai_assert(data == end);
+	return dest;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// narrow an array of doubles to floats, the input need not be aligned
+void ConvertDoublesToFloats(const double* in, float* out, size_t count)
+{
+	size_t i = 0;
+#ifdef AI_FBX_USE_SSE2
+	for (; i + 4 <= count; i += 4) {
+		const __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(in + i));
+		const __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(in + i + 2));
+		_mm_storeu_ps(out + i, _mm_movelh_ps(lo, hi));
+	}
+#endif
+	for (; i < count; ++i) {
+		out[i] = static_cast<float>(in[i]);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// decode a binary array of floats or doubles straight into a vector of float tuples
+template <typename T>
+void ReadBinaryFloatArray(std::vector<T>& out, char type, uint32_t count, const char*& data, 
+	const char* end, 
+	const Element& el)
+{
+	BOOST_STATIC_ASSERT(sizeof(T) % sizeof(float) == 0);
+	static const uint32_t components = sizeof(T) / sizeof(float);
+
+	if (count % components != 0) {
+		ParseError(Formatter::format("number of floats is not a multiple of ") << components << " (binary)",&el);
+	}
+
+	out.resize(count / components);
+	if (!count) {
+		return;
+	}
+
+	char* const dest = reinterpret_cast<char*>(&out[0]);
+
+	std::vector<char> buff;
+	if (type == 'f') {
+		ReadBinaryDataArray(type, count, data, end, buff, el, dest);
+	}
+	else {
+		const char* const raw = ReadBinaryDataArray(type, count, data, end, buff, el);
+		ConvertDoublesToFloats(reinterpret_cast<const double*>(raw), reinterpret_cast<float*>(dest), count);
+	}
+	ai_assert(data == end);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// decode a binary array of 32 or 64 bit integers straight into a vector of integers of same size
+template <typename T>
+void ReadBinaryIntArray(std::vector<T>& out, char type, uint32_t count, const char*& data, 
+	const char* end, 
+	const Element& el)
+{
+	ai_assert(sizeof(T) == BinaryArrayStride(type));
+	out.resize(count);
+	if (!count) {
+		return;
+	}
+
+	std::vector<char> buff;
+	ReadBinaryDataArray(type, count, data, end, buff, el, reinterpret_cast<char*>(&out[0]));
+	ai_assert(data == end);
+
+#ifdef AI_BUILD_BIG_ENDIAN
+	for (typename std::vector<T>::iterator it = out.begin(); it != out.end(); ++it) {
+		ByteSwap::Swap(&*it);
+	}
+#endif
 }
 
 } // !anon
@@ -609,30 +851,7 @@ void ParseVectorDataArray(std::vector<aiVector3D>& out, const Element& el)
 			ParseError("expected float or double array (binary)",&el);
 		}
 
-		std::vector<char> buff;
-		ReadBinaryDataArray(type, count, data, end, buff, el);
-		
-		ai_assert(data == end);
-		ai_assert(buff.size() == count * (type == 'd' ? 8 : 4));
-
-		const uint32_t count3 = count / 3;
-		out.reserve(count3);
-
-		if (type == 'd') {
-			const double* d = reinterpret_cast<const double*>(&buff[0]);
-			for (unsigned int i = 0; i < count3; ++i, d += 3) {
-				out.push_back(aiVector3D(static_cast<float>(d[0]),
-					static_cast<float>(d[1]),
-					static_cast<float>(d[2])));
-			}
-		}
-		else if (type == 'f') {
-			const float* f = reinterpret_cast<const float*>(&buff[0]);
-			for (unsigned int i = 0; i < count3; ++i, f += 3) {
-				out.push_back(aiVector3D(f[0],f[1],f[2]));
-			}
-		}
-
+		ReadBinaryFloatArray(out, type, count, data, end, el);
 		return;
 	}
 
@@ -689,30 +908,7 @@ void ParseVectorDataArray(std::vector<aiColor4D>& out, const Element& el)
 			ParseError("expected float or double array (binary)",&el);
 		}
 
-		std::vector<char> buff;
-		ReadBinaryDataArray(type, count, data, end, buff, el);
-
-		ai_assert(data == end);
-		ai_assert(buff.size() == count * (type == 'd' ? 8 : 4));
-
-		const uint32_t count4 = count / 4;
-		out.reserve(count4);
-
-		if (type == 'd') {
-			const double* d = reinterpret_cast<const double*>(&buff[0]);
-			for (unsigned int i = 0; i < count4; ++i, d += 4) {
-				out.push_back(aiColor4D(static_cast<float>(d[0]),
-					static_cast<float>(d[1]),
-					static_cast<float>(d[2]),
-					static_cast<float>(d[3])));
-			}
-		}
-		else if (type == 'f') {
-			const float* f = reinterpret_cast<const float*>(&buff[0]);
-			for (unsigned int i = 0; i < count4; ++i, f += 4) {
-				out.push_back(aiColor4D(f[0],f[1],f[2],f[3]));
-			}
-		}
+		ReadBinaryFloatArray(out, type, count, data, end, el);
 		return;
 	}
 
@@ -768,29 +964,7 @@ void ParseVectorDataArray(std::vector<aiVector2D>& out, const Element& el)
 			ParseError("expected float or double array (binary)",&el);
 		}
 
-		std::vector<char> buff;
-		ReadBinaryDataArray(type, count, data, end, buff, el);
-
-		ai_assert(data == end);
-		ai_assert(buff.size() == count * (type == 'd' ? 8 : 4));
-
-		const uint32_t count2 = count / 2;
-		out.reserve(count2);
-
-		if (type == 'd') {
-			const double* d = reinterpret_cast<const double*>(&buff[0]);
-			for (unsigned int i = 0; i < count2; ++i, d += 2) {
-				out.push_back(aiVector2D(static_cast<float>(d[0]),
-					static_cast<float>(d[1])));
-			}
-		}
-		else if (type == 'f') {
-			const float* f = reinterpret_cast<const float*>(&buff[0]);
-			for (unsigned int i = 0; i < count2; ++i, f += 2) {
-				out.push_back(aiVector2D(f[0],f[1]));
-			}
-		}
-
+		ReadBinaryFloatArray(out, type, count, data, end, el);
 		return;
 	}
 
@@ -840,21 +1014,7 @@ void ParseVectorDataArray(std::vector<int>& out, const Element& el)
 			ParseError("expected int array (binary)",&el);
 		}
 
-		std::vector<char> buff;
-		ReadBinaryDataArray(type, count, data, end, buff, el);
-
-		ai_assert(data == end);
-		ai_assert(buff.size() == count * 4);
-
-		out.reserve(count);
-
-		const int32_t* ip = reinterpret_cast<const int32_t*>(&buff[0]);
-		for (unsigned int i = 0; i < count; ++i, ++ip) {
-			BE_NCONST int32_t val = *ip;
-			AI_SWAP4(val);
-			out.push_back(val);
-		}
-
+		ReadBinaryIntArray(out, type, count, data, end, el);
 		return;
 	}
 
@@ -898,25 +1058,7 @@ void ParseVectorDataArray(std::vector<float>& out, const Element& el)
 			ParseError("expected float or double array (binary)",&el);
 		}
 
-		std::vector<char> buff;
-		ReadBinaryDataArray(type, count, data, end, buff, el);
-
-		ai_assert(data == end);
-		ai_assert(buff.size() == count * (type == 'd' ? 8 : 4));
-
-		if (type == 'd') {
-			const double* d = reinterpret_cast<const double*>(&buff[0]);
-			for (unsigned int i = 0; i < count; ++i, ++d) {
-				out.push_back(static_cast<float>(*d));
-			}
-		}
-		else if (type == 'f') {
-			const float* f = reinterpret_cast<const float*>(&buff[0]);
-			for (unsigned int i = 0; i < count; ++i, ++f) {
-				out.push_back(*f);
-			}
-		}
-
+		ReadBinaryFloatArray(out, type, count, data, end, el);
 		return;
 	}
 
@@ -960,25 +1102,13 @@ void ParseVectorDataArray(std::vector<unsigned int>& out, const Element& el)
 			ParseError("expected (u)int array (binary)",&el);
 		}
 
-		std::vector<char> buff;
-		ReadBinaryDataArray(type, count, data, end, buff, el);
-
-		ai_assert(data == end);
-		ai_assert(buff.size() == count * 4);
+		ReadBinaryIntArray(out, type, count, data, end, el);
 
-		out.reserve(count);
-
-		const int32_t* ip = reinterpret_cast<const int32_t*>(&buff[0]);
-		for (unsigned int i = 0; i < count; ++i, ++ip) {
-			BE_NCONST int32_t val = *ip;
-			if(val < 0) {
+		for (std::vector<unsigned int>::const_iterator it = out.begin(); it != out.end(); ++it) {
+			if(static_cast<int32_t>(*it) < 0) {
 				ParseError("encountered negative integer index (binary)");
 			}
-
-			AI_SWAP4(val);
-			out.push_back(val);
 		}
-
 		return;
 	}
 
@@ -1025,21 +1155,7 @@ void ParseVectorDataArray(std::vector<uint64_t>& out, const Element& el)
 			ParseError("expected long array (binary)",&el);
 		}
 
-		std::vector<char> buff;
-		ReadBinaryDataArray(type, count, data, end, buff, el);
-
-		ai_assert(data == end);
-		ai_assert(buff.size() == count * 8);
-
-		out.reserve(count);
-
-		const uint64_t* ip = reinterpret_cast<const uint64_t*>(&buff[0]);
-		for (unsigned int i = 0; i < count; ++i, ++ip) {
-			BE_NCONST uint64_t val = *ip;
-			AI_SWAP8(val);
-			out.push_back(val);
-		}
-
+		ReadBinaryIntArray(out, type, count, data, end, el);
 		return;
 	}
 
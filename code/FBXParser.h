@@ -105,8 +105,13 @@ public:
 		return tokens;
 	}
 
+	const Parser& GetParser() const {
+		return parser;
+	}
+
 private:
 
+	const Parser& parser;
 	const Token& key_token;
 	TokenList tokens;
 	boost::scoped_ptr<Scope> compound;
@@ -162,7 +167,7 @@ public:
 	
 	/** Parse given a token list. Does not take ownership of the tokens -
 	 *  the objects must persist during the entire parser lifetime */
-	Parser (const TokenList& tokens,bool is_binary);
+	Parser (const TokenArena& tokens,bool is_binary);
 	~Parser();
 
 public:
@@ -176,6 +181,11 @@ public:
 		return is_binary;
 	}
 
+	/** Get the uncompressed contents of a zlib-compressed binary array token
+	 *  if it has been inflated upfront, see InflateBinaryArrays().
+	 *  @return NULL if the token is not in the cache */
+	const char* GetInflatedArray(const Token& t) const;
+
 private:
 
 	friend class Scope;
@@ -186,17 +196,28 @@ private:
 	TokenPtr LastToken() const;
 	TokenPtr CurrentToken() const;
 
-	
+	/** Inflate all compressed binary arrays concurrently */
+	void InflateBinaryArrays();
 
 private:
 
-	const TokenList& tokens;
+	struct InflatedArray
+	{
+		TokenPtr token;
+		const char* begin; 
+	};
+
+	const TokenArena& tokens;
 	
 	TokenPtr last, current;
-	TokenList::const_iterator cursor;
+	size_t cursor;
 	boost::scoped_ptr<Scope> root;
 
 	const bool is_binary;
+
+	// inflated binary arrays, sorted by the position of their tokens in the input
+	std::vector<char> inflated_data;
+	std::vector<InflatedArray> inflated_arrays;
 };
 
 
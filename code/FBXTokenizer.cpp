@@ -81,6 +81,34 @@ Token::~Token()
 }
 
 
+// ------------------------------------------------------------------------------------------------
+TokenArena::TokenArena()
+: size()
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+TokenArena::~TokenArena()
+{
+	for (size_t i = 0; i < size; ++i) {
+		(*this)[i].~Token();
+	}
+	BOOST_FOREACH(Token* chunk, chunks) {
+		::operator delete(chunk);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+void TokenArena::AddChunk()
+{
+	// reserve first so push_back() can't throw and leak the chunk
+	chunks.reserve(chunks.size() + 1);
+	chunks.push_back(static_cast<Token*>(::operator new(sizeof(Token) * CHUNK_SIZE)));
+}
+
+
 namespace {
 
 // ------------------------------------------------------------------------------------------------
@@ -93,7 +121,7 @@ void TokenizeError(const std::string& message, unsigned int line, unsigned int c
 
 // process a potential data token up to 'cur', adding it to 'output_tokens'. 
 // ------------------------------------------------------------------------------------------------
-void ProcessDataToken( TokenList& output_tokens, const char*& start, const char*& end,
+void ProcessDataToken( TokenArena& output_tokens, const char*& start, const char*& end,
 					  unsigned int line, 
 					  unsigned int column, 
 					  TokenType type = TokenType_DATA,
@@ -118,7 +146,7 @@ void ProcessDataToken( TokenList& output_tokens, const char*& start, const char*
 			TokenizeError("non-terminated double quotes", line, column);
 		}
 
-		output_tokens.push_back(new_Token(start,end + 1,type,line,column));
+		output_tokens.Add(start,end + 1,type,line,column);
 	}
 	else if (must_have_token) {
 		TokenizeError("unexpected character, expected data token", line, column);
@@ -130,7 +158,7 @@ void ProcessDataToken( TokenList& output_tokens, const char*& start, const char*
 }
 
 // ------------------------------------------------------------------------------------------------
-void Tokenize(TokenList& output_tokens, const char* input)
+void Tokenize(TokenArena& output_tokens, const char* input)
 {
 	ai_assert(input);
 
@@ -185,19 +213,19 @@ void Tokenize(TokenList& output_tokens, const char* input)
 
 		case '{':
 			ProcessDataToken(output_tokens,token_begin,token_end, line, column);
-			output_tokens.push_back(new_Token(cur,cur+1,TokenType_OPEN_BRACKET,line,column));
+			output_tokens.Add(cur,cur+1,TokenType_OPEN_BRACKET,line,column);
 			continue;
 
 		case '}':
 			ProcessDataToken(output_tokens,token_begin,token_end,line,column);
-			output_tokens.push_back(new_Token(cur,cur+1,TokenType_CLOSE_BRACKET,line,column));
+			output_tokens.Add(cur,cur+1,TokenType_CLOSE_BRACKET,line,column);
 			continue;
 		
 		case ',':
 			if (pending_data_token) {
 				ProcessDataToken(output_tokens,token_begin,token_end,line,column,TokenType_DATA,true);
 			}
-			output_tokens.push_back(new_Token(cur,cur+1,TokenType_COMMA,line,column));
+			output_tokens.Add(cur,cur+1,TokenType_COMMA,line,column);
 			continue;
 
 		case ':':
@@ -156,32 +156,87 @@ private:
 	const unsigned int column;
 };
 
-// XXX should use C++11's unique_ptr - but assimp's need to keep working with 03
 typedef const Token* TokenPtr;
 typedef std::vector< TokenPtr > TokenList;
 
-#define new_Token new Token
+
+/** Owns all tokens of a FBX file. Tokens are constructed in place in large,
+ *  contiguous chunks so tokenizing does not do one heap allocation per token.
+ *  Tokens never move once added, so #TokenPtr's remain valid for the lifetime
+ *  of the arena. Tokens are numbered in the order they were added. */
+class TokenArena
+{
+public:
+
+	TokenArena();
+	~TokenArena();
+
+public:
+
+	/** construct a textual token at the end of the arena */
+	TokenPtr Add(const char* sbegin, const char* send, TokenType type, unsigned int line, unsigned int column) {
+		return new (Allocate()) Token(sbegin,send,type,line,column);
+	}
+
+	/** construct a binary token at the end of the arena */
+	TokenPtr Add(const char* sbegin, const char* send, TokenType type, unsigned int offset) {
+		return new (Allocate()) Token(sbegin,send,type,offset);
+	}
+
+	size_t Size() const {
+		return size;
+	}
+
+	const Token& operator[] (size_t i) const {
+		ai_assert(i < size);
+		return chunks[i >> CHUNK_SHIFT][i & (CHUNK_SIZE - 1)];
+	}
+
+private:
+
+	// noncopyable
+	TokenArena(const TokenArena&);
+	TokenArena& operator= (const TokenArena&);
+
+	// get storage for the next token
+	Token* Allocate() {
+		if ((size & (CHUNK_SIZE - 1)) == 0) {
+			AddChunk();
+		}
+		return chunks.back() + (size++ & (CHUNK_SIZE - 1));
+	}
+
+	void AddChunk();
+
+private:
+
+	static const size_t CHUNK_SHIFT = 12;
+	static const size_t CHUNK_SIZE = 1u << CHUNK_SHIFT;
+
+	std::vector<Token*> chunks;
+	size_t size;
+};
 
 
 /** Main FBX tokenizer function. Transform input buffer into a list of preprocessed tokens.
  *
  *  Skips over comments and generates line and column numbers.
  *
- * @param output_tokens Receives a list of all tokens in the input data.
+ * @param output_tokens Receives all tokens in the input data.
  * @param input_buffer Textual input buffer to be processed, 0-terminated.
  * @throw DeadlyImportError if something goes wrong */
-void Tokenize(TokenList& output_tokens, const char* input);
+void Tokenize(TokenArena& output_tokens, const char* input);
 
 
 /** Tokenizer function for binary FBX files.
  *
  *  Emits a token list suitable for direct parsing.
  *
- * @param output_tokens Receives a list of all tokens in the input data.
+ * @param output_tokens Receives all tokens in the input data.
  * @param input_buffer Binary input buffer to be processed.
  * @param length Length of input buffer, in bytes. There is no 0-terminal.
  * @throw DeadlyImportError if something goes wrong */
-void TokenizeBinary(TokenList& output_tokens, const char* input, unsigned int length);
+void TokenizeBinary(TokenArena& output_tokens, const char* input, unsigned int length);
 
 
 } // ! FBX
@@ -0,0 +1,693 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2012, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms, 
+with or without modification, are permitted provided that the 
+following conditions are met:
+
+* Redistributions of source code must retain the above
+copyright notice, this list of conditions and the
+following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the
+following disclaimer in the documentation and/or other
+materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+contributors may be used to endorse or promote products
+derived from this software without specific prior
+written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  FastXMLReader.cpp
+ *  @brief Implementation of the in-situ XML pull parser
+ */
+
+#include "AssimpPCH.h"
+#include "FastXMLReader.h"
+#include "ParsingUtils.h"
+#include "fast_atof.h"
+
+using namespace Assimp;
+using namespace irr::io;
+
+namespace {
+
+	// ------------------------------------------------------------------------------------------------
+	// FNV-1a, good enough for element names
+	AI_FORCE_INLINE unsigned int HashName(const char* name, unsigned int length)
+	{
+		unsigned int hash = 2166136261u;
+		for (unsigned int i = 0; i < length; ++i) {
+			hash = (hash ^ static_cast<unsigned char>(name[i])) * 16777619u;
+		}
+		return hash;
+	}
+
+	// ------------------------------------------------------------------------------------------------
+	AI_FORCE_INLINE bool IsXMLSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+
+	// ------------------------------------------------------------------------------------------------
+	// Writes the UTF8 encoding of a code point, returns the number of bytes written
+	unsigned int EncodeUTF8(unsigned long cp, char* out)
+	{
+		if (cp < 0x80) {
+			out[0] = static_cast<char>(cp);
+			return 1;
+		}
+		if (cp < 0x800) {
+			out[0] = static_cast<char>(0xc0 | (cp >> 6));
+			out[1] = static_cast<char>(0x80 | (cp & 0x3f));
+			return 2;
+		}
+		if (cp < 0x10000) {
+			out[0] = static_cast<char>(0xe0 | (cp >> 12));
+			out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+			out[2] = static_cast<char>(0x80 | (cp & 0x3f));
+			return 3;
+		}
+		out[0] = static_cast<char>(0xf0 | ((cp >> 18) & 0x7));
+		out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+		out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+		out[3] = static_cast<char>(0x80 | (cp & 0x3f));
+		return 4;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+FastXMLReader::FastXMLReader(IOStream* stream, const char* const* names, unsigned int numNames)
+	: mCur()
+	, mEnd()
+	, mPendingTag()
+	, mType(EXN_NONE)
+	, mName("")
+	, mNameLength()
+	, mNodeId(INVALID_ID)
+	, mIsEmpty()
+{
+	ai_assert(stream);
+
+	// Read the file into memory and convert it to UTF8. We need the whole file in
+	// memory anyway, the parser operates in-place on this buffer.
+	const size_t size = stream->FileSize();
+	mData.reserve(size+1);
+	mData.resize(size);
+	if (size && stream->Read(&mData[0],size,1) != 1) {
+		throw DeadlyImportError("XML: failed to read input stream");
+	}
+	BaseImporter::ConvertToUTF8(mData);
+
+	// Remove remaining null characters from the input sequence otherwise the parsing 
+	// will utterly fail. This must happen after the UTF conversion, UTF16 and UTF32 
+	// input would be mangled otherwise.
+	mData.erase(std::remove(mData.begin(),mData.end(),'\0'),mData.end());
+
+	mData.push_back('\0');
+	mCur = &mData[0];
+	mEnd = mCur + mData.size() - 1;
+
+	mAttributes.reserve(16);
+	mHashTable.resize(64,0);
+	for (unsigned int i = 0; i < numNames; ++i) {
+		internName(names[i],static_cast<unsigned int>(::strlen(names[i])));
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+FastXMLReader::~FastXMLReader()
+{
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned int FastXMLReader::internName(const char* name, unsigned int length)
+{
+	unsigned int mask = static_cast<unsigned int>(mHashTable.size()) - 1;
+	unsigned int slot = HashName(name,length) & mask;
+
+	for (;;slot = (slot + 1) & mask) {
+		const unsigned int entry = mHashTable[slot];
+		if (!entry) {
+			break;
+		}
+		const std::string& s = mInterned[entry-1];
+		if (s.length() == length && !::memcmp(s.data(),name,length)) {
+			return entry-1;
+		}
+	}
+
+	const unsigned int id = static_cast<unsigned int>(mInterned.size());
+	mInterned.push_back(std::string(name,length));
+	mHashTable[slot] = id+1;
+
+	// keep the load factor below 1/2
+	if (mInterned.size() * 2 > mHashTable.size()) {
+		std::vector<unsigned int> table(mHashTable.size() * 2,0);
+		mask = static_cast<unsigned int>(table.size()) - 1;
+
+		for (unsigned int i = 0; i < mInterned.size(); ++i) {
+			const std::string& s = mInterned[i];
+			slot = HashName(s.data(),static_cast<unsigned int>(s.length())) & mask;
+			while (table[slot]) {
+				slot = (slot + 1) & mask;
+			}
+			table[slot] = i+1;
+		}
+		mHashTable.swap(table);
+	}
+	return id;
+}
+
+// ------------------------------------------------------------------------------------------------
+void FastXMLReader::throwUnexpectedEOF() const
+{
+	throw DeadlyImportError("XML: unexpected end of file");
+}
+
+// ------------------------------------------------------------------------------------------------
+char* FastXMLReader::decodeEntities(char* begin, char* end)
+{
+	char* out = static_cast<char*>(::memchr(begin,'&',end-begin));
+	if (!out) {
+		return end;
+	}
+
+	for (char* in = out; in != end;) {
+		if (*in != '&') {
+			*out++ = *in++;
+			continue;
+		}
+
+		char* const semicolon = static_cast<char*>(::memchr(in,';',std::min<ptrdiff_t>(end-in,12)));
+		if (!semicolon) {
+			// not an entity reference, keep the ampersand
+			*out++ = *in++;
+			continue;
+		}
+
+		const char* const ent = in + 1;
+		const ptrdiff_t len = semicolon - ent;
+		if (len == 3 && !::strncmp(ent,"amp",3)) {
+			*out++ = '&';
+		}
+		else if (len == 2 && !::strncmp(ent,"lt",2)) {
+			*out++ = '<';
+		}
+		else if (len == 2 && !::strncmp(ent,"gt",2)) {
+			*out++ = '>';
+		}
+		else if (len == 4 && !::strncmp(ent,"quot",4)) {
+			*out++ = '\"';
+		}
+		else if (len == 4 && !::strncmp(ent,"apos",4)) {
+			*out++ = '\'';
+		}
+		else if (len > 1 && *ent == '#') {
+			const unsigned long cp = (ent[1] == 'x' || ent[1] == 'X') ? strtoul16(ent+2) : strtoul10(ent+1);
+			out += EncodeUTF8(cp,out);
+		}
+		else {
+			// unknown entity, keep it verbatim
+			while (in != semicolon + 1) {
+				*out++ = *in++;
+			}
+			continue;
+		}
+		in = semicolon + 1;
+	}
+	return out;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool FastXMLReader::read()
+{
+	// Note: attributes and the empty flag are only reset by element nodes. 
+	// IrrXML behaves the same and some loaders rely on this.
+	mNodeId = INVALID_ID;
+
+	if (mPendingTag) {
+		mPendingTag = false;
+		parseTag();
+		return true;
+	}
+
+	if (mCur >= mEnd) {
+		return false;
+	}
+
+	if (*mCur != '<') {
+		char* const begin = mCur;
+		char* const lt = static_cast<char*>(::memchr(mCur,'<',mEnd-mCur));
+		if (!lt) {
+			// trailing text after the document element, ignore
+			mCur = mEnd;
+			return false;
+		}
+
+		// like IrrXML, skip very short whitespace runs between tags, 
+		// but report everything else as text.
+		bool skip = false;
+		if (lt - begin < 3) {
+			skip = true;
+			for (const char* p = begin; p != lt; ++p) {
+				if (!IsXMLSpace(*p)) {
+					skip = false;
+					break;
+				}
+			}
+		}
+
+		if (!skip) {
+			char* const end = decodeEntities(begin,lt);
+			*end = '\0';
+
+			// overwriting the '<' is fine, we know there's a tag following
+			*lt = '\0';
+			mCur = lt + 1;
+			mPendingTag = true;
+
+			mType = EXN_TEXT;
+			mName = begin;
+			mNameLength = static_cast<unsigned int>(end - begin);
+			return true;
+		}
+		mCur = lt;
+	}
+
+	++mCur;
+	parseTag();
+	return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void FastXMLReader::parseTag()
+{
+	// mCur points to the character following the '<'
+	switch (*mCur)
+	{
+	case '/':
+		parseClosingElement();
+		break;
+	case '?':
+	case '!':
+		parseSpecial();
+		break;
+	default:
+		parseOpeningElement();
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+void FastXMLReader::parseOpeningElement()
+{
+	mType = EXN_ELEMENT;
+	mIsEmpty = false;
+	mAttributes.clear();
+
+	char* const name = mCur;
+	while (!IsXMLSpace(*mCur) && *mCur != '>' && *mCur != '/') {
+		if (!*mCur) {
+			throwUnexpectedEOF();
+		}
+		++mCur;
+	}
+	char* const nameEnd = mCur;
+
+	// collect attributes first, terminators are written afterwards since
+	// the character following a name may be significant ('>' or '/')
+	for (;;) {
+		while (IsXMLSpace(*mCur)) {
+			++mCur;
+		}
+
+		if (*mCur == '>') {
+			++mCur;
+			break;
+		}
+		if (*mCur == '/') {
+			mIsEmpty = true;
+			mCur = static_cast<char*>(::memchr(mCur,'>',mEnd-mCur));
+			if (!mCur) {
+				throwUnexpectedEOF();
+			}
+			++mCur;
+			break;
+		}
+		if (!*mCur) {
+			throwUnexpectedEOF();
+		}
+
+		Attribute attr;
+		char* const attrName = mCur;
+		while (!IsXMLSpace(*mCur) && *mCur != '=' && *mCur) {
+			++mCur;
+		}
+		attr.name = attrName;
+		attr.nameLength = static_cast<unsigned int>(mCur - attrName);
+
+		while (*mCur != '\"' && *mCur != '\'') {
+			if (!*mCur) {
+				throwUnexpectedEOF();
+			}
+			++mCur;
+		}
+
+		const char quote = *mCur++;
+		char* const value = mCur;
+		mCur = static_cast<char*>(::memchr(mCur,quote,mEnd-mCur));
+		if (!mCur) {
+			throwUnexpectedEOF();
+		}
+
+		attr.value = value;
+		attr.valueLength = static_cast<unsigned int>(decodeEntities(value,mCur) - value);
+		++mCur;
+
+		mAttributes.push_back(attr);
+	}
+
+	// now terminate all strings in-place
+	for (std::vector<Attribute>::iterator it = mAttributes.begin(); it != mAttributes.end(); ++it) {
+		const_cast<char*>((*it).name)[(*it).nameLength] = '\0';
+		const_cast<char*>((*it).value)[(*it).valueLength] = '\0';
+	}
+
+	mName = name;
+	mNameLength = static_cast<unsigned int>(nameEnd - name);
+	mNodeId = internName(name,mNameLength);
+	*nameEnd = '\0';
+}
+
+// ------------------------------------------------------------------------------------------------
+void FastXMLReader::parseClosingElement()
+{
+	mType = EXN_ELEMENT_END;
+	mIsEmpty = false;
+	mAttributes.clear();
+
+	char* const name = ++mCur;
+	char* const gt = static_cast<char*>(::memchr(mCur,'>',mEnd-mCur));
+	if (!gt) {
+		throwUnexpectedEOF();
+	}
+
+	char* nameEnd = gt;
+	while (nameEnd != name && IsXMLSpace(nameEnd[-1])) {
+		--nameEnd;
+	}
+	mCur = gt + 1;
+
+	mName = name;
+	mNameLength = static_cast<unsigned int>(nameEnd - name);
+	mNodeId = internName(name,mNameLength);
+	*nameEnd = '\0';
+}
+
+// ------------------------------------------------------------------------------------------------
+void FastXMLReader::parseSpecial()
+{
+	char* begin = mCur, *end = NULL;
+	const size_t remaining = mEnd - mCur;
+
+	if (remaining >= 8 && !::strncmp(mCur,"![CDATA[",8)) {
+		mType = EXN_CDATA;
+		begin = mCur + 8;
+		for (end = begin; end + 2 < mEnd && ::strncmp(end,"]]>",3); ++end);
+		mCur = end + 3;
+	}
+	else if (remaining >= 3 && !::strncmp(mCur,"!--",3)) {
+		mType = EXN_COMMENT;
+		begin = mCur + 3;
+		for (end = begin; end + 2 < mEnd && ::strncmp(end,"-->",3); ++end);
+		mCur = end + 3;
+	}
+	else {
+		// processing instructions and DTD declarations. Keep track of
+		// nested brackets to skip internal DTD subsets.
+		mType = *mCur == '?' ? EXN_UNKNOWN : EXN_COMMENT;
+		unsigned int depth = 1;
+		for (end = mCur; end < mEnd; ++end) {
+			if (*end == '<') {
+				++depth;
+			}
+			else if (*end == '>' && !--depth) {
+				break;
+			}
+		}
+		mCur = end + 1;
+	}
+
+	if (mCur > mEnd) {
+		throwUnexpectedEOF();
+	}
+
+	*end = '\0';
+	mName = begin;
+	mNameLength = static_cast<unsigned int>(end - begin);
+}
+
+// ------------------------------------------------------------------------------------------------
+void FastXMLReader::deferElement(ElementMark& mark)
+{
+	ai_assert(mType == EXN_ELEMENT);
+
+	mark.name = mName;
+	mark.nameLength = mNameLength;
+	mark.nodeId = mNodeId;
+	mark.isEmpty = mIsEmpty;
+	mark.attributes = mAttributes;
+	mark.contentsBegin = mark.contentsEnd = mCur;
+
+	if (mIsEmpty) {
+		return;
+	}
+
+	// Scan for the matching closing tag. The buffer is only read, not even
+	// the usual terminators are written, so the contents can be parsed later.
+	const char* cur = mCur;
+	for (unsigned int depth = 1; depth; ) {
+		cur = static_cast<const char*>(::memchr(cur,'<',mEnd-cur));
+		if (!cur) {
+			throwUnexpectedEOF();
+		}
+		++cur;
+
+		const char* terminator = ">";
+		if (*cur == '!') {
+			if (!::strncmp(cur,"!--",3)) {
+				terminator = "-->";
+			}
+			else if (!::strncmp(cur,"![CDATA[",8)) {
+				terminator = "]]>";
+			}
+		}
+		else if (*cur == '?') {
+			terminator = "?>";
+		}
+		else if (*cur == '/') {
+			--depth;
+		}
+		else {
+			// opening tag, '>' may appear in quoted attribute values
+			for (;; ++cur) {
+				if (cur >= mEnd) {
+					throwUnexpectedEOF();
+				}
+				if (*cur == '\"' || *cur == '\'') {
+					cur = static_cast<const char*>(::memchr(cur+1,*cur,mEnd-cur-1));
+					if (!cur) {
+						throwUnexpectedEOF();
+					}
+				}
+				else if (*cur == '>') {
+					break;
+				}
+			}
+			if (cur[-1] != '/') {
+				++depth;
+			}
+			++cur;
+			continue;
+		}
+
+		const size_t len = ::strlen(terminator);
+		for (; ::strncmp(cur,terminator,len); ++cur) {
+			if (cur >= mEnd) {
+				throwUnexpectedEOF();
+			}
+		}
+		cur += len;
+	}
+
+	mark.contentsEnd = cur;
+	mCur = const_cast<char*>(cur);
+	mPendingTag = false;
+
+	mType = EXN_ELEMENT_END;
+	mIsEmpty = false;
+	mAttributes.clear();
+}
+
+// ------------------------------------------------------------------------------------------------
+void FastXMLReader::restoreElement(const ElementMark& mark)
+{
+	mCur = const_cast<char*>(mark.contentsBegin);
+	mPendingTag = false;
+
+	mType = EXN_ELEMENT;
+	mName = mark.name;
+	mNameLength = mark.nameLength;
+	mNodeId = mark.nodeId;
+	mIsEmpty = mark.isEmpty;
+	mAttributes = mark.attributes;
+}
+
+// ------------------------------------------------------------------------------------------------
+EXML_NODE FastXMLReader::getNodeType() const
+{
+	return mType;
+}
+
+// ------------------------------------------------------------------------------------------------
+int FastXMLReader::getAttributeCount() const
+{
+	return static_cast<int>(mAttributes.size());
+}
+
+// ------------------------------------------------------------------------------------------------
+const char* FastXMLReader::getAttributeName(int idx) const
+{
+	if (idx < 0 || idx >= static_cast<int>(mAttributes.size())) {
+		return NULL;
+	}
+	return mAttributes[idx].name;
+}
+
+// ------------------------------------------------------------------------------------------------
+const char* FastXMLReader::getAttributeValue(int idx) const
+{
+	if (idx < 0 || idx >= static_cast<int>(mAttributes.size())) {
+		return NULL;
+	}
+	return mAttributes[idx].value;
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned int FastXMLReader::getAttributeValueLength(int idx) const
+{
+	if (idx < 0 || idx >= static_cast<int>(mAttributes.size())) {
+		return 0;
+	}
+	return mAttributes[idx].valueLength;
+}
+
+// ------------------------------------------------------------------------------------------------
+int FastXMLReader::findAttribute(const char* name) const
+{
+	const size_t length = ::strlen(name);
+	for (size_t i = 0; i < mAttributes.size(); ++i) {
+		const Attribute& attr = mAttributes[i];
+		if (attr.nameLength == length && !::memcmp(attr.name,name,length)) {
+			return static_cast<int>(i);
+		}
+	}
+	return -1;
+}
+
+// ------------------------------------------------------------------------------------------------
+const char* FastXMLReader::getAttributeValue(const char* name) const
+{
+	return getAttributeValue(findAttribute(name));
+}
+
+// ------------------------------------------------------------------------------------------------
+const char* FastXMLReader::getAttributeValueSafe(const char* name) const
+{
+	const char* value = getAttributeValue(name);
+	return value ? value : "";
+}
+
+// ------------------------------------------------------------------------------------------------
+int FastXMLReader::getAttributeValueAsInt(const char* name) const
+{
+	return getAttributeValueAsInt(findAttribute(name));
+}
+
+// ------------------------------------------------------------------------------------------------
+int FastXMLReader::getAttributeValueAsInt(int idx) const
+{
+	const char* value = getAttributeValue(idx);
+	if (!value) {
+		return 0;
+	}
+	SkipSpaces(&value);
+	return strtol10(value);
+}
+
+// ------------------------------------------------------------------------------------------------
+float FastXMLReader::getAttributeValueAsFloat(const char* name) const
+{
+	return getAttributeValueAsFloat(findAttribute(name));
+}
+
+// ------------------------------------------------------------------------------------------------
+float FastXMLReader::getAttributeValueAsFloat(int idx) const
+{
+	const char* value = getAttributeValue(idx);
+	if (!value) {
+		return 0.f;
+	}
+	return fast_atof(value);
+}
+
+// ------------------------------------------------------------------------------------------------
+const char* FastXMLReader::getNodeName() const
+{
+	return mName;
+}
+
+// ------------------------------------------------------------------------------------------------
+const char* FastXMLReader::getNodeData() const
+{
+	// IrrXML returns the same string for both
+	return mName;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool FastXMLReader::isEmptyElement() const
+{
+	return mIsEmpty;
+}
+
+// ------------------------------------------------------------------------------------------------
+ETEXT_FORMAT FastXMLReader::getSourceFormat() const
+{
+	return ETF_UTF8;
+}
+
+// ------------------------------------------------------------------------------------------------
+ETEXT_FORMAT FastXMLReader::getParserFormat() const
+{
+	return ETF_UTF8;
+}
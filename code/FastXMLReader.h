@@ -0,0 +1,237 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2012, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms, 
+with or without modification, are permitted provided that the 
+following conditions are met:
+
+* Redistributions of source code must retain the above
+copyright notice, this list of conditions and the
+following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the
+following disclaimer in the documentation and/or other
+materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+contributors may be used to endorse or promote products
+derived from this software without specific prior
+written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  FastXMLReader.h
+ *  @brief In-situ XML pull parser used by the XML based importers
+ *  (Collada, Ogre, XGL, Irrlicht).
+ */
+#ifndef INCLUDED_AI_FAST_XML_READER_H
+#define INCLUDED_AI_FAST_XML_READER_H
+
+#include "./../contrib/irrXML/irrXML.h"
+#include "./../include/assimp/IOStream.hpp"
+
+namespace Assimp	{
+
+// ---------------------------------------------------------------------------------
+/** @brief Fast replacement for the IrrXML reader.
+ *
+ *  The reader maps the whole file into a single buffer once (after converting it
+ *  to UTF8, see BaseImporter::ConvertToUTF8) and tokenizes it in-place. Element 
+ *  names, attribute names, attribute values and text contents are never copied: 
+ *  they are terminated and, if necessary, entity-decoded inside the buffer and 
+ *  all pointers returned by the reader stay valid for the reader's whole life time.
+ *
+ *  It implements the IrrXML reader interface, so existing parsing code keeps working.
+ *  In addition it provides
+ *   - the length of every returned string, so callers can avoid strlen/strcmp,
+ *   - interned node name ids for quick dispatching. Callers can pass a table of
+ *     names they are interested in to the constructor, the ids of these names 
+ *     are their indices in the table. Other names receive ids in order of their
+ *     first occurence.
+ *
+ *  Large text contents such as Collada <float_array>s are therefore available as
+ *  a single zero-terminated range which can be handed to the number parsers in 
+ *  fast_atof.h directly.
+ *
+ *  @code
+ *  static const char* names[] = {"mesh","source"};
+ *  FastXMLReader reader(stream, names, 2);
+ *  while (reader.read()) {
+ *    if (reader.getNodeType() == irr::io::EXN_ELEMENT && reader.getNodeId() == 1) { ... }
+ *  }
+ *  @endcode
+ **/
+class FastXMLReader 
+	: public irr::io::IrrXMLReader
+{
+public:
+
+	/** Id returned by #getNodeId for nodes which don't carry a name */
+	static const unsigned int INVALID_ID = 0xffffffff;
+
+	// ----------------------------------------------------------------------------------
+	/** Construction from an existing IOStream. The stream is read completely,
+	 *  it is not needed anymore after the constructor returns.
+	 *  @param stream Input stream
+	 *  @param names Optional list of node names to be interned upfront
+	 *  @param numNames Number of entries in names */
+	FastXMLReader(IOStream* stream, const char* const* names = NULL, unsigned int numNames = 0);
+
+	// ----------------------------------------------------------------------------------
+	~FastXMLReader();
+
+public:
+
+	// IIrrXMLReader interface
+	bool read();
+	irr::io::EXML_NODE getNodeType() const;
+	int getAttributeCount() const;
+	const char* getAttributeName(int idx) const;
+	const char* getAttributeValue(int idx) const;
+	const char* getAttributeValue(const char* name) const;
+	const char* getAttributeValueSafe(const char* name) const;
+	int getAttributeValueAsInt(const char* name) const;
+	int getAttributeValueAsInt(int idx) const;
+	float getAttributeValueAsFloat(const char* name) const;
+	float getAttributeValueAsFloat(int idx) const;
+	const char* getNodeName() const;
+	const char* getNodeData() const;
+	bool isEmptyElement() const;
+	irr::io::ETEXT_FORMAT getSourceFormat() const;
+	irr::io::ETEXT_FORMAT getParserFormat() const;
+
+public:
+
+	// ----------------------------------------------------------------------------------
+	/** Returns the length of the string returned by getNodeName() */
+	unsigned int getNodeNameLength() const {
+		return mNameLength;
+	}
+
+	// ----------------------------------------------------------------------------------
+	/** Returns the length of the string returned by getNodeData() */
+	unsigned int getNodeDataLength() const {
+		return mNameLength;
+	}
+
+	// ----------------------------------------------------------------------------------
+	/** Returns the interned id of the current node's name for EXN_ELEMENT and 
+	 *  EXN_ELEMENT_END nodes, INVALID_ID for all other node types. */
+	unsigned int getNodeId() const {
+		return mNodeId;
+	}
+
+	// ----------------------------------------------------------------------------------
+	/** Returns the length of the value of the idx'th attribute */
+	unsigned int getAttributeValueLength(int idx) const;
+
+	// ----------------------------------------------------------------------------------
+	/** Returns the index of the named attribute or -1 if the current element
+	 *  doesn't carry such an attribute */
+	int findAttribute(const char* name) const;
+
+	// ----------------------------------------------------------------------------------
+	/** Checks whether the name of the current node equals the given string.
+	 *  Cheaper than strcmp(getNodeName(),name) since the lengths are compared first. */
+	bool isNodeName(const char* name, unsigned int length) const {
+		return length == mNameLength && !::memcmp(mName,name,length);
+	}
+
+	// ----------------------------------------------------------------------------------
+	/** Interns a name and returns its id. Node ids returned by getNodeId()
+	 *  can be compared with the result. */
+	unsigned int internName(const char* name, unsigned int length);
+
+public:
+
+	struct Attribute
+	{
+		const char* name;
+		unsigned int nameLength;
+		const char* value;
+		unsigned int valueLength;
+	};
+
+	/** Snapshot of an opening element whose contents have been skipped
+	 *  using #deferElement. */
+	struct ElementMark
+	{
+		const char* name;
+		unsigned int nameLength;
+		unsigned int nodeId;
+		bool isEmpty;
+		std::vector<Attribute> attributes;
+
+		/** Raw, not yet tokenized contents of the element including 
+		 *  its closing tag. Valid until the element is restored. */
+		const char* contentsBegin, *contentsEnd;
+	};
+
+	// ----------------------------------------------------------------------------------
+	/** Skips the contents of the current EXN_ELEMENT node without tokenizing
+	 *  them, the reader is left at the matching EXN_ELEMENT_END node. The 
+	 *  buffer region spanned by the element is not modified, so the element
+	 *  can be parsed later by passing the filled mark to #restoreElement.
+	 *  @param mark Receives the state needed to restore the element */
+	void deferElement(ElementMark& mark);
+
+	// ----------------------------------------------------------------------------------
+	/** Makes an element previously skipped by #deferElement the current node 
+	 *  again. Subsequent calls to read() return its contents, followed by 
+	 *  whatever follows the element in the file. Each mark may be restored once.*/
+	void restoreElement(const ElementMark& mark);
+
+private:
+
+	void parseTag();
+	void parseOpeningElement();
+	void parseClosingElement();
+	void parseSpecial();
+
+	char* decodeEntities(char* begin, char* end);
+	void throwUnexpectedEOF() const;
+
+private:
+
+	// in-situ buffer, zero-terminated
+	std::vector<char> mData;
+	char* mCur, *mEnd;
+
+	// there's a tag at mCur whose leading '<' has been overwritten
+	bool mPendingTag;
+
+	// current node 
+	irr::io::EXML_NODE mType;
+	const char* mName;
+	unsigned int mNameLength;
+	unsigned int mNodeId;
+	bool mIsEmpty;
+	std::vector<Attribute> mAttributes;
+
+	// name interning: open-addressing hash table of 1-based ids
+	std::vector<std::string> mInterned;
+	std::vector<unsigned int> mHashTable;
+
+}; // ! class FastXMLReader
+
+} // ! Assimp
+
+#endif // !! INCLUDED_AI_FAST_XML_READER_H
@@ -51,6 +51,26 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 using namespace Assimp;
 
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Check whether two vertices of a mesh share their position, in all frames of its vertex animation
+bool SamePosition(const aiMesh* mesh, unsigned int a, unsigned int b)
+{
+	if (mesh->mVertices[a] != mesh->mVertices[b]) {
+		return false;
+	}
+	for (unsigned int i = 0; i < mesh->mNumAnimMeshes; ++i) {
+		const aiAnimMesh* anim = mesh->mAnimMeshes[i];
+		if (anim->HasPositions() && anim->mVertices[a] != anim->mVertices[b]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+} // end of anonymous namespace
+
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 FindDegeneratesProcess::FindDegeneratesProcess()
@@ -118,7 +138,7 @@ void FindDegeneratesProcess::ExecuteOnMesh( aiMesh* mesh)
 
 			for (register unsigned int t = i+1; t < limit; ++t)
 			{
-				if (mesh->mVertices[face.mIndices[i]] == mesh->mVertices[face.mIndices[t]])
+				if (SamePosition(mesh,face.mIndices[i],face.mIndices[t]))
 				{
 					// we have found a matching vertex position
 					// remove the corresponding index from the array
@@ -143,8 +143,10 @@ void FindInstancesProcess::Execute( aiScene* pScene)
 					
 					// check for hash collision .. we needn't check
 					// the vertex format, it *must* match due to the
-					// (brilliant) construction of the hash
-					if (orig->mNumBones       != inst->mNumBones      ||
+					// (brilliant) construction of the hash. Meshes with
+					// vertex animations are referenced by name, so leave them alone.
+					if (orig->mNumAnimMeshes  || inst->mNumAnimMeshes ||
+						orig->mNumBones       != inst->mNumBones      ||
 						orig->mNumFaces       != inst->mNumFaces      ||
 						orig->mNumVertices    != inst->mNumVertices   ||
 						orig->mMaterialIndex  != inst->mMaterialIndex ||
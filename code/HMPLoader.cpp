@@ -47,6 +47,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // internal headers
 #include "HMPLoader.h"
 #include "MD2FileData.h"
+#include "HeightfieldBuilder.h"
 
 using namespace Assimp;
 
@@ -66,6 +67,9 @@ static const aiImporterDesc desc = {
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 HMPImporter::HMPImporter()
+: configSharedVertices (false)
+, configTileSize (0)
+, configLODLevels (1)
 {
 	// nothing to do here
 }
@@ -103,6 +107,18 @@ const aiImporterDesc* HMPImporter::GetInfo () const
 	return &desc;
 }
 
+// ------------------------------------------------------------------------------------------------
+// Setup configuration properties
+void HMPImporter::SetupProperties(const Importer* pImp)
+{
+	MDLImporter::SetupProperties(pImp);
+
+	// AI_CONFIG_IMPORT_TERRAIN_XXX
+	configSharedVertices = pImp->GetPropertyBool(AI_CONFIG_IMPORT_TERRAIN_SHARED_VERTICES,false);
+	configTileSize = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_TERRAIN_TILE_SIZE,0);
+	configLODLevels = std::max(1,pImp->GetPropertyInteger(AI_CONFIG_IMPORT_TERRAIN_LOD_LEVELS,1));
+}
+
 // ------------------------------------------------------------------------------------------------
 // Imports the given file into the given scene structure. 
 void HMPImporter::InternReadFile( const std::string& pFile, 
@@ -249,16 +265,8 @@ void HMPImporter::InternReadFile_HMP5( )
 	if (pcHeader->numskins)
 		GenerateTextureCoords(width,height);
 
-	// now build a list of faces
-	CreateOutputFaceList(width,height);	
-
-	// there is no nodegraph in HMP files. Simply assign the one mesh
-	// (no, not the one ring) to the root node
-	pScene->mRootNode = new aiNode();
-	pScene->mRootNode->mName.Set("terrain_root");
-	pScene->mRootNode->mNumMeshes = 1;
-	pScene->mRootNode->mMeshes = new unsigned int[1];
-	pScene->mRootNode->mMeshes[0] = 0;
+	// now build a list of faces and the node graph
+	CreateOutputScene(width,height);
 }
 
 // ------------------------------------------------------------------------------------------------ 
@@ -318,16 +326,8 @@ void HMPImporter::InternReadFile_HMP7( )
 	// generate texture coordinates if necessary
 	if (pcHeader->numskins)GenerateTextureCoords(width,height);
 
-	// now build a list of faces
-	CreateOutputFaceList(width,height);	
-
-	// there is no nodegraph in HMP files. Simply assign the one mesh
-	// (no, not the One Ring) to the root node
-	pScene->mRootNode = new aiNode();
-	pScene->mRootNode->mName.Set("terrain_root");
-	pScene->mRootNode->mNumMeshes = 1;
-	pScene->mRootNode->mMeshes = new unsigned int[1];
-	pScene->mRootNode->mMeshes[0] = 0;
+	// now build a list of faces and the node graph
+	CreateOutputScene(width,height);
 }
 
 // ------------------------------------------------------------------------------------------------ 
@@ -437,6 +437,48 @@ void HMPImporter::CreateOutputFaceList(unsigned int width,unsigned int height)
 	}
 }
 
+// ------------------------------------------------------------------------------------------------ 
+void HMPImporter::CreateOutputScene(unsigned int width,unsigned int height)
+{
+	// there is no nodegraph in HMP files. Simply assign the one mesh
+	// (no, not the One Ring) or the terrain tiles to the root node
+	pScene->mRootNode = new aiNode();
+	pScene->mRootNode->mName.Set("terrain_root");
+
+	if (!configSharedVertices && !configTileSize) {
+		CreateOutputFaceList(width,height);
+
+		pScene->mRootNode->mNumMeshes = 1;
+		pScene->mRootNode->mMeshes = new unsigned int[1];
+		pScene->mRootNode->mMeshes[0] = 0;
+		return;
+	}
+
+	// the mesh still holds one vertex per height sample, build indexed meshes from it
+	aiMesh* const grid = pScene->mMeshes[0];
+	HeightfieldBuilder builder(width,height,grid->mVertices,grid->mNormals,grid->mTextureCoords[0]);
+
+	std::vector<aiMesh*> meshes;
+	if (configTileSize) {
+		builder.BuildTiles(configTileSize,configLODLevels,pScene->mRootNode,meshes);
+	}
+	else {
+		meshes.push_back(builder.BuildMesh());
+
+		pScene->mRootNode->mNumMeshes = 1;
+		pScene->mRootNode->mMeshes = new unsigned int[1];
+		pScene->mRootNode->mMeshes[0] = 0;
+	}
+	delete grid;
+
+	delete[] pScene->mMeshes;
+	pScene->mMeshes = new aiMesh*[pScene->mNumMeshes = static_cast<unsigned int>(meshes.size())];
+	std::copy(meshes.begin(),meshes.end(),pScene->mMeshes);
+
+	// faces share their vertices now
+	pScene->mFlags |= AI_SCENE_FLAGS_NON_VERBOSE_FORMAT;
+}
+
 // ------------------------------------------------------------------------------------------------ 
 void HMPImporter::ReadFirstSkin(unsigned int iNumSkins, const unsigned char* szCursor,
 	const unsigned char** szCursorOut)
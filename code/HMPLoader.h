@@ -92,6 +92,13 @@ protected:
 	void InternReadFile( const std::string& pFile, aiScene* pScene, 
 		IOSystem* pIOHandler);
 
+	// -------------------------------------------------------------------
+	/** Called prior to ReadFile().
+	* The function is a request to the importer to update its configuration
+	* basing on the Importer's configuration property list.
+	*/
+	void SetupProperties(const Importer* pImp);
+
 protected:
 
 	// -------------------------------------------------------------------
@@ -129,6 +136,14 @@ protected:
 	*/
 	void CreateOutputFaceList(unsigned int width,unsigned int height);
 
+	// -------------------------------------------------------------------
+	/** Build the output meshes and the node graph from the height map, 
+	 *  honouring the AI_CONFIG_IMPORT_TERRAIN_XXX settings.
+	 * \param width Width of the height field
+	 * \param height Height of the height field
+	*/
+	void CreateOutputScene(unsigned int width,unsigned int height);
+
 	// -------------------------------------------------------------------
 	/** Generate planar texture coordinates for a terrain
 	 * \param width Width of the terrain, in vertices
@@ -147,6 +162,9 @@ protected:
 
 private:
 
+	/** Configuration options, see AI_CONFIG_IMPORT_TERRAIN_XXX */
+	bool configSharedVertices;
+	unsigned int configTileSize, configLODLevels;
 };
 
 } // end of namespace Assimp
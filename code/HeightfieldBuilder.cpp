@@ -0,0 +1,273 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2012, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms, 
+with or without modification, are permitted provided that the 
+following conditions are met:
+
+* Redistributions of source code must retain the above
+copyright notice, this list of conditions and the
+following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the
+following disclaimer in the documentation and/or other
+materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+contributors may be used to endorse or promote products
+derived from this software without specific prior
+written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  HeightfieldBuilder.cpp
+ *  @brief Implementation of a little class to build indexed meshes and tiles from height fields
+ */
+
+#include "AssimpPCH.h"
+#include "../include/assimp/scene.h"
+#include "HeightfieldBuilder.h"
+#include "TinyFormatter.h"
+
+using namespace Assimp;
+using namespace Assimp::Formatter;
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Get the sample coordinates along one axis of a rectangle, always including both ends
+void GetSampleCoords(unsigned int a0, unsigned int a1, unsigned int step, std::vector<unsigned int>& out)
+{
+	out.clear();
+	for (unsigned int a = a0; a < a1; a += step) {
+		out.push_back(a);
+	}
+	out.push_back(a1);
+}
+
+}
+
+// ------------------------------------------------------------------------------------------------
+HeightfieldBuilder::HeightfieldBuilder(unsigned int width, unsigned int height,
+	const aiVector3D* positions,
+	const aiVector3D* normals,
+	const aiVector3D* uvs)
+
+	: mWidth(width)
+	, mHeight(height)
+	, mPositions(positions)
+	, mNormals(normals)
+	, mUVs(uvs)
+{
+	ai_assert(width > 1 && height > 1 && positions);
+}
+
+// ------------------------------------------------------------------------------------------------
+aiMesh* HeightfieldBuilder::BuildMesh() const
+{
+	return BuildMesh(0,0,mWidth-1,mHeight-1,1,0.f);
+}
+
+// ------------------------------------------------------------------------------------------------
+aiMesh* HeightfieldBuilder::BuildMesh(unsigned int x0, unsigned int y0,
+	unsigned int x1, unsigned int y1,
+	unsigned int step, float skirt) const
+{
+	ai_assert(x0 < x1 && x1 < mWidth && y0 < y1 && y1 < mHeight && step);
+
+	std::vector<unsigned int> xs, ys;
+	GetSampleCoords(x0,x1,step,xs);
+	GetSampleCoords(y0,y1,step,ys);
+
+	const unsigned int nx = static_cast<unsigned int>(xs.size()), ny = static_cast<unsigned int>(ys.size());
+	const unsigned int numGrid = nx*ny;
+
+	// the tile border, in the same order the vertices of each quad are specified.
+	// Each skirt vertex is a lowered copy of one of these grid vertices.
+	std::vector<unsigned int> border;
+	if (skirt > 0.f) {
+		border.reserve(2*(nx+ny));
+		for (unsigned int y = 0; y < ny; ++y) {
+			border.push_back(y*nx);
+		}
+		for (unsigned int x = 0; x < nx; ++x) {
+			border.push_back((ny-1)*nx+x);
+		}
+		for (unsigned int y = ny; y > 0; --y) {
+			border.push_back((y-1)*nx+nx-1);
+		}
+		for (unsigned int x = nx; x > 0; --x) {
+			border.push_back(x-1);
+		}
+	}
+
+	aiMesh* const mesh = new aiMesh();
+	mesh->mPrimitiveTypes = aiPrimitiveType_POLYGON;
+	mesh->mNumVertices = numGrid + static_cast<unsigned int>(border.size());
+	mesh->mVertices = new aiVector3D[mesh->mNumVertices];
+	if (mNormals) {
+		mesh->mNormals = new aiVector3D[mesh->mNumVertices];
+	}
+	if (mUVs) {
+		mesh->mTextureCoords[0] = new aiVector3D[mesh->mNumVertices];
+		mesh->mNumUVComponents[0] = 2;
+	}
+
+	// copy the samples
+	unsigned int v = 0;
+	for (unsigned int y = 0; y < ny; ++y) {
+		for (unsigned int x = 0; x < nx; ++x, ++v) {
+			const unsigned int src = ys[y]*mWidth+xs[x];
+
+			mesh->mVertices[v] = mPositions[src];
+			if (mNormals) {
+				mesh->mNormals[v] = mNormals[src];
+			}
+			if (mUVs) {
+				mesh->mTextureCoords[0][v] = mUVs[src];
+			}
+		}
+	}
+
+	// and add the skirt vertices
+	for (std::vector<unsigned int>::const_iterator it = border.begin(); it != border.end(); ++it, ++v) {
+		mesh->mVertices[v] = mesh->mVertices[*it];
+		mesh->mVertices[v].z -= skirt;
+
+		if (mNormals) {
+			mesh->mNormals[v] = mesh->mNormals[*it];
+		}
+		if (mUVs) {
+			mesh->mTextureCoords[0][v] = mesh->mTextureCoords[0][*it];
+		}
+	}
+
+	// Build the faces, the winding order is the same as in the classic terrain output.
+	// Skirt quads reference their border edge in the opposite direction.
+	const unsigned int numSkirtFaces = border.size() ? static_cast<unsigned int>(border.size()) - 4 : 0;
+	mesh->mNumFaces = (nx-1)*(ny-1) + numSkirtFaces;
+	aiFace* f = mesh->mFaces = new aiFace[mesh->mNumFaces];
+
+	for (unsigned int y = 0; y < ny-1; ++y) {
+		for (unsigned int x = 0; x < nx-1; ++x, ++f) {
+			unsigned int* const idx = f->mIndices = new unsigned int[f->mNumIndices = 4];
+			idx[0] = y*nx+x;
+			idx[1] = (y+1)*nx+x;
+			idx[2] = (y+1)*nx+x+1;
+			idx[3] = y*nx+x+1;
+		}
+	}
+
+	// the border consists of four runs, one per side, with no edge between two runs
+	if (!border.empty()) {
+		const unsigned int runs[4] = {ny, nx, ny, nx};
+		for (unsigned int r = 0, b = 0; r < 4; b += runs[r++]) {
+			for (unsigned int i = b; i < b+runs[r]-1; ++i, ++f) {
+				unsigned int* const idx = f->mIndices = new unsigned int[f->mNumIndices = 4];
+				idx[0] = border[i+1];
+				idx[1] = border[i];
+				idx[2] = numGrid+i;
+				idx[3] = numGrid+i+1;
+			}
+		}
+	}
+
+	ai_assert(f == mesh->mFaces + mesh->mNumFaces);
+	return mesh;
+}
+
+// ------------------------------------------------------------------------------------------------
+void HeightfieldBuilder::BuildTiles(unsigned int tileSize, unsigned int numLevels,
+	aiNode* parent, std::vector<aiMesh*>& meshes) const
+{
+	ai_assert(tileSize && numLevels && parent);
+
+	const unsigned int tilesX = (mWidth-2)/tileSize+1, tilesY = (mHeight-2)/tileSize+1;
+
+	std::vector<aiNode*> tiles;
+	tiles.reserve(tilesX*tilesY);
+
+	for (unsigned int ty = 0; ty < tilesY; ++ty) {
+		for (unsigned int tx = 0; tx < tilesX; ++tx) {
+			const unsigned int x0 = tx*tileSize, x1 = std::min(x0+tileSize,mWidth-1);
+			const unsigned int y0 = ty*tileSize, y1 = std::min(y0+tileSize,mHeight-1);
+
+			// compute the bounds of the tile, its height range determines the skirt depth
+			aiVector3D min = mPositions[y0*mWidth+x0], max = min;
+			for (unsigned int y = y0; y <= y1; ++y) {
+				for (unsigned int x = x0; x <= x1; ++x) {
+					const aiVector3D& p = mPositions[y*mWidth+x];
+
+					min.x = std::min(min.x,p.x); max.x = std::max(max.x,p.x);
+					min.y = std::min(min.y,p.y); max.y = std::max(max.y,p.y);
+					min.z = std::min(min.z,p.z); max.z = std::max(max.z,p.z);
+				}
+			}
+			const float skirt = numLevels > 1 ? max.z - min.z : 0.f;
+			min.z -= skirt;
+
+			aiNode* const nd = new aiNode();
+			nd->mName.Set((format(),"tile_",tx,"_",ty));
+			nd->mParent = parent;
+			tiles.push_back(nd);
+
+			aiMetadata* const data = nd->mMetaData = new aiMetadata();
+			data->mNumProperties = 2;
+			data->mKeys = new aiString[data->mNumProperties]();
+			data->mValues = new aiMetadataEntry[data->mNumProperties]();
+			data->Set(0, "BoundsMin", min);
+			data->Set(1, "BoundsMax", max);
+
+			if (numLevels < 2) {
+				nd->mMeshes = new unsigned int[nd->mNumMeshes = 1];
+				nd->mMeshes[0] = static_cast<unsigned int>(meshes.size());
+				meshes.push_back(BuildMesh(x0,y0,x1,y1,1,skirt));
+				meshes.back()->mName = nd->mName;
+				continue;
+			}
+
+			// one child per level, including the full-resolution one, so that the levels
+			// are alternatives of each other and the tile node itself draws nothing.
+			nd->mChildren = new aiNode*[nd->mNumChildren = numLevels];
+			for (unsigned int l = 0; l < numLevels; ++l) {
+				aiNode* const lod = nd->mChildren[l] = new aiNode();
+				lod->mName.Set((format(),nd->mName.data,"_lod",l));
+				lod->mParent = nd;
+
+				lod->mMeshes = new unsigned int[lod->mNumMeshes = 1];
+				lod->mMeshes[0] = static_cast<unsigned int>(meshes.size());
+				meshes.push_back(BuildMesh(x0,y0,x1,y1,1u << std::min(l,31u),skirt));
+				meshes.back()->mName = lod->mName;
+			}
+		}
+	}
+
+	// append the tiles to the parent's children
+	aiNode** const children = new aiNode*[parent->mNumChildren + tiles.size()];
+	if (parent->mNumChildren) {
+		std::copy(parent->mChildren,parent->mChildren+parent->mNumChildren,children);
+	}
+	std::copy(tiles.begin(),tiles.end(),children+parent->mNumChildren);
+
+	delete[] parent->mChildren;
+	parent->mChildren = children;
+	parent->mNumChildren += static_cast<unsigned int>(tiles.size());
+}
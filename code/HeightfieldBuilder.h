@@ -0,0 +1,130 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2012, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms, 
+with or without modification, are permitted provided that the 
+following conditions are met:
+
+* Redistributions of source code must retain the above
+copyright notice, this list of conditions and the
+following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the
+following disclaimer in the documentation and/or other
+materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+contributors may be used to endorse or promote products
+derived from this software without specific prior
+written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file HeightfieldBuilder.h
+ *  Declares HeightfieldBuilder, a little utility to turn regular height
+ *  fields (i.e. HMP and Terragen terrains) into indexed meshes or tiles.
+ */
+
+#ifndef AI_HEIGHTFIELDBUILDER_H_INC
+#define AI_HEIGHTFIELDBUILDER_H_INC
+
+#include <vector>
+#include "../include/assimp/mesh.h"
+
+struct aiNode;
+
+namespace Assimp	{
+
+// ---------------------------------------------------------------------------
+/**
+ * This little helper class builds meshes from a regular grid of terrain
+ * samples. In contrast to the classic terrain output of the HMP and Terragen
+ * loaders, which emits four unique vertices per quad, neighbouring quads
+ * share their vertices, so the output has exactly one vertex per sample.
+ *
+ * Large terrains can be split into square tiles, each of which may come
+ * in several levels of detail. Level n uses every 2^n-th sample of the grid
+ * (plus the tile border) and is surrounded by a skirt - a strip of quads
+ * hanging down from the tile border - which hides the cracks between tiles
+ * of different detail. The skirt is as deep as the tile's height range.
+ *
+ * The sample arrays are not copied, they must stay valid while the
+ * HeightfieldBuilder is in use. The grid lies in the xy plane, z is up.
+ */
+class HeightfieldBuilder
+{
+public:
+
+	// -------------------------------------------------------------------
+	/** @param width Number of samples in x direction, at least 2
+	 *  @param height Number of samples in y direction, at least 2
+	 *  @param positions width*height sample positions, row by row
+	 *  @param normals Per-sample normals, may be NULL
+	 *  @param uvs Per-sample texture coordinates, may be NULL */
+	HeightfieldBuilder(unsigned int width, unsigned int height,
+		const aiVector3D* positions,
+		const aiVector3D* normals = NULL,
+		const aiVector3D* uvs = NULL);
+
+public:
+
+	// -------------------------------------------------------------------
+	/** Builds a single indexed mesh of quads from the whole grid.  */
+	aiMesh* BuildMesh() const;
+
+	// -------------------------------------------------------------------
+	/** Splits the grid into tiles and builds a node for each of them.
+	 *
+	 *  The tile nodes are added to the given parent node. Each of them
+	 *  carries the tile's bounding box in its metadata ("BoundsMin", 
+	 *  "BoundsMax"). With a single level, the tile node references its 
+	 *  mesh. Otherwise it has no meshes, and every level, including
+	 *  level 0, is attached to a child node named "<tile>_lod<n>".
+	 *  @param tileSize Number of quads per tile side
+	 *  @param numLevels Number of detail levels per tile, at least 1
+	 *  @param parent Node to receive the tile nodes
+	 *  @param meshes Receives all output meshes. Mesh indices in the
+	 *    nodes refer to this list. */
+	void BuildTiles(unsigned int tileSize, unsigned int numLevels,
+		aiNode* parent, std::vector<aiMesh*>& meshes) const;
+
+protected:
+
+	// -------------------------------------------------------------------
+	/** Builds an indexed mesh from the samples in a rectangle of the grid.
+	 *  @param x0,y0 First sample of the rectangle
+	 *  @param x1,y1 Last sample of the rectangle (inclusive)
+	 *  @param step Distance between two samples used. The last row
+	 *    and column of the rectangle are always included.
+	 *  @param skirt Depth of the skirt, 0 for no skirt */
+	aiMesh* BuildMesh(unsigned int x0, unsigned int y0,
+		unsigned int x1, unsigned int y1,
+		unsigned int step, float skirt) const;
+
+protected:
+
+	unsigned int mWidth, mHeight;
+	const aiVector3D *mPositions, *mNormals, *mUVs;
+};
+
+} // end of namespace Assimp
+
+#endif // AI_HEIGHTFIELDBUILDER_H_INC
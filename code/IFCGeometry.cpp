@@ -777,6 +777,9 @@ bool ProcessGeometricItem(const IfcRepresentationItem& geo, std::vector<unsigned
 
 	aiMesh* const mesh = meshtmp->ToMesh();
 	if(mesh) {
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+		boost::mutex::scoped_lock lock(conv.shared_mutex);
+#endif
 		mesh->mMaterialIndex = ProcessMaterials(geo,conv);
 		mesh_indices.push_back(conv.meshes.size());
 		conv.meshes.push_back(mesh);
@@ -806,24 +809,46 @@ void AssignAddedMeshes(std::vector<unsigned int>& mesh_indices,aiNode* nd,
 }
 
 // ------------------------------------------------------------------------------------------------
+// Products may be converted concurrently, see ProcessContainedProducts(). If there is no cache
+// entry for the item yet, the caller reserves it and must convert the item and then call 
+// PopulateMeshCache(). Other threads asking for the item meanwhile wait for that, so every item
+// is converted only once.
 bool TryQueryMeshCache(const IfcRepresentationItem& item, 
 	std::vector<unsigned int>& mesh_indices, 
 	ConversionData& conv) 
 {
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+	boost::mutex::scoped_lock lock(conv.shared_mutex);
+	while (conv.pending_meshes.find(&item) != conv.pending_meshes.end()) {
+		conv.mesh_cache_changed.wait(lock);
+	}
+#endif
 	ConversionData::MeshCache::const_iterator it = conv.cached_meshes.find(&item);
 	if (it != conv.cached_meshes.end()) {
 		std::copy((*it).second.begin(),(*it).second.end(),std::back_inserter(mesh_indices));
 		return true;
 	}
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+	conv.pending_meshes.insert(&item);
+#endif
 	return false;
 }
 
 // ------------------------------------------------------------------------------------------------
+// Complete a reservation made by TryQueryMeshCache(). Items which yield no meshes aren't cached,
+// the next thread asking for them converts them again.
 void PopulateMeshCache(const IfcRepresentationItem& item, 
 	const std::vector<unsigned int>& mesh_indices, 
 	ConversionData& conv)
 {
-	conv.cached_meshes[&item] = mesh_indices;
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+	boost::mutex::scoped_lock lock(conv.shared_mutex);
+	conv.pending_meshes.erase(&item);
+	conv.mesh_cache_changed.notify_all();
+#endif
+	if(mesh_indices.size()) {
+		conv.cached_meshes[&item] = mesh_indices;
+	}
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -831,14 +856,25 @@ bool ProcessRepresentationItem(const IfcRepresentationItem& item,
 	std::vector<unsigned int>& mesh_indices, 
 	ConversionData& conv)
 {
+	const size_t first = mesh_indices.size();
 	if (!TryQueryMeshCache(item,mesh_indices,conv)) {
-		if(ProcessGeometricItem(item,mesh_indices,conv)) {
-			if(mesh_indices.size()) {
-				PopulateMeshCache(item,mesh_indices,conv);
-			}
+		bool res;
+		try {
+			res = ProcessGeometricItem(item,mesh_indices,conv);
+		}
+		catch(...) {
+			// don't leave other threads waiting for this item
+			PopulateMeshCache(item,std::vector<unsigned int>(),conv);
+			throw;
+		}
+
+		PopulateMeshCache(item,res ? mesh_indices : std::vector<unsigned int>(),conv);
+		if(!res) {
+			return false;
 		}
-		else return false;
 	}
+
+	conv.mesh_order.insert(conv.mesh_order.end(),mesh_indices.begin()+first,mesh_indices.end());
 	return true;
 }
 
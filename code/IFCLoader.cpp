@@ -59,6 +59,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "StreamReader.h"
 #include "MemoryIOWrapper.h"
+#include "ParallelFor.h"
 
 namespace Assimp {
 	template<> const std::string LogFunctions<IFCImporter>::log_prefix = "IFC: ";
@@ -89,7 +90,7 @@ namespace {
 void SetUnits(ConversionData& conv);
 void SetCoordinateSpace(ConversionData& conv);
 void ProcessSpatialStructures(ConversionData& conv);
-aiNode* ProcessSpatialStructure(aiNode* parent, const IfcProduct& el ,ConversionData& conv);
+aiNode* ProcessSpatialStructure(aiNode* parent, const IfcProduct& el ,ConversionData& conv, std::vector<TempOpening>* collect_openings);
 void ProcessProductRepresentation(const IfcProduct& el, aiNode* nd, ConversionData& conv);
 void MakeTreeRelative(ConversionData& conv);
 void ConvertUnit(const EXPRESS::DataType& dt,ConversionData& conv);
@@ -665,6 +666,163 @@ void ProcessMetadata(uint64_t relDefinesByPropertiesID, ConversionData& conv, Me
 	}
 }
 
+// ------------------------------------------------------------------------------------------------
+void RemapMeshIndices(aiNode* nd, const std::vector<unsigned int>& remap, unsigned int mesh_base)
+{
+	for(unsigned int i = 0; i < nd->mNumMeshes; ++i) {
+		if (nd->mMeshes[i] >= mesh_base) {
+			nd->mMeshes[i] = remap[nd->mMeshes[i] - mesh_base];
+		}
+	}
+	std::sort(nd->mMeshes,nd->mMeshes + nd->mNumMeshes);
+
+	for(unsigned int i = 0; i < nd->mNumChildren; ++i) {
+		RemapMeshIndices(nd->mChildren[i],remap,mesh_base);
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+// Renumber the meshes from mesh_base on in the given order, the materials from material_base
+// on are renumbered in the order of the meshes using them. Mesh indices in the given node 
+// graphs and in the mesh cache are updated accordingly.
+void SortAddedMeshes(const std::vector<unsigned int>& order, const std::vector<aiNode*>& nodes, 
+	unsigned int mesh_base, unsigned int material_base, ConversionData& conv)
+{
+	const unsigned int num_meshes = static_cast<unsigned int>(conv.meshes.size()) - mesh_base;
+	std::vector<unsigned int> remap(num_meshes,UINT_MAX);
+	std::vector<aiMesh*> meshes;
+	meshes.reserve(num_meshes);
+
+	BOOST_FOREACH(unsigned int idx, order) {
+		if (idx >= mesh_base && remap[idx - mesh_base] == UINT_MAX) {
+			remap[idx - mesh_base] = mesh_base + static_cast<unsigned int>(meshes.size());
+			meshes.push_back(conv.meshes[idx]);
+		}
+	}
+	for(unsigned int i = 0; i < num_meshes; ++i) {
+		if (remap[i] == UINT_MAX) {
+			remap[i] = mesh_base + static_cast<unsigned int>(meshes.size());
+			meshes.push_back(conv.meshes[mesh_base + i]);
+		}
+	}
+	std::copy(meshes.begin(),meshes.end(),conv.meshes.begin() + mesh_base);
+
+	BOOST_FOREACH(aiNode* nd, nodes) {
+		if (nd) {
+			RemapMeshIndices(nd,remap,mesh_base);
+		}
+	}
+	for(ConversionData::MeshCache::iterator it = conv.cached_meshes.begin(); it != conv.cached_meshes.end(); ++it) {
+		BOOST_FOREACH(unsigned int& idx, (*it).second) {
+			if (idx >= mesh_base) {
+				idx = remap[idx - mesh_base];
+			}
+		}
+	}
+
+	// the default material is always the first one, see ProcessMaterials()
+	material_base = std::max(material_base,1u);
+	if (conv.materials.size() <= material_base) {
+		return;
+	}
+
+	const unsigned int num_materials = static_cast<unsigned int>(conv.materials.size()) - material_base;
+	std::vector<unsigned int> material_remap(num_materials,UINT_MAX);
+	std::vector<aiMaterial*> materials;
+	materials.reserve(num_materials);
+
+	BOOST_FOREACH(aiMesh* mesh, meshes) {
+		const unsigned int idx = mesh->mMaterialIndex;
+		if (idx >= material_base && material_remap[idx - material_base] == UINT_MAX) {
+			material_remap[idx - material_base] = material_base + static_cast<unsigned int>(materials.size());
+			materials.push_back(conv.materials[idx]);
+		}
+	}
+	for(unsigned int i = 0; i < num_materials; ++i) {
+		if (material_remap[i] == UINT_MAX) {
+			material_remap[i] = material_base + static_cast<unsigned int>(materials.size());
+			materials.push_back(conv.materials[material_base + i]);
+		}
+	}
+	std::copy(materials.begin(),materials.end(),conv.materials.begin() + material_base);
+
+	BOOST_FOREACH(aiMesh* mesh, meshes) {
+		if (mesh->mMaterialIndex >= material_base) {
+			mesh->mMaterialIndex = material_remap[mesh->mMaterialIndex - material_base];
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+// Converts a list of products, each one on a ConversionData derived from conv. Converting 
+// products is mostly independent, meshes, materials and the mesh cache are shared and 
+// guarded by ConversionData::shared_mutex.
+struct ProcessProductsJob 
+{
+	ProcessProductsJob(aiNode* parent, const std::vector<const IfcProduct*>& products, ConversionData& conv)
+		: parent(parent)
+		, products(products)
+		, conv(conv)
+		, nodes(products.size())
+		, mesh_orders(products.size())
+	{}
+
+	~ProcessProductsJob() {
+		std::for_each(nodes.begin(),nodes.end(),delete_fun<aiNode>());
+	}
+
+	void operator()(size_t i) {
+		ConversionData fork(&conv);
+		nodes[i] = ProcessSpatialStructure(parent,*products[i],fork,NULL);
+		mesh_orders[i].swap(fork.mesh_order);
+	}
+
+	aiNode* const parent;
+	const std::vector<const IfcProduct*>& products;
+	ConversionData& conv;
+
+	std::vector<aiNode*> nodes;
+	std::vector< std::vector<unsigned int> > mesh_orders;
+};
+
+// ------------------------------------------------------------------------------------------------
+void ProcessContainedProducts(aiNode* parent, const std::vector<const IfcProduct*>& products, 
+	std::vector< aiNode* >& subnodes, ConversionData& conv)
+{
+	// nested calls run concurrently with other jobs, only the outermost one needs these
+	unsigned int mesh_base = 0, material_base = 0;
+	if (!conv.parent) {
+		mesh_base = static_cast<unsigned int>(conv.meshes.size());
+		material_base = static_cast<unsigned int>(conv.materials.size());
+	}
+
+	ProcessProductsJob job(parent,products,conv);
+	ParallelFor(products.size(),job);
+
+	// The jobs add meshes in whatever order they happen to run in, and which job converts
+	// a shared representation item is up to timing as well. Collect the order in which each
+	// product asked for its meshes instead, the outermost call sorts the meshes accordingly.
+	// This gives the same output as converting the products one after another.
+	std::vector<unsigned int> order;
+	for(size_t i = 0; i < products.size(); ++i) {
+		order.insert(order.end(),job.mesh_orders[i].begin(),job.mesh_orders[i].end());
+	}
+	if (conv.parent) {
+		conv.mesh_order.insert(conv.mesh_order.end(),order.begin(),order.end());
+	}
+	else {
+		SortAddedMeshes(order,job.nodes,mesh_base,material_base,conv);
+	}
+
+	// keep the original order of the nodes
+	for(size_t i = 0; i < products.size(); ++i) {
+		if (aiNode* const nd = job.nodes[i]) {
+			subnodes.push_back(nd);
+			job.nodes[i] = NULL;
+		}
+	}
+}
+
 // ------------------------------------------------------------------------------------------------
 aiNode* ProcessSpatialStructure(aiNode* parent, const IfcProduct& el, ConversionData& conv, std::vector<TempOpening>* collect_openings = NULL)
 {
@@ -693,19 +851,14 @@ aiNode* ProcessSpatialStructure(aiNode* parent, const IfcProduct& el, Conversion
 	conv.already_processed.insert(el.GetID());
 
 	// check for node metadata
-	STEP::DB::RefMapRange children = refs.equal_range(el.GetID());
-	if (children.first!=refs.end()) {
+	STEP::DB::RefMapRange children = refs.GetReferrers(el.GetID());
+	if (children.first!=children.second) {
 		Metadata properties;
-		if (children.first==children.second) {
-			// handles single property set
-			ProcessMetadata((*children.first).second, conv, properties);
-		} 
-		else {
-			// handles multiple property sets (currently all property sets are merged,
-			// which may not be the best solution in the long run)
-			for (STEP::DB::RefMap::const_iterator it=children.first; it!=children.second; ++it) {
-				ProcessMetadata((*it).second, conv, properties);
-			}
+
+		// handles multiple property sets (currently all property sets are merged,
+		// which may not be the best solution in the long run)
+		for (STEP::DB::RefMap::const_iterator it=children.first; it!=children.second; ++it) {
+			ProcessMetadata(*it, conv, properties);
 		}
 
 		if (!properties.empty()) {
@@ -737,22 +890,25 @@ aiNode* ProcessSpatialStructure(aiNode* parent, const IfcProduct& el, Conversion
 	try {
 		// locate aggregates and 'contained-in-here'-elements of this spatial structure and add them in recursively
 		// on our way, collect openings in *this* element
-		STEP::DB::RefMapRange range = refs.equal_range(el.GetID());
+		STEP::DB::RefMapRange range = refs.GetReferrers(el.GetID());
 
 		for(STEP::DB::RefMapRange range2 = range; range2.first != range.second; ++range2.first) {
 			// skip over meshes that have already been processed before. This is strictly necessary
 			// because the reverse indices also include references contained in argument lists and
 			// therefore every element has a back-reference hold by its parent.
-			if (conv.already_processed.find((*range2.first).second) != conv.already_processed.end()) {
+			if (conv.IsProcessed(*range2.first)) {
 				continue;
 			}
-			const STEP::LazyObject& obj = conv.db.MustGetObject((*range2.first).second);
+			const STEP::LazyObject& obj = conv.db.MustGetObject(*range2.first);
 
 			// handle regularly-contained elements
 			if(const IfcRelContainedInSpatialStructure* const cont = obj->ToPtr<IfcRelContainedInSpatialStructure>()) {
 				if(cont->RelatingStructure->GetID() != el.GetID()) {
 					continue;
 				}
+				std::vector<const IfcProduct*> products;
+				products.reserve(cont->RelatedElements.size());
+
 				BOOST_FOREACH(const IfcProduct& pro, cont->RelatedElements) {		
 					if(const IfcOpeningElement* const open = pro.ToPtr<IfcOpeningElement>()) {
 						// IfcOpeningElement is handled below. Sadly we can't use it here as is:
@@ -760,12 +916,12 @@ aiNode* ProcessSpatialStructure(aiNode* parent, const IfcProduct& el, Conversion
 						// but we want them for the building elements to which they belong.
 						continue;
 					}
-					
-					aiNode* const ndnew = ProcessSpatialStructure(nd.get(),pro,conv,NULL);
-					if(ndnew) {
-						subnodes.push_back( ndnew );
-					}
+					products.push_back(&pro);
 				}
+
+				// this is where the bulk of the geometry is, and the products are independent
+				// of each other, so convert them in parallel.
+				ProcessContainedProducts(nd.get(),products,subnodes,conv);
 			}
 			// handle openings, which we collect in a list rather than adding them to the node graph
 			else if(const IfcRelVoidsElement* const fills = obj->ToPtr<IfcRelVoidsElement>()) {
@@ -809,10 +965,10 @@ aiNode* ProcessSpatialStructure(aiNode* parent, const IfcProduct& el, Conversion
 
 		for(;range.first != range.second; ++range.first) {
 			// see note in loop above
-			if (conv.already_processed.find((*range.first).second) != conv.already_processed.end()) {
+			if (conv.IsProcessed(*range.first)) {
 				continue;
 			}
-			if(const IfcRelAggregates* const aggr = conv.db.GetObject((*range.first).second)->ToPtr<IfcRelAggregates>()) {
+			if(const IfcRelAggregates* const aggr = conv.db.GetObject(*range.first)->ToPtr<IfcRelAggregates>()) {
 				if(aggr->RelatingObject->GetID() != el.GetID()) {
 					continue;
 				}
@@ -898,9 +1054,9 @@ void ProcessSpatialStructures(ConversionData& conv)
 	
 		// the primary site is referenced by an IFCRELAGGREGATES element which assigns it to the IFCPRODUCT
 		const STEP::DB::RefMap& refs = conv.db.GetRefs();
-		STEP::DB::RefMapRange range = refs.equal_range(conv.proj.GetID());
+		STEP::DB::RefMapRange range = refs.GetReferrers(conv.proj.GetID());
 		for(;range.first != range.second; ++range.first) {
-			if(const IfcRelAggregates* const aggr = conv.db.GetObject((*range.first).second)->ToPtr<IfcRelAggregates>()) {
+			if(const IfcRelAggregates* const aggr = conv.db.GetObject(*range.first)->ToPtr<IfcRelAggregates>()) {
 			
 				BOOST_FOREACH(const IfcObjectDefinition& def, aggr->RelatedObjects) {
 					// comparing pointer values is not sufficient, we would need to cast them to the same type first
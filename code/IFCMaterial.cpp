@@ -147,9 +147,9 @@ unsigned int ProcessMaterials(const IFC::IfcRepresentationItem& item, Conversion
 		conv.materials.push_back(mat.release());
 	}
 
-	STEP::DB::RefMapRange range = conv.db.GetRefs().equal_range(item.GetID());
+	STEP::DB::RefMapRange range = conv.db.GetRefs().GetReferrers(item.GetID());
 	for(;range.first != range.second; ++range.first) {
-		if(const IFC::IfcStyledItem* const styled = conv.db.GetObject((*range.first).second)->ToPtr<IFC::IfcStyledItem>()) {
+		if(const IFC::IfcStyledItem* const styled = conv.db.GetObject(*range.first)->ToPtr<IFC::IfcStyledItem>()) {
 			BOOST_FOREACH(const IFC::IfcPresentationStyleAssignment& as, styled->Styles) {
 				BOOST_FOREACH(boost::shared_ptr<const IFC::IfcPresentationStyleSelect> sel, as.Styles) {
 
@@ -210,6 +210,95 @@ bool BoundingBoxesOverlapping( const BoundingBox &ibb, const BoundingBox &bb )
 		ibb.first.y < bb.second.y && ibb.second.y > bb.first.y;
 }
 
+// ------------------------------------------------------------------------------------------------
+// Uniform grid over the [0,1]^2 projection space to quickly find the window contours whose
+// bounding boxes overlap or touch a given box, instead of testing each against everyone.
+// Contours are referenced by their index in the ContourVector.
+class ContourGrid
+{
+public:
+
+	// ------------------------------------------------------------------------------
+	explicit ContourGrid(size_t expected_contours) 
+		: res(std::max(static_cast<size_t>(1),std::min(static_cast<size_t>(64),
+			static_cast<size_t>(sqrt(static_cast<IfcFloat>(expected_contours))))))
+		, cells(res*res)
+	{}
+
+public:
+
+	// ------------------------------------------------------------------------------
+	void Insert(size_t index, const BoundingBox& bb) {
+		size_t x0, y0, x1, y1;
+		GetCellRange(bb, x0, y0, x1, y1);
+
+		for (size_t y = y0; y <= y1; ++y) {
+			for (size_t x = x0; x <= x1; ++x) {
+				cells[y*res+x].push_back(index);
+			}
+		}
+	}
+
+	// ------------------------------------------------------------------------------
+	void Insert(const ContourVector& contours) {
+		for (size_t i = 0; i < contours.size(); ++i) {
+			if (!contours[i].IsInvalid()) {
+				Insert(i, contours[i].bb);
+			}
+		}
+	}
+
+	// ------------------------------------------------------------------------------
+	void Clear() {
+		BOOST_FOREACH(std::vector<size_t>& cell, cells) {
+			cell.clear();
+		}
+	}
+
+	// ------------------------------------------------------------------------------
+	/** Get the sorted indices of all contours which may overlap bb or be adjacent 
+	 *  to it (see BoundingBoxesAdjacent()). This is a superset, the caller still
+	 *  needs to check each of them. */
+	void Query(const BoundingBox& bb, std::vector<size_t>& out) const {
+		const IfcFloat epsilon = 1e-5f;
+		size_t x0, y0, x1, y1;
+		GetCellRange(BoundingBox(bb.first - IfcVector2(epsilon,epsilon), 
+			bb.second + IfcVector2(epsilon,epsilon)), x0, y0, x1, y1);
+
+		out.clear();
+		for (size_t y = y0; y <= y1; ++y) {
+			for (size_t x = x0; x <= x1; ++x) {
+				const std::vector<size_t>& cell = cells[y*res+x];
+				out.insert(out.end(),cell.begin(),cell.end());
+			}
+		}
+
+		std::sort(out.begin(),out.end());
+		out.erase(std::unique(out.begin(),out.end()),out.end());
+	}
+
+private:
+
+	// ------------------------------------------------------------------------------
+	size_t GetCell(IfcFloat f) const {
+		const IfcFloat v = f * res;
+		return v <= 0 ? 0 : std::min(res-1, static_cast<size_t>(v));
+	}
+
+	// ------------------------------------------------------------------------------
+	void GetCellRange(const BoundingBox& bb, size_t& x0, size_t& y0, size_t& x1, size_t& y1) const {
+		x0 = GetCell(bb.first.x);
+		y0 = GetCell(bb.first.y);
+		x1 = std::max(x0, GetCell(bb.second.x));
+		y1 = std::max(y0, GetCell(bb.second.y));
+	}
+
+private:
+
+	const size_t res;
+	std::vector< std::vector<size_t> > cells;
+};
+
 // ------------------------------------------------------------------------------------------------
 bool IsDuplicateVertex(const IfcVector2& vv, const std::vector<IfcVector2>& temp_contour)
 {
@@ -675,7 +764,8 @@ bool IntersectingLineSegments(const IfcVector2& n0, const IfcVector2& n1,
 }
 
 // ------------------------------------------------------------------------------------------------
-void FindAdjacentContours(ContourVector::iterator current, const ContourVector& contours)
+void FindAdjacentContours(ContourVector::iterator current, const ContourVector& contours,
+	const ContourGrid& grid)
 {
 	const IfcFloat sqlen_epsilon = static_cast<IfcFloat>(1e-8);
 	const BoundingBox& bb = (*current).bb;
@@ -686,7 +776,13 @@ void FindAdjacentContours(ContourVector::iterator current, const ContourVector&
 
 	// First step to find possible adjacent contours is to check for adjacent bounding
 	// boxes. If the bounding boxes are not adjacent, the contours lines cannot possibly be.
-	for (ContourVector::const_iterator it = contours.begin(), end = contours.end(); it != end; ++it) {
+	// The grid gives us the candidates in their original order, which includes the
+	// current contour itself.
+	std::vector<size_t> candidates;
+	grid.Query(bb, candidates);
+
+	BOOST_FOREACH(size_t index, candidates) {
+		const ContourVector::const_iterator it = contours.begin() + index;
 		if ((*it).IsInvalid()) {
 			continue;
 		}
@@ -860,6 +956,9 @@ size_t CloseWindows(ContourVector& contours,
 	// The code is based on the assumption that this happens symmetrically
 	// on both sides of the wall. If it doesn't (which would be a bug anyway)
 	// wrong geometry may be generated.
+	ContourGrid grid(contours.size());
+	grid.Insert(contours);
+
 	for (ContourVector::iterator it = contours.begin(), end = contours.end(); it != end; ++it) {
 		if ((*it).IsInvalid()) {
 			continue;
@@ -883,7 +982,7 @@ size_t CloseWindows(ContourVector& contours,
 			// those bordering the outer frame.
 			(*it).PrepareSkiplist();
 
-			FindAdjacentContours(it, contours);
+			FindAdjacentContours(it, contours, grid);
 			FindBorderContours(it);
 
 			// if the window is the result of a finite union or intersection of rectangles,
@@ -1165,6 +1264,8 @@ bool GenerateOpenings(std::vector<TempOpening>& openings,
 
 	// Compute bounding boxes for all 2D openings in projection space
 	ContourVector contours;
+	ContourGrid grid(openings.size());
+	std::vector<size_t> candidates;
 
 	std::vector<IfcVector2> temp_contour;
 	std::vector<IfcVector2> temp_contour2;
@@ -1241,7 +1342,7 @@ bool GenerateOpenings(std::vector<TempOpening>& openings,
 
 			bool side_flag = true;
 			if (!is_2d_source) {
-				const IfcVector3& face_nor = ((profile_verts[vi_total+2] - profile_verts[vi_total]) ^
+				const IfcVector3 face_nor = ((profile_verts[vi_total+2] - profile_verts[vi_total]) ^
 					(profile_verts[vi_total+1] - profile_verts[vi_total])).Normalize();
 
 				const IfcFloat abs_dot_face_nor = abs(nor * face_nor);
@@ -1318,73 +1419,101 @@ bool GenerateOpenings(std::vector<TempOpening>& openings,
 		bool is_rectangle = temp_contour.size() == 4;
 
 		// See if this BB intersects or is in close adjacency to any other BB we have so far.
-		for (ContourVector::iterator it = contours.begin(); it != contours.end(); ) {
+		// Contours merged into the new one are only flagged as invalid until we are done
+		// with it, so the indices in the grid remain valid.
+		bool removed_contours = false;
+		for (size_t first = 0;;) {
+
+			// find the first contour from first on which overlaps bb
+			grid.Query(bb, candidates);
+
+			ContourVector::iterator it = contours.end();
+			BOOST_FOREACH(size_t index, candidates) {
+				if (index >= first && !contours[index].IsInvalid() && BoundingBoxesOverlapping(contours[index].bb, bb)) {
+					it = contours.begin() + index;
+					break;
+				}
+			}
+			if (it == contours.end()) {
+				break;
+			}
+			first = std::distance(contours.begin(),it);
+
 			const BoundingBox& ibb = (*it).bb;
 
-			if (BoundingBoxesOverlapping(ibb, bb)) {
+			if (!(*it).is_rectangular) {
+				is_rectangle = false;
+			}
+
+			const std::vector<IfcVector2>& other = (*it).contour;
+			ClipperLib::ExPolygons poly;
 
-				if (!(*it).is_rectangular) {
-					is_rectangle = false;
-				}
+			// First check whether subtracting the old contour (to which ibb belongs)
+			// from the new contour (to which bb belongs) yields an updated bb which
+			// no longer overlaps ibb
+			MakeDisjunctWindowContours(other, temp_contour, poly);
+			if(poly.size() == 1) {
+				
+				const BoundingBox& newbb = GetBoundingBox(poly[0].outer);
+				if (!BoundingBoxesOverlapping(ibb, newbb )) {
+					 // Good guy bounding box
+					 bb = newbb ;
 
-				const std::vector<IfcVector2>& other = (*it).contour;
-				ClipperLib::ExPolygons poly;
-
-				// First check whether subtracting the old contour (to which ibb belongs)
-				// from the new contour (to which bb belongs) yields an updated bb which
-				// no longer overlaps ibb
-				MakeDisjunctWindowContours(other, temp_contour, poly);
-				if(poly.size() == 1) {
-					
-					const BoundingBox& newbb = GetBoundingBox(poly[0].outer);
-					if (!BoundingBoxesOverlapping(ibb, newbb )) {
-						 // Good guy bounding box
-						 bb = newbb ;
-
-						 ExtractVerticesFromClipper(poly[0].outer, temp_contour, false);
-						 continue;
-					}
+					 ExtractVerticesFromClipper(poly[0].outer, temp_contour, false);
+					 continue;
 				}
+			}
 
-				// Take these two overlapping contours and try to merge them. If they 
-				// overlap (which should not happen, but in fact happens-in-the-real-
-				// world [tm] ), resume using a single contour and a single bounding box.
-				MergeWindowContours(temp_contour, other, poly);
+			// Take these two overlapping contours and try to merge them. If they 
+			// overlap (which should not happen, but in fact happens-in-the-real-
+			// world [tm] ), resume using a single contour and a single bounding box.
+			MergeWindowContours(temp_contour, other, poly);
 
-				if (poly.size() > 1) { 
-					return TryAddOpenings_Poly2Tri(openings, nors, curmesh);
-				}
-				else if (poly.size() == 0) {
-					IFCImporter::LogWarn("ignoring duplicate opening");
-					temp_contour.clear();
-					break;
-				}
-				else {
-					IFCImporter::LogDebug("merging overlapping openings");				
-					ExtractVerticesFromClipper(poly[0].outer, temp_contour, false);
+			if (poly.size() > 1) { 
+				return TryAddOpenings_Poly2Tri(openings, nors, curmesh);
+			}
+			else if (poly.size() == 0) {
+				IFCImporter::LogWarn("ignoring duplicate opening");
+				temp_contour.clear();
+				break;
+			}
+			else {
+				IFCImporter::LogDebug("merging overlapping openings");				
+				ExtractVerticesFromClipper(poly[0].outer, temp_contour, false);
 
-					// Generate the union of the bounding boxes
-					bb.first = std::min(bb.first, ibb.first);
-					bb.second = std::max(bb.second, ibb.second);
+				// Generate the union of the bounding boxes
+				bb.first = std::min(bb.first, ibb.first);
+				bb.second = std::max(bb.second, ibb.second);
 
-					// Update contour-to-opening tables accordingly
-					if (generate_connection_geometry) {
-						std::vector<TempOpening*>& t = contours_to_openings[std::distance(contours.begin(),it)]; 
-						joined_openings.insert(joined_openings.end(), t.begin(), t.end());
+				// Update contour-to-opening tables accordingly
+				if (generate_connection_geometry) {
+					std::vector<TempOpening*>& t = contours_to_openings[first]; 
+					joined_openings.insert(joined_openings.end(), t.begin(), t.end());
+				}
 
-						contours_to_openings.erase(contours_to_openings.begin() + std::distance(contours.begin(),it));
-					}
+				(*it).FlagInvalid();
+				removed_contours = true;
 
-					contours.erase(it);
+				// Restart from scratch because the newly formed BB might now
+				// overlap any other BB which its constituent BBs didn't
+				// previously overlap.
+				first = 0;
+				continue;
+			}
+		}
 
-					// Restart from scratch because the newly formed BB might now
-					// overlap any other BB which its constituent BBs didn't
-					// previously overlap.
-					it = contours.begin();
-					continue;
+		if (removed_contours) {
+			for (size_t i = contours.size(); i--; ) {
+				if (contours[i].IsInvalid()) {
+					contours.erase(contours.begin() + i);
+					if (generate_connection_geometry) {
+						contours_to_openings.erase(contours_to_openings.begin() + i);
+					}
 				}
 			}
-			++it;
+
+			grid.Clear();
+			grid.Insert(contours);
 		}
 
 		if(!temp_contour.empty()) {
@@ -1395,6 +1524,7 @@ bool GenerateOpenings(std::vector<TempOpening>& openings,
 			}
 
 			contours.push_back(ProjectedWindowContour(temp_contour, bb, is_rectangle));
+			grid.Insert(contours.size()-1, bb);
 		}
 	}
 
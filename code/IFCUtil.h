@@ -48,6 +48,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "IFCReaderGen.h"
 #include "IFCLoader.h"
 
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+#	include <boost/thread/mutex.hpp>
+#	include <boost/thread/condition_variable.hpp>
+#endif
+
 namespace Assimp {
 namespace IFC {
 
@@ -174,14 +179,55 @@ struct ConversionData
 		, db(db)
 		, proj(proj)
 		, out(out)
+		, meshes(own_meshes)
+		, materials(own_materials)
+		, cached_meshes(own_cached_meshes)
 		, settings(settings)
 		, apply_openings()
 		, collect_openings()
+		, parent()
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+		, pending_meshes(own_pending_meshes)
+		, shared_mutex(own_mutex)
+		, mesh_cache_changed(own_mesh_cache_changed)
+#endif
+	{}
+
+	// Derive a ConversionData to convert a part of the node graph on another thread,
+	// see ProcessContainedProducts(). Meshes, materials and the mesh cache are shared
+	// with the parent, access to them must hold shared_mutex. mesh_order is not,
+	// the parent collects it once the derived ConversionData is done.
+	explicit ConversionData(ConversionData* parent)
+		: len_scale(parent->len_scale)
+		, angle_scale(parent->angle_scale)
+		, plane_angle_in_radians(parent->plane_angle_in_radians)
+		, db(parent->db)
+		, proj(parent->proj)
+		, out(parent->out)
+		, wcs(parent->wcs)
+		, meshes(parent->meshes)
+		, materials(parent->materials)
+		, cached_meshes(parent->cached_meshes)
+		, settings(parent->settings)
+		, apply_openings()
+		, collect_openings()
+		, parent(parent)
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+		, pending_meshes(parent->pending_meshes)
+		, shared_mutex(parent->shared_mutex)
+		, mesh_cache_changed(parent->mesh_cache_changed)
+#endif
 	{}
 
 	~ConversionData() {
-		std::for_each(meshes.begin(),meshes.end(),delete_fun<aiMesh>());
-		std::for_each(materials.begin(),materials.end(),delete_fun<aiMaterial>());
+		std::for_each(own_meshes.begin(),own_meshes.end(),delete_fun<aiMesh>());
+		std::for_each(own_materials.begin(),own_materials.end(),delete_fun<aiMaterial>());
+	}
+
+	// check whether the product with the given id is currently being processed,
+	// either by us or by the ConversionData we were derived from.
+	bool IsProcessed(uint64_t id) const {
+		return already_processed.find(id) != already_processed.end() || (parent && parent->IsProcessed(id));
 	}
 
 	IfcFloat len_scale, angle_scale;
@@ -192,11 +238,18 @@ struct ConversionData
 	aiScene* out;
 
 	IfcMatrix4 wcs;
-	std::vector<aiMesh*> meshes;
-	std::vector<aiMaterial*> materials;
 
 	typedef std::map<const IFC::IfcRepresentationItem*, std::vector<unsigned int> > MeshCache;
-	MeshCache cached_meshes;
+
+private:
+	std::vector<aiMesh*> own_meshes;
+	std::vector<aiMaterial*> own_materials;
+	MeshCache own_cached_meshes;
+
+public:
+	std::vector<aiMesh*>& meshes;
+	std::vector<aiMaterial*>& materials;
+	MeshCache& cached_meshes;
 
 	const IFCImporter::Settings& settings;
 
@@ -210,6 +263,25 @@ struct ConversionData
 	std::vector<TempOpening>* collect_openings;
 
 	std::set<uint64_t> already_processed;
+	const ConversionData* const parent;
+
+	// indices of all meshes handed out for representation items, in the order
+	// they were asked for. This is the order a serial conversion creates them in.
+	std::vector<unsigned int> mesh_order;
+
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+private:
+	std::set<const IFC::IfcRepresentationItem*> own_pending_meshes;
+	boost::mutex own_mutex;
+	boost::condition_variable own_mesh_cache_changed;
+
+public:
+	// representation items which are being converted by some thread right now,
+	// mesh_cache_changed is signalled once they are in the mesh cache.
+	std::set<const IFC::IfcRepresentationItem*>& pending_meshes;
+	boost::mutex& shared_mutex;
+	boost::condition_variable& mesh_cache_changed;
+#endif
 };
 
 
@@ -129,6 +129,9 @@ void IRRImporter::SetupProperties(const Importer* pImp)
 
 	// AI_CONFIG_FAVOUR_SPEED
 	configSpeedFlag = (0 != pImp->GetPropertyInteger(AI_CONFIG_FAVOUR_SPEED,0));
+
+	// AI_CONFIG_IMPORT_SCENE_CACHE_SIZE
+	configCacheSize = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_SCENE_CACHE_SIZE,0);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -715,6 +718,9 @@ void IRRImporter::GenerateGraph(Node* root,aiNode* rootOut ,aiScene* scene,
 					if (bdo)	{
 						DefaultLogger::get()->info("IRR: Replacing mesh vertex alpha with common opacity");
 
+						// the vertex colors might be shared with the scene cache
+						SceneCombiner::UnshareScene(scene);
+
 						for (unsigned int a = 0; a < mesh->mNumVertices;++a)
 							mesh->mColors[0][a].a = 1.f;
 
@@ -898,9 +904,9 @@ void IRRImporter::InternReadFile( const std::string& pFile,
 	if( file.get() == NULL)
 		throw DeadlyImportError( "Failed to open IRR file " + pFile + "");
 
-	// Construct the irrXML parser
-	CIrrXML_IOStreamReader st(file.get());
-	reader = createIrrXMLReader((IFileReadCallBack*) &st);
+	// Construct the XML parser
+	boost::scoped_ptr<IrrXMLReader> xmlReader( new FastXMLReader(file.get()) );
+	reader = xmlReader.get();
 
 	// The root node of the scene
 	Node* root = new Node(Node::DUMMY);
@@ -921,6 +927,7 @@ void IRRImporter::InternReadFile( const std::string& pFile,
 
 	// Batch loader used to load external models
 	BatchLoader batch(pIOHandler);
+	batch.SetCacheSize(configCacheSize);
 //	batch.SetBasePath(pFile);
 	
 	cameras.reserve(5);
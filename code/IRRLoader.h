@@ -301,6 +301,9 @@ private:
 
 	/** Configuration option: speed flag was set? */
 	bool configSpeedFlag;
+
+	/** Configuration option: size of the scene cache */
+	unsigned int configCacheSize;
 };
 
 } // end of namespace Assimp
@@ -119,9 +119,8 @@ void IRRMeshImporter::InternReadFile( const std::string& pFile,
 	if( file.get() == NULL)
 		throw DeadlyImportError( "Failed to open IRRMESH file " + pFile + "");
 
-	// Construct the irrXML parser
-	CIrrXML_IOStreamReader st(file.get());
-	reader = createIrrXMLReader((IFileReadCallBack*) &st);
+	// Construct the XML parser
+	reader = new FastXMLReader(file.get());
 
 	// final data
 	std::vector<aiMaterial*> materials;
@@ -7,7 +7,7 @@
 #ifndef INCLUDED_AI_IRRSHARED_H
 #define INCLUDED_AI_IRRSHARED_H
 
-#include "irrXMLWrapper.h"
+#include "FastXMLReader.h"
 #include "BaseImporter.h"
 
 namespace Assimp	{
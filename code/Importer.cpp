@@ -70,6 +70,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "GenericProperty.h"
 #include "ProcessHelper.h"
 #include "ScenePreprocessor.h"
+#include "SceneCombiner.h"
 #include "MemoryIOWrapper.h"
 #include "Profiler.h"
 #include "TinyFormatter.h"
@@ -428,6 +429,13 @@ aiScene* Importer::GetOrphanedScene()
 	ASSIMP_BEGIN_EXCEPTION_REGION();
 	pimpl->mScene = NULL;
 
+	// The caller may modify the scene, so it must not share any data with other
+	// scenes, i.e. the scene cache used by BatchLoader. ApplyPostProcessing()
+	// has already done this unless the scene was imported without any steps.
+	if (s) {
+		SceneCombiner::UnshareScene(s);
+	}
+
 	pimpl->mErrorString = ""; /* reset error string */
 	ASSIMP_END_EXCEPTION_REGION(aiScene*);
 	return s;
@@ -764,6 +772,11 @@ const aiScene* Importer::ApplyPostProcessing(unsigned int pFlags)
 	}
 #endif // ! DEBUG
 
+	// The steps modify the scene in place, so it must not share any data with other scenes
+	if (pFlags & ~aiProcess_ValidateDataStructure) {
+		SceneCombiner::UnshareScene(pimpl->mScene);
+	}
+
 	boost::scoped_ptr<Profiler> profiler(GetPropertyInteger(AI_CONFIG_GLOB_MEASURE_TIME,0)?new Profiler():NULL);
 	for( unsigned int a = 0; a < pimpl->mPostProcessingSteps.size(); a++)	{
 
@@ -191,6 +191,20 @@ public:
 		);
 
 
+	// -------------------------------------------------------------------
+	/** Enables the process-wide cache of imported scenes for this batch.
+	 *
+	 *  Files that have already been imported with the same post-processing
+	 *  steps and properties are not parsed again, the batch receives a copy
+	 *  of the cached scene instead. The cache is shared by all batches,
+	 *  the last non-zero size set becomes its limit. Builds using the 
+	 *  boost workaround have no cache, this is a no-op then.
+	 *  @param megabytes Upper limit for the memory held by the cache,
+	 *    0 disables the cache for this batch.
+	 *  @see AI_CONFIG_IMPORT_SCENE_CACHE_SIZE */
+	void SetCacheSize(unsigned int megabytes);
+
+
 	// -------------------------------------------------------------------
 	/** Waits until all scenes have been loaded. This returns
 	 *  immediately if no scenes are queued.*/
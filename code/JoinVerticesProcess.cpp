@@ -52,6 +52,45 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "TinyFormatter.h"
 
 using namespace Assimp;
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Check whether two vertices of a mesh are identical in all frames of its vertex animation
+bool AnimMeshesEqual(const aiMesh* pMesh, unsigned int a, unsigned int b, float squareEpsilon)
+{
+	for (unsigned int i = 0; i < pMesh->mNumAnimMeshes;++i)	{
+		const aiAnimMesh* anim = pMesh->mAnimMeshes[i];
+		if (anim->mVertices && (anim->mVertices[a] - anim->mVertices[b]).SquareLength() > squareEpsilon) {
+			return false;
+		}
+		if (anim->mNormals && (anim->mNormals[a] - anim->mNormals[b]).SquareLength() > squareEpsilon) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Drop all duplicate elements from a vertex stream of an attachment mesh
+template <typename T>
+void RemapStream(T*& data, const std::vector<unsigned int>& replaceIndex, unsigned int numUnique)
+{
+	if (!data) {
+		return;
+	}
+	T* out = new T[numUnique];
+	for (unsigned int a = 0; a < replaceIndex.size(); a++) {
+		if (!(replaceIndex[a] & 0x80000000)) {
+			out[replaceIndex[a]] = data[a];
+		}
+	}
+	delete[] data;
+	data = out;
+}
+
+} // end of anonymous namespace
+
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 JoinVerticesProcess::JoinVerticesProcess()
@@ -202,6 +241,10 @@ int JoinVerticesProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
 			if( (uv.bitangent - v.bitangent).SquareLength() > squareEpsilon)
 				continue;
 
+			// Vertices which move differently during vertex animation must stay separate
+			if (pMesh->mNumAnimMeshes && !AnimMeshesEqual(pMesh,vidx,a,squareEpsilon))
+				continue;
+
 			// Usually we won't have vertex colors or multiple UVs, so we can skip from here
 			// Actually this increases runtime performance slightly, at least if branch
 			// prediction is on our side.
@@ -408,6 +451,23 @@ int JoinVerticesProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
 			DefaultLogger::get()->warn("Removing bone -> no weights remaining");
 		}
 	}
+
+	// attachment meshes share the vertex layout of their host, so shrink them as well
+	for( unsigned int a = 0; a < pMesh->mNumAnimMeshes; a++)
+	{
+		aiAnimMesh* anim = pMesh->mAnimMeshes[a];
+		RemapStream(anim->mVertices,replaceIndex,pMesh->mNumVertices);
+		RemapStream(anim->mNormals,replaceIndex,pMesh->mNumVertices);
+		RemapStream(anim->mTangents,replaceIndex,pMesh->mNumVertices);
+		RemapStream(anim->mBitangents,replaceIndex,pMesh->mNumVertices);
+		for( unsigned int b = 0; b < AI_MAX_NUMBER_OF_COLOR_SETS; b++) {
+			RemapStream(anim->mColors[b],replaceIndex,pMesh->mNumVertices);
+		}
+		for( unsigned int b = 0; b < AI_MAX_NUMBER_OF_TEXTURECOORDS; b++) {
+			RemapStream(anim->mTextureCoords[b],replaceIndex,pMesh->mNumVertices);
+		}
+		anim->mNumVertices = pMesh->mNumVertices;
+	}
 	return pMesh->mNumVertices;
 }
 
@@ -168,6 +168,9 @@ void LWSImporter::SetupProperties(const Importer* pImp)
 	// AI_CONFIG_FAVOUR_SPEED
 	configSpeedFlag = (0 != pImp->GetPropertyInteger(AI_CONFIG_FAVOUR_SPEED,0));
 
+	// AI_CONFIG_IMPORT_SCENE_CACHE_SIZE
+	configCacheSize = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_SCENE_CACHE_SIZE,0);
+
 	// AI_CONFIG_IMPORT_LWS_ANIM_START
 	first = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_LWS_ANIM_START,
 		150392 /* magic hack */);
@@ -518,6 +521,7 @@ void LWSImporter::InternReadFile( const std::string& pFile, aiScene* pScene,
 
 	// Construct a Batchimporter to read more files recursively
 	BatchLoader batch(pIOHandler);
+	batch.SetCacheSize(configCacheSize);
 //	batch.SetBasePath(pFile);
 
 	// Construct an array to receive the flat output graph
@@ -230,6 +230,7 @@ private:
 private:
 
 	bool configSpeedFlag;
+	unsigned int configCacheSize;
 	IOSystem* io;
 
 	double first,last,fps;
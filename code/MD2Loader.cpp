@@ -45,6 +45,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 /** @file Implementation of the MD2 importer class */
 #include "MD2Loader.h"
 #include "ByteSwap.h"
+#include "AnimMeshBuilder.h"
 #include "MD2NormalTable.h" // shouldn't be included by other units
 
 using namespace Assimp;
@@ -127,6 +128,7 @@ void MD2Importer::SetupProperties(const Importer* pImp)
 	if(static_cast<unsigned int>(-1) == configFrameID){
 		configFrameID = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_GLOBAL_KEYFRAME,0);
 	}
+	configAllFrames = pImp->GetPropertyBool(AI_CONFIG_IMPORT_ALL_KEYFRAMES,false);
 }
 // ------------------------------------------------------------------------------------------------
 // Validate the file header
@@ -167,6 +169,14 @@ void MD2Importer::ValidateHeader( )
 		throw DeadlyImportError("Invalid MD2 header: some offsets are outside the file");
 	}
 
+	// frames are frameSize bytes apart, which accounts for the variable-length vertex list.
+	// Computed in 64 bits, the header fields are all 32 bit and could overflow otherwise.
+	if (m_pcHeader->frameSize < sizeof(MD2::Frame) - sizeof(MD2::Vertex) + (uint64_t)m_pcHeader->numVertices * sizeof(MD2::Vertex) ||
+		(uint64_t)m_pcHeader->offsetFrames + (uint64_t)m_pcHeader->numFrames * m_pcHeader->frameSize > fileSize)
+	{
+		throw DeadlyImportError("Invalid MD2 header: frame size is invalid");
+	}
+
 	if (m_pcHeader->numSkins > AI_MD2_MAX_SKINS)
 		DefaultLogger::get()->warn("The model contains more skins than Quake 2 supports");
 	if ( m_pcHeader->numFrames > AI_MD2_MAX_FRAMES)
@@ -178,6 +188,54 @@ void MD2Importer::ValidateHeader( )
 		throw DeadlyImportError("The requested frame is not existing the file");
 }
 
+// ------------------------------------------------------------------------------------------------
+// Get a pointer to a frame in the file
+BE_NCONST MD2::Frame* MD2Importer::GetFrame(unsigned int iFrame)
+{
+	return (BE_NCONST MD2::Frame*) ((uint8_t*)m_pcHeader + 
+		m_pcHeader->offsetFrames + iFrame * m_pcHeader->frameSize);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Decode the vertex positions and normals of a frame, one per triangle corner
+void MD2Importer::ReadFrameVertices(const MD2::Frame* pcFrame, const MD2::Triangle* pcTriangles,
+	aiVector3D* pcVertices, aiVector3D* pcNormals) const
+{
+	const MD2::Vertex* pcVerts = pcFrame->vertices;
+
+	unsigned int iCurrent = 0;
+	for (unsigned int i = 0; i < (unsigned int)m_pcHeader->numTriangles;++i)	{
+		for (unsigned int c = 0; c < 3;++c,++iCurrent)	{
+
+			// out of range indices are reported by InternReadFile()
+			unsigned int iIndex = (unsigned int)pcTriangles[i].vertexIndices[c];
+			if (iIndex >= m_pcHeader->numVertices)	{
+				iIndex = m_pcHeader->numVertices-1;
+			}
+
+			// read x,y, and z component of the vertex
+			aiVector3D& vec = pcVertices[iCurrent];
+
+			vec.x = (float)pcVerts[iIndex].vertex[0] * pcFrame->scale[0];
+			vec.x += pcFrame->translate[0];
+
+			vec.y = (float)pcVerts[iIndex].vertex[1] * pcFrame->scale[1];
+			vec.y += pcFrame->translate[1];
+
+			vec.z = (float)pcVerts[iIndex].vertex[2] * pcFrame->scale[2];
+			vec.z += pcFrame->translate[2];
+
+			// read the normal vector from the precalculated normal table
+			aiVector3D& vNormal = pcNormals[iCurrent];
+			LookupNormalIndex(pcVerts[iIndex].lightNormalIndex,vNormal);
+
+			// flip z and y to become right-handed
+			std::swap((float&)vNormal.z,(float&)vNormal.y);
+			std::swap((float&)vec.z,(float&)vec.y);
+		}
+	}
+}
+
 // ------------------------------------------------------------------------------------------------
 // Imports the given file into the given scene structure. 
 void MD2Importer::InternReadFile( const std::string& pFile, 
@@ -240,11 +298,8 @@ void MD2Importer::InternReadFile( const std::string& pFile,
 	aiMesh* pcMesh = pScene->mMeshes[0] = new aiMesh();
 	pcMesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
 
-	// navigate to the begin of the frame data
-	BE_NCONST MD2::Frame* pcFrame = (BE_NCONST MD2::Frame*) ((uint8_t*)
-		m_pcHeader + m_pcHeader->offsetFrames);
-
-	pcFrame += configFrameID;
+	// navigate to the frame we want to read
+	BE_NCONST MD2::Frame* pcFrame = GetFrame(configFrameID);
 
 	// navigate to the begin of the triangle data
 	MD2::Triangle* pcTriangles = (MD2::Triangle*) ((uint8_t*)
@@ -254,9 +309,6 @@ void MD2Importer::InternReadFile( const std::string& pFile,
 	BE_NCONST MD2::TexCoord* pcTexCoords = (BE_NCONST MD2::TexCoord*) ((uint8_t*)
 		m_pcHeader + m_pcHeader->offsetTexCoords);
 
-	// navigate to the begin of the vertex data
-	BE_NCONST MD2::Vertex* pcVerts = (BE_NCONST MD2::Vertex*) (pcFrame->vertices);
-
 #ifdef AI_BUILD_BIG_ENDIAN
 	for (uint32_t i = 0; i< m_pcHeader->numTriangles; ++i)
 	{
@@ -345,7 +397,8 @@ void MD2Importer::InternReadFile( const std::string& pFile,
 	}
 
 
-	// now read all triangles of the first frame, apply scaling and translation
+	// now read all triangles of the selected frame, apply scaling and translation
+	ReadFrameVertices(pcFrame,pcTriangles,pcMesh->mVertices,pcMesh->mNormals);
 	unsigned int iCurrent = 0;
 
 	float fDivisorU = 1.0f,fDivisorV = 1.0f;
@@ -380,29 +433,8 @@ void MD2Importer::InternReadFile( const std::string& pFile,
 			register unsigned int iIndex = (unsigned int)pcTriangles[i].vertexIndices[c];
 			if (iIndex >= m_pcHeader->numVertices)	{
 				DefaultLogger::get()->error("MD2: Vertex index is outside the allowed range");
-				iIndex = m_pcHeader->numVertices-1;
 			}
 
-			// read x,y, and z component of the vertex
-			aiVector3D& vec = pcMesh->mVertices[iCurrent];
-
-			vec.x = (float)pcVerts[iIndex].vertex[0] * pcFrame->scale[0];
-			vec.x += pcFrame->translate[0];
-
-			vec.y = (float)pcVerts[iIndex].vertex[1] * pcFrame->scale[1];
-			vec.y += pcFrame->translate[1];
-
-			vec.z = (float)pcVerts[iIndex].vertex[2] * pcFrame->scale[2];
-			vec.z += pcFrame->translate[2];
-
-			// read the normal vector from the precalculated normal table
-			aiVector3D& vNormal = pcMesh->mNormals[iCurrent];
-			LookupNormalIndex(pcVerts[iIndex].lightNormalIndex,vNormal);
-
-			// flip z and y to become right-handed
-			std::swap((float&)vNormal.z,(float&)vNormal.y);
-			std::swap((float&)vec.z,(float&)vec.y);
-
 			if (m_pcHeader->numTexCoords)	{
 				// validate texture coordinates
 				iIndex = pcTriangles[i].textureIndices[c];
@@ -421,6 +453,27 @@ void MD2Importer::InternReadFile( const std::string& pFile,
 			pScene->mMeshes[0]->mFaces[i].mIndices[c] = iCurrent;
 		}
 	}
+
+	// decode all frames as aiAnimMesh'es if requested
+	if (configAllFrames)	{
+		AnimMeshBuilder builder(10.);
+		for (unsigned int f = 0; f < m_pcHeader->numFrames;++f)	{
+			BE_NCONST MD2::Frame* pcCurFrame = GetFrame(f);
+
+#ifdef AI_BUILD_BIG_ENDIAN
+			if (f != configFrameID)	{
+				for (unsigned int n = 0; n < 3;++n)	{
+					ByteSwap::Swap4( & pcCurFrame->scale[n] );
+					ByteSwap::Swap4( & pcCurFrame->translate[n] );
+				}
+			}
+#endif
+			aiAnimMesh* pcAnim = AnimMeshBuilder::NewFrame(pcMesh);
+			ReadFrameVertices(pcCurFrame,pcTriangles,pcAnim->mVertices,pcAnim->mNormals);
+			builder.AddFrame(pcMesh,pcAnim);
+		}
+		builder.Finish(pScene);
+	}
 }
 
 #endif // !! ASSIMP_BUILD_NO_MD2_IMPORTER
@@ -102,11 +102,27 @@ protected:
 	*/
 	void ValidateHeader();
 
+	// -------------------------------------------------------------------
+	/** Get a pointer to a frame in the file
+	*/
+	BE_NCONST MD2::Frame* GetFrame(unsigned int iFrame);
+
+	// -------------------------------------------------------------------
+	/** Decode the vertex positions and normals of a frame, one per
+	 *  triangle corner.
+	*/
+	void ReadFrameVertices(const MD2::Frame* pcFrame, 
+		const MD2::Triangle* pcTriangles,
+		aiVector3D* pcVertices, aiVector3D* pcNormals) const;
+
 protected:
 
 	/** Configuration option: frame to be loaded */
 	unsigned int configFrameID;
 
+	/** Configuration option: import all frames as aiAnimMesh'es */
+	bool configAllFrames;
+
 	/** Header of the MD2 file */
 	BE_NCONST MD2::Header* m_pcHeader;
 
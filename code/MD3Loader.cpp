@@ -58,6 +58,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "RemoveComments.h"
 #include "ParsingUtils.h"
 #include "Importer.h"
+#include "AnimMeshBuilder.h"
 
 using namespace Assimp;
 
@@ -348,6 +349,7 @@ void Q3Shader::ConvertShaderToMaterial(aiMaterial* out, const ShaderDataBlock& s
 // Constructor to be privately used by Importer
 MD3Importer::MD3Importer()
 : configFrameID  (0)
+, configAllFrames (false)
 , configHandleMP (true)
 {}
 
@@ -404,11 +406,14 @@ void MD3Importer::ValidateSurfaceHeaderOffsets(const MD3::Surface* pcSurf)
 	// Calculate the relative offset of the surface
 	const int32_t ofs = int32_t((const unsigned char*)pcSurf-this->mBuffer);
 
+	// There is one vertex list per frame, we need all of them up to the requested frame
+	const uint32_t iNumFrames = std::max(configFrameID+1, configAllFrames ? pcSurf->NUM_FRAMES : 0u);
+
 	// Check whether all data chunks are inside the valid range
 	if (pcSurf->OFS_TRIANGLES + ofs + pcSurf->NUM_TRIANGLES * sizeof(MD3::Triangle)	> fileSize  ||
 		pcSurf->OFS_SHADERS + ofs + pcSurf->NUM_SHADER * sizeof(MD3::Shader) > fileSize         ||
 		pcSurf->OFS_ST + ofs + pcSurf->NUM_VERTICES * sizeof(MD3::TexCoord) > fileSize          ||
-		pcSurf->OFS_XYZNORMAL + ofs + pcSurf->NUM_VERTICES * sizeof(MD3::Vertex) > fileSize)	{
+		pcSurf->OFS_XYZNORMAL + ofs + iNumFrames * pcSurf->NUM_VERTICES * sizeof(MD3::Vertex) > fileSize)	{
 
 		throw DeadlyImportError("Invalid MD3 surface header: some offsets are outside the file");
 	}
@@ -432,6 +437,33 @@ void MD3Importer::ValidateSurfaceHeaderOffsets(const MD3::Surface* pcSurf)
 	}
 }
 
+// ------------------------------------------------------------------------------------------------
+void MD3Importer::ReadFrameVertices(const MD3::Surface* pcSurf, unsigned int iFrame,
+	aiVector3D* pcVertices, aiVector3D* pcNormals) const
+{
+	const MD3::Vertex* pcVerts = (const MD3::Vertex*)
+		(((const uint8_t*)pcSurf) + pcSurf->OFS_XYZNORMAL) + iFrame * pcSurf->NUM_VERTICES;
+
+	const MD3::Triangle* pcTriangles = (const MD3::Triangle*)
+		(((const uint8_t*)pcSurf) + pcSurf->OFS_TRIANGLES);
+
+	unsigned int iCurrent = 0;
+	for (unsigned int i = 0; i < (unsigned int)pcSurf->NUM_TRIANGLES;++i,++pcTriangles)	{
+		for (unsigned int c = 0; c < 3;++c,++iCurrent)	{
+			const uint32_t iIndex = std::min(pcTriangles->INDEXES[c],pcSurf->NUM_VERTICES-1);
+
+			// Read vertices
+			aiVector3D& vec = pcVertices[iCurrent];
+			vec.x = pcVerts[iIndex].X*AI_MD3_XYZ_SCALE;
+			vec.y = pcVerts[iIndex].Y*AI_MD3_XYZ_SCALE;
+			vec.z = pcVerts[iIndex].Z*AI_MD3_XYZ_SCALE;
+
+			// Convert the normal vector to uncompressed float3 format
+			LatLngNormalToVec3(pcVerts[iIndex].NORMAL,(float*)&pcNormals[iCurrent]);
+		}
+	}
+}
+
 // ------------------------------------------------------------------------------------------------
 const aiImporterDesc* MD3Importer::GetInfo () const
 {
@@ -450,6 +482,8 @@ void MD3Importer::SetupProperties(const Importer* pImp)
 		configFrameID = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_GLOBAL_KEYFRAME,0);
 	}
 
+	configAllFrames = pImp->GetPropertyBool(AI_CONFIG_IMPORT_ALL_KEYFRAMES,false);
+
 	// AI_CONFIG_IMPORT_MD3_HANDLE_MULTIPART
 	configHandleMP = (0 != pImp->GetPropertyInteger(AI_CONFIG_IMPORT_MD3_HANDLE_MULTIPART,1));
 
@@ -797,6 +831,7 @@ void MD3Importer::InternReadFile( const std::string& pFile,
 	// Read all surfaces from the file
 	unsigned int iNum = pcHeader->NUM_SURFACES;
 	unsigned int iNumMaterials = 0;
+	AnimMeshBuilder builder(10.);
 	while (iNum-- > 0)	{
 
 		// Ensure correct endianess
@@ -819,10 +854,6 @@ void MD3Importer::InternReadFile( const std::string& pFile,
 		// Validate the surface header
 		ValidateSurfaceHeaderOffsets(pcSurfaces);
 
-		// Navigate to the vertex list of the surface
-		BE_NCONST MD3::Vertex* pcVertices = (BE_NCONST MD3::Vertex*)
-			(((uint8_t*)pcSurfaces) + pcSurfaces->OFS_XYZNORMAL);
-
 		// Navigate to the triangle list of the surface
 		BE_NCONST MD3::Triangle* pcTriangles = (BE_NCONST MD3::Triangle*)
 			(((uint8_t*)pcSurfaces) + pcSurfaces->OFS_TRIANGLES);
@@ -935,12 +966,18 @@ void MD3Importer::InternReadFile( const std::string& pFile,
 			// Ensure correct endianess
 #ifdef AI_BUILD_BIG_ENDIAN
 
-		for (uint32_t i = 0; i < pcSurfaces->NUM_VERTICES;++i)	{
+		// Navigate to the vertex list of the surface, there is one per frame
+		BE_NCONST MD3::Vertex* pcVertices = (BE_NCONST MD3::Vertex*)
+			(((uint8_t*)pcSurfaces) + pcSurfaces->OFS_XYZNORMAL);
+
+		const uint32_t iNumFrames = configAllFrames ? std::max(pcSurfaces->NUM_FRAMES,configFrameID+1) : configFrameID+1;
+		for (uint32_t i = 0; i < pcSurfaces->NUM_VERTICES * iNumFrames;++i)	{
 			AI_SWAP2( pcVertices[i].NORMAL );
 			AI_SWAP2( pcVertices[i].X );
 			AI_SWAP2( pcVertices[i].Y );
 			AI_SWAP2( pcVertices[i].Z );
-
+		}
+		for (uint32_t i = 0; i < pcSurfaces->NUM_VERTICES;++i)	{
 			AI_SWAP4( pcUVs[i].U );
 			AI_SWAP4( pcUVs[i].U );
 		}
@@ -963,6 +1000,9 @@ void MD3Importer::InternReadFile( const std::string& pFile,
 		pcMesh->mTextureCoords[0]	= new aiVector3D[pcMesh->mNumVertices];
 		pcMesh->mNumUVComponents[0] = 2;
 
+		// Read vertices and normals of the requested frame
+		ReadFrameVertices(pcSurfaces,configFrameID,pcMesh->mVertices,pcMesh->mNormals);
+
 		// Fill in all triangles
 		unsigned int iCurrent = 0;
 		for (unsigned int i = 0; i < (unsigned int)pcSurfaces->NUM_TRIANGLES;++i)	{
@@ -973,19 +1013,10 @@ void MD3Importer::InternReadFile( const std::string& pFile,
 			for (unsigned int c = 0; c < 3;++c,++iCurrent)	{
 				pcMesh->mFaces[i].mIndices[c] = iCurrent;
 
-				// Read vertices
-				aiVector3D& vec = pcMesh->mVertices[iCurrent];
-				vec.x = pcVertices[ pcTriangles->INDEXES[c]].X*AI_MD3_XYZ_SCALE;
-				vec.y = pcVertices[ pcTriangles->INDEXES[c]].Y*AI_MD3_XYZ_SCALE;
-				vec.z = pcVertices[ pcTriangles->INDEXES[c]].Z*AI_MD3_XYZ_SCALE;
-
-				// Convert the normal vector to uncompressed float3 format
-				aiVector3D& nor = pcMesh->mNormals[iCurrent];
-				LatLngNormalToVec3(pcVertices[pcTriangles->INDEXES[c]].NORMAL,(float*)&nor);
-
 				// Read texture coordinates
-				pcMesh->mTextureCoords[0][iCurrent].x = pcUVs[ pcTriangles->INDEXES[c]].U;
-				pcMesh->mTextureCoords[0][iCurrent].y = 1.0f-pcUVs[ pcTriangles->INDEXES[c]].V;
+				const uint32_t iIndex = std::min(pcTriangles->INDEXES[c],pcSurfaces->NUM_VERTICES-1);
+				pcMesh->mTextureCoords[0][iCurrent].x = pcUVs[iIndex].U;
+				pcMesh->mTextureCoords[0][iCurrent].y = 1.0f-pcUVs[iIndex].V;
 			}
 			// Flip face order if necessary
 			if (!shader || shader->cull == Q3Shader::CULL_CW) {
@@ -993,6 +1024,17 @@ void MD3Importer::InternReadFile( const std::string& pFile,
 			}
 			pcTriangles++;
 		}
+
+		// Read all other frames as well if requested. Name the mesh after 
+		// the surface since the animation channels refer to it by name.
+		if (configAllFrames) {
+			pcMesh->mName.Set(pcSurfaces->NAME);
+			for (unsigned int f = 0; f < pcSurfaces->NUM_FRAMES;++f) {
+				aiAnimMesh* pcAnim = AnimMeshBuilder::NewFrame(pcMesh);
+				ReadFrameVertices(pcSurfaces,f,pcAnim->mVertices,pcAnim->mNormals);
+				builder.AddFrame(pcMesh,pcAnim);
+			}
+		}
 	
 		// Go to the next surface
 		pcSurfaces = (BE_NCONST MD3::Surface*)(((unsigned char*)pcSurfaces) + pcSurfaces->OFS_END);
@@ -1049,6 +1091,8 @@ void MD3Importer::InternReadFile( const std::string& pFile,
 	for (unsigned int i = 0; i < pScene->mNumMeshes;++i)
 		pScene->mRootNode->mMeshes[i] = i;
 
+	builder.Finish(pScene);
+
 	// Now rotate the whole scene 90 degrees around the x axis to convert to internal coordinate system
 	pScene->mRootNode->mTransformation = aiMatrix4x4(1.f,0.f,0.f,0.f,
 		0.f,0.f,1.f,0.f,0.f,-1.f,0.f,0.f,0.f,0.f,0.f,1.f);
@@ -253,6 +253,13 @@ protected:
 	void ValidateHeaderOffsets();
 	void ValidateSurfaceHeaderOffsets(const MD3::Surface* pcSurfHeader);
 
+	// -------------------------------------------------------------------
+	/** Decode the vertex positions and normals of a surface for a
+	 *  given frame, one per triangle corner
+	 */
+	void ReadFrameVertices(const MD3::Surface* pcSurf, unsigned int iFrame,
+		aiVector3D* pcVertices, aiVector3D* pcNormals) const;
+
 	// -------------------------------------------------------------------
 	/** Read a Q3 multipart file
 	 *  @return true if multi part has been processed
@@ -285,6 +292,9 @@ protected:
 	/** Configuration option: frame to be loaded */
 	unsigned int configFrameID;
 
+	/** Configuration option: import all frames as aiAnimMesh'es */
+	bool configAllFrames;
+
 	/** Configuration option: process multi-part files */
 	bool configHandleMP;
 
@@ -52,6 +52,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "StringComparison.h"
 #include "fast_atof.h"
 #include "SkeletonMeshBuilder.h"
+#include "ParallelFor.h"
 
 using namespace Assimp;
 
@@ -337,6 +338,61 @@ void MD5Importer::AttachChilds_Anim(int iParentID,aiNode* piParent, AnimBoneList
 	}
 }
 
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Computes the bind pose vertex positions of MD5 meshes, one mesh per job
+struct MD5BindPoseJob
+{
+	MD5BindPoseJob(const MD5::BoneList& joints)
+		: joints(joints)
+	{}
+
+	void operator()(size_t i) const
+	{
+		const MD5::MeshDesc& meshSrc = *sources[i];
+		aiMesh* const mesh = meshes[i];
+
+		// Many vertices share the same weights (MakeDataUnique duplicates vertices
+		// per face), so transform every weight only once
+		std::vector<aiVector3D> weighted(meshSrc.mWeights.size());
+		for (size_t w = 0; w < weighted.size(); ++w) {
+			const MD5::WeightDesc& desc = meshSrc.mWeights[w];
+			if ( desc.mWeight < AI_MD5_WEIGHT_EPSILON && desc.mWeight >= -AI_MD5_WEIGHT_EPSILON) {
+				continue;
+			}
+
+			// transform the local position into worldspace and use the original weight 
+			// to compute the vertex position (some MD5s seem to depend on the invalid weight values ...)
+			const MD5::BoneDesc& boneSrc = joints[desc.mBone];
+			aiQuaternion rot = boneSrc.mRotationQuatConverted;
+			weighted[w] = (boneSrc.mPositionXYZ + rot.Rotate(desc.vOffsetPosition)) * desc.mWeight;
+		}
+
+		aiVector3D* pv = mesh->mVertices;
+		for (MD5::VertexList::const_iterator iter = meshSrc.mVertices.begin();iter != meshSrc.mVertices.end();++iter,++pv) {
+			float fSum = 0.0f;
+			for (unsigned int jub = (*iter).mFirstWeight, w = jub; w < jub + (*iter).mNumWeights;++w) {
+				fSum += meshSrc.mWeights[w].mWeight;
+			}
+			// already reported by LoadMD5MeshFile()
+			if (!fSum) {
+				continue;
+			}
+
+			for (unsigned int jub = (*iter).mFirstWeight, w = jub; w < jub + (*iter).mNumWeights;++w) {
+				*pv += weighted[w];
+			}
+		}
+	}
+
+	const MD5::BoneList& joints;
+	std::vector<const MD5::MeshDesc*> sources;
+	std::vector<aiMesh*> meshes;
+};
+
+}
+
 // ------------------------------------------------------------------------------------------------
 // Load a MD5MESH file
 void MD5Importer::LoadMD5MeshFile ()
@@ -395,6 +451,14 @@ void MD5Importer::LoadMD5MeshFile ()
 	for (unsigned int m = 0; m < pcNode->mNumMeshes;++m)
 		pcNode->mMeshes[m] = m;
 
+	// compute the w-component of all joint quaternions
+	for (MD5::BoneList::iterator it = meshParser.mJoints.begin(), end = meshParser.mJoints.end(); it != end; ++it) {
+		MD5::ConvertQuaternion( (*it).mRotationQuat, (*it).mRotationQuatConverted );
+	}
+
+	// bind pose vertex positions are computed for all meshes at once, see below
+	MD5BindPoseJob bindPose(meshParser.mJoints);
+
 	unsigned int n = 0;
 	for (std::vector<MD5::MeshDesc>::iterator it  = meshParser.mMeshes.begin(),end = meshParser.mMeshes.end(); it != end;++it) {
 		MD5::MeshDesc& meshSrc = *it;
@@ -424,13 +488,19 @@ void MD5Importer::LoadMD5MeshFile ()
 		unsigned int* piCount = new unsigned int[meshParser.mJoints.size()];
 		::memset(piCount,0,sizeof(unsigned int)*meshParser.mJoints.size());
 
-		for (MD5::VertexList::const_iterator iter =  meshSrc.mVertices.begin();iter != meshSrc.mVertices.end();++iter,++pv) {
+		for (MD5::VertexList::const_iterator iter =  meshSrc.mVertices.begin();iter != meshSrc.mVertices.end();++iter) {
+			if ((*iter).mFirstWeight + (*iter).mNumWeights > meshSrc.mWeights.size())
+				throw DeadlyImportError("MD5MESH: Invalid weight index");
+
 			for (unsigned int jub = (*iter).mFirstWeight, w = jub; w < jub + (*iter).mNumWeights;++w)
 			{
 				MD5::WeightDesc& desc = meshSrc.mWeights[w];
 				/* FIX for some invalid exporters */
-				if (!(desc.mWeight < AI_MD5_WEIGHT_EPSILON && desc.mWeight >= -AI_MD5_WEIGHT_EPSILON ))
+				if (!(desc.mWeight < AI_MD5_WEIGHT_EPSILON && desc.mWeight >= -AI_MD5_WEIGHT_EPSILON )) {
+					if (desc.mBone >= meshParser.mJoints.size())
+						throw DeadlyImportError("MD5MESH: Invalid bone index");
 					++piCount[desc.mBone]; 
+				}
 			}
 		}
 
@@ -451,19 +521,12 @@ void MD5Importer::LoadMD5MeshFile ()
 				p->mOffsetMatrix = meshParser.mJoints[q].mInvTransform;
 
 				// store the index for later use
-				MD5::BoneDesc& boneSrc = meshParser.mJoints[q];
-				boneSrc.mMap = h++;
-
-				// compute w-component of quaternion
-				MD5::ConvertQuaternion( boneSrc.mRotationQuat, boneSrc.mRotationQuatConverted );
+				meshParser.mJoints[q].mMap = h++;
 			}
 	
-			//unsigned int g = 0;
-			pv = mesh->mVertices;
-			for (MD5::VertexList::const_iterator iter =  meshSrc.mVertices.begin();iter != meshSrc.mVertices.end();++iter,++pv) {
-				// compute the final vertex position from all single weights
-				*pv = aiVector3D();
-
+			// assign the bone weights, the vertex positions are computed later
+			unsigned int vertex = 0;
+			for (MD5::VertexList::const_iterator iter =  meshSrc.mVertices.begin();iter != meshSrc.mVertices.end();++iter,++vertex) {
 				// there are models which have weights which don't sum to 1 ...
 				float fSum = 0.0f;
 				for (unsigned int jub = (*iter).mFirstWeight, w = jub; w < jub + (*iter).mNumWeights;++w)
@@ -475,29 +538,21 @@ void MD5Importer::LoadMD5MeshFile ()
 
 				// process bone weights
 				for (unsigned int jub = (*iter).mFirstWeight, w = jub; w < jub + (*iter).mNumWeights;++w)	{
-					if (w >= meshSrc.mWeights.size())
-						throw DeadlyImportError("MD5MESH: Invalid weight index");
-
-					MD5::WeightDesc& desc = meshSrc.mWeights[w];
+					const MD5::WeightDesc& desc = meshSrc.mWeights[w];
 					if ( desc.mWeight < AI_MD5_WEIGHT_EPSILON && desc.mWeight >= -AI_MD5_WEIGHT_EPSILON) {
 						continue;
 					}
 
 					const float fNewWeight = desc.mWeight / fSum; 
 
-					// transform the local position into worldspace
-					MD5::BoneDesc& boneSrc = meshParser.mJoints[desc.mBone];
-					const aiVector3D v = boneSrc.mRotationQuatConverted.Rotate (desc.vOffsetPosition);
-
-					// use the original weight to compute the vertex position
-					// (some MD5s seem to depend on the invalid weight values ...)
-					*pv += ((boneSrc.mPositionXYZ+v)* desc.mWeight);
-			
-					aiBone* bone = mesh->mBones[boneSrc.mMap];
-					*bone->mWeights++ = aiVertexWeight((unsigned int)(pv-mesh->mVertices),fNewWeight);
+					aiBone* bone = mesh->mBones[meshParser.mJoints[desc.mBone].mMap];
+					*bone->mWeights++ = aiVertexWeight(vertex,fNewWeight);
 				}
 			}
 
+			bindPose.sources.push_back(&meshSrc);
+			bindPose.meshes.push_back(mesh);
+
 			// undo our nice offset tricks ...
 			for (unsigned int p = 0; p < mesh->mNumBones;++p) {
 				mesh->mBones[p]->mWeights -= mesh->mBones[p]->mNumWeights;
@@ -549,6 +604,9 @@ void MD5Importer::LoadMD5MeshFile ()
 		else mat->AddProperty(&meshSrc.mShader,AI_MATKEY_TEXTURE_DIFFUSE(0));
 		mesh->mMaterialIndex = n++;
 	}
+
+	// the meshes are independent of each other, so evaluate them in parallel
+	ParallelFor(bindPose.meshes.size(), bindPose);
 #endif
 }
 
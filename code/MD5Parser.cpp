@@ -424,7 +424,8 @@ MD5AnimParser::MD5AnimParser(SectionList& mSections)
 			}
 		}
 		else if((*iter).mName == "numAnimatedComponents")	{
-			mAnimatedBones.reserve( strtoul10((*iter).mGlobalValue.c_str()));
+			// number of floats in each frame, allows us to reserve the key storage up front
+			mNumAnimatedComponents = strtoul10((*iter).mGlobalValue.c_str());
 		}
 		else if((*iter).mName == "frameRate")	{
 			fast_atoreal_move<float>((*iter).mGlobalValue.c_str(),fFrameRate);
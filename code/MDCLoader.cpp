@@ -48,6 +48,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "MDCLoader.h"
 #include "MD3FileData.h"
 #include "MDCNormalTable.h" // shouldn't be included by other units
+#include "AnimMeshBuilder.h"
 
 using namespace Assimp;
 using namespace Assimp::MDC;
@@ -89,6 +90,8 @@ void MDC::BuildVertex(const Frame& frame,
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 MDCImporter::MDCImporter()
+: configFrameID   (0)
+, configAllFrames (false)
 {
 }
 
@@ -180,13 +183,13 @@ void MDCImporter::ValidateSurfaceHeader(BE_NCONST MDC::Surface* pcSurf)
 
     const unsigned int iMax = this->fileSize - (unsigned int)((int8_t*)pcSurf-(int8_t*)pcHeader);
 
-    if (pcSurf->ulOffsetBaseVerts + pcSurf->ulNumVertices * sizeof(MDC::BaseVertex)			> iMax ||
-        (pcSurf->ulNumCompFrames && pcSurf->ulOffsetCompVerts + pcSurf->ulNumVertices * sizeof(MDC::CompressedVertex)	> iMax) ||
+    if (pcSurf->ulOffsetBaseVerts + std::max(1u,pcSurf->ulNumBaseFrames) * pcSurf->ulNumVertices * sizeof(MDC::BaseVertex)	> iMax ||
+        (pcSurf->ulNumCompFrames && pcSurf->ulOffsetCompVerts + pcSurf->ulNumCompFrames * pcSurf->ulNumVertices * sizeof(MDC::CompressedVertex)	> iMax) ||
         pcSurf->ulOffsetTriangles + pcSurf->ulNumTriangles * sizeof(MDC::Triangle)			> iMax ||
         pcSurf->ulOffsetTexCoords + pcSurf->ulNumVertices * sizeof(MDC::TexturCoord)		> iMax ||
         pcSurf->ulOffsetShaders + pcSurf->ulNumShaders * sizeof(MDC::Shader)				> iMax ||
-        pcSurf->ulOffsetFrameBaseFrames + pcSurf->ulNumBaseFrames * 2						> iMax ||
-        (pcSurf->ulNumCompFrames && pcSurf->ulOffsetFrameCompFrames + pcSurf->ulNumCompFrames * 2	> iMax))
+        pcSurf->ulOffsetFrameBaseFrames + pcHeader->ulNumFrames * 2						> iMax ||
+        (pcSurf->ulNumCompFrames && pcSurf->ulOffsetFrameCompFrames + pcHeader->ulNumFrames * 2	> iMax))
     {
         throw DeadlyImportError("Some of the offset values in the MDC surface header "
             "are invalid and point somewhere behind the file.");
@@ -202,6 +205,58 @@ void MDCImporter::SetupProperties(const Importer* pImp)
 	if(static_cast<unsigned int>(-1) == (configFrameID = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_MDC_KEYFRAME,-1))){
 		configFrameID = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_GLOBAL_KEYFRAME,0);
 	}
+	configAllFrames = pImp->GetPropertyBool(AI_CONFIG_IMPORT_ALL_KEYFRAMES,false);
+}
+
+// ------------------------------------------------------------------------------------------------
+void MDCImporter::ReadFrameVertices(const MDC::Surface* pcSurf, unsigned int iFrame,
+	aiVector3D* pcVertices, aiVector3D* pcNormals) const
+{
+	const MDC::Frame& frame = ((const MDC::Frame*)(mBuffer + pcHeader->ulOffsetBorderFrames))[iFrame];
+
+	// get a pointer to the uncompressed vertices
+	int16_t iOfs = ((const int16_t*)((const int8_t*)pcSurf + pcSurf->ulOffsetFrameBaseFrames))[iFrame];
+	AI_SWAP2(iOfs);
+	if (iOfs < 0 || (uint32_t)iOfs >= std::max(1u,pcSurf->ulNumBaseFrames)) {
+		DefaultLogger::get()->error("MDC base frame index is out of range");
+		iOfs = 0;
+	}
+	const MDC::BaseVertex* const pcVerts = (const MDC::BaseVertex*)
+		((const int8_t*)pcSurf + pcSurf->ulOffsetBaseVerts) + iOfs * pcSurf->ulNumVertices;
+
+	// access compressed frames for large frame numbers, but never for the first
+	const MDC::CompressedVertex* pcCVerts = NULL;
+	if (iFrame && pcSurf->ulNumCompFrames > 0) {
+		int16_t iCOfs = ((const int16_t*)((const int8_t*)pcSurf + pcSurf->ulOffsetFrameCompFrames))[iFrame];
+		AI_SWAP2(iCOfs);
+		if (iCOfs >= 0 && (uint32_t)iCOfs < pcSurf->ulNumCompFrames) {
+			pcCVerts = (const MDC::CompressedVertex*)((const int8_t*)pcSurf +
+				pcSurf->ulOffsetCompVerts) + iCOfs * pcSurf->ulNumVertices;
+		}
+	}
+
+	const MDC::Triangle* pcTriangle = (const MDC::Triangle*)
+		((const int8_t*)pcSurf + pcSurf->ulOffsetTriangles);
+
+	for (unsigned int iFace = 0; iFace < pcSurf->ulNumTriangles;++iFace,++pcTriangle) {
+		for (unsigned int iIndex = 0; iIndex < 3;++iIndex,++pcVertices,++pcNormals) {
+			const uint32_t quak = std::min(pcTriangle->aiIndices[iIndex],pcSurf->ulNumVertices-1);
+
+			// compressed vertices?
+			if (pcCVerts) {
+				MDC::BuildVertex(frame,pcVerts[quak],pcCVerts[quak],*pcVertices,*pcNormals);
+				continue;
+			}
+
+			// copy position
+			pcVertices->x = pcVerts[quak].x * AI_MDC_BASE_SCALING + frame.localOrigin.x;
+			pcVertices->y = pcVerts[quak].y * AI_MDC_BASE_SCALING + frame.localOrigin.y;
+			pcVertices->z = pcVerts[quak].z * AI_MDC_BASE_SCALING + frame.localOrigin.z;
+
+			// copy normals
+			MD3::LatLngNormalToVec3( pcVerts[quak].normal, &pcNormals->x );
+		}
+	}
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -230,15 +285,20 @@ void MDCImporter::InternReadFile(
 
 	std::vector<std::string> aszShaders;
 
-	// get a pointer to the frame we want to read
+#if (defined AI_BUILD_BIG_ENDIAN)
+	// swap the frames we want to read, no need to swap the other members
 	BE_NCONST MDC::Frame* pcFrame = (BE_NCONST MDC::Frame*)(this->mBuffer+
 		this->pcHeader->ulOffsetBorderFrames);
 
-	// no need to swap the other members, we won't need them
-	pcFrame += configFrameID;
-	AI_SWAP4( pcFrame->localOrigin[0] );
-	AI_SWAP4( pcFrame->localOrigin[1] );
-	AI_SWAP4( pcFrame->localOrigin[2] );
+	for (unsigned int i = 0; i < pcHeader->ulNumFrames;++i) {
+		if (configAllFrames || i == configFrameID) {
+			AI_SWAP4( pcFrame[i].localOrigin[0] );
+			AI_SWAP4( pcFrame[i].localOrigin[1] );
+			AI_SWAP4( pcFrame[i].localOrigin[2] );
+		}
+	}
+#endif
+	AnimMeshBuilder builder(10.);
 
 	// get the number of valid surfaces
 	BE_NCONST MDC::Surface* pcSurface, *pcSurface2;
@@ -295,10 +355,10 @@ void MDCImporter::InternReadFile(
 		else pcMesh->mMaterialIndex = iDefaultMatIndex;
 
 		// allocate output storage for the mesh
-		aiVector3D* pcVertCur	= pcMesh->mVertices			= new aiVector3D[pcMesh->mNumVertices];
-		aiVector3D* pcNorCur	= pcMesh->mNormals			= new aiVector3D[pcMesh->mNumVertices];
-		aiVector3D* pcUVCur		= pcMesh->mTextureCoords[0] = new aiVector3D[pcMesh->mNumVertices];
-		aiFace* pcFaceCur		= pcMesh->mFaces			= new aiFace[pcMesh->mNumFaces];
+		pcMesh->mVertices			= new aiVector3D[pcMesh->mNumVertices];
+		pcMesh->mNormals			= new aiVector3D[pcMesh->mNumVertices];
+		aiVector3D* pcUVCur			= pcMesh->mTextureCoords[0] = new aiVector3D[pcMesh->mNumVertices];
+		aiFace* pcFaceCur			= pcMesh->mFaces			= new aiFace[pcMesh->mNumFaces];
 
 		// create all vertices/faces
 		BE_NCONST MDC::Triangle* pcTriangle = (BE_NCONST MDC::Triangle*)
@@ -307,16 +367,6 @@ void MDCImporter::InternReadFile(
 		BE_NCONST MDC::TexturCoord* const pcUVs = (BE_NCONST MDC::TexturCoord*)
 			((int8_t*)pcSurface+pcSurface->ulOffsetTexCoords);
 
-		// get a pointer to the uncompressed vertices
-		int16_t iOfs = *((int16_t*) ((int8_t*) pcSurface +
-			pcSurface->ulOffsetFrameBaseFrames) +  this->configFrameID);
-
-		AI_SWAP2(iOfs);
-
-		BE_NCONST MDC::BaseVertex* const pcVerts = (BE_NCONST MDC::BaseVertex*)
-			((int8_t*)pcSurface+pcSurface->ulOffsetBaseVerts) +
-			((int)iOfs * pcSurface->ulNumVertices * 4);
-
 		// do the main swapping stuff ...
 #if (defined AI_BUILD_BIG_ENDIAN)
 
@@ -329,38 +379,28 @@ void MDCImporter::InternReadFile(
 		}
 
 		// swap all vertices
+		BE_NCONST MDC::BaseVertex* const pcVerts = (BE_NCONST MDC::BaseVertex*)
+			((int8_t*)pcSurface+pcSurface->ulOffsetBaseVerts);
+
 		for (unsigned int i = 0; i < pcSurface->ulNumVertices*pcSurface->ulNumBaseFrames;++i)
 		{
-			AI_SWAP2( pcVerts->normal );
-			AI_SWAP2( pcVerts->x );
-			AI_SWAP2( pcVerts->y );
-			AI_SWAP2( pcVerts->z );
+			AI_SWAP2( pcVerts[i].normal );
+			AI_SWAP2( pcVerts[i].x );
+			AI_SWAP2( pcVerts[i].y );
+			AI_SWAP2( pcVerts[i].z );
 		}
 
 		// swap all texture coordinates
 		for (unsigned int i = 0; i < pcSurface->ulNumVertices;++i)
 		{
-			AI_SWAP4( pcUVs->v );
-			AI_SWAP4( pcUVs->v );
+			AI_SWAP4( pcUVs[i].u );
+			AI_SWAP4( pcUVs[i].v );
 		}
 
 #endif
 
-		const MDC::CompressedVertex* pcCVerts = NULL;
-		int16_t* mdcCompVert = NULL;
-
-		// access compressed frames for large frame numbers, but never for the first
-		if( this->configFrameID && pcSurface->ulNumCompFrames > 0 )
-		{
-			mdcCompVert = (int16_t*) ((int8_t*)pcSurface+pcSurface->ulOffsetFrameCompFrames) + this->configFrameID;
-			AI_SWAP2P(mdcCompVert);
-			if( *mdcCompVert >= 0 )
-			{
-				pcCVerts = (const MDC::CompressedVertex*)((int8_t*)pcSurface +
-					pcSurface->ulOffsetCompVerts) + *mdcCompVert * pcSurface->ulNumVertices;
-			}
-			else mdcCompVert = NULL;
-		}
+		// decode positions and normals of the requested frame
+		ReadFrameVertices(pcSurface,configFrameID,pcMesh->mVertices,pcMesh->mNormals);
 
 		// copy all faces
 		for (unsigned int iFace = 0; iFace < pcSurface->ulNumTriangles;++iFace,
@@ -370,8 +410,7 @@ void MDCImporter::InternReadFile(
 			pcFaceCur->mNumIndices = 3;
 			pcFaceCur->mIndices = new unsigned int[3];
 
-			for (unsigned int iIndex = 0; iIndex < 3;++iIndex,
-				++pcVertCur,++pcUVCur,++pcNorCur)
+			for (unsigned int iIndex = 0; iIndex < 3;++iIndex,++pcUVCur)
 			{
 				uint32_t quak = pcTriangle->aiIndices[iIndex];
 				if (quak >= pcSurface->ulNumVertices)
@@ -380,29 +419,9 @@ void MDCImporter::InternReadFile(
 					quak = pcSurface->ulNumVertices-1;
 				}
 
-				// compressed vertices?
-				if (mdcCompVert)
-				{
-					MDC::BuildVertex(*pcFrame,pcVerts[quak],pcCVerts[quak],
-						*pcVertCur,*pcNorCur);
-				}
-				else
-				{
-					// copy position
-					pcVertCur->x = pcVerts[quak].x * AI_MDC_BASE_SCALING;
-					pcVertCur->y = pcVerts[quak].y * AI_MDC_BASE_SCALING;
-					pcVertCur->z = pcVerts[quak].z * AI_MDC_BASE_SCALING;
-
-					// copy normals
-					MD3::LatLngNormalToVec3( pcVerts[quak].normal, &pcNorCur->x );
-
-					// copy texture coordinates
-					pcUVCur->x = pcUVs[quak].u;
-					pcUVCur->y = 1.0f-pcUVs[quak].v; // DX to OGL
-				}
-				pcVertCur->x += pcFrame->localOrigin[0] ;
-				pcVertCur->y += pcFrame->localOrigin[1] ;
-				pcVertCur->z += pcFrame->localOrigin[2] ;
+				// copy texture coordinates
+				pcUVCur->x = pcUVs[quak].u;
+				pcUVCur->y = 1.0f-pcUVs[quak].v; // DX to OGL
 			}
 
 			// swap the face order - DX to OGL
@@ -411,6 +430,18 @@ void MDCImporter::InternReadFile(
 			pcFaceCur->mIndices[2] = iOutIndex + 0;
 		}
 
+		// read all other frames as well if requested
+		if (configAllFrames)
+		{
+			pcMesh->mName.Set(std::string((const char*)pcSurface->ucName));
+			for (unsigned int f = 0; f < pcHeader->ulNumFrames;++f)
+			{
+				aiAnimMesh* pcAnim = AnimMeshBuilder::NewFrame(pcMesh);
+				ReadFrameVertices(pcSurface,f,pcAnim->mVertices,pcAnim->mNormals);
+				builder.AddFrame(pcMesh,pcAnim);
+			}
+		}
+
 		pcSurface =  new ((int8_t*)pcSurface + pcSurface->ulOffsetEnd) MDC::Surface;
 	}
 
@@ -446,6 +477,8 @@ void MDCImporter::InternReadFile(
 	for (unsigned int i = 0; i < pScene->mNumMeshes;++i)
 		pScene->mMeshes[i]->mTextureCoords[3] = NULL;
 
+	builder.Finish(pScene);
+
 	// create materials
 	pScene->mNumMaterials = (unsigned int)aszShaders.size();
 	pScene->mMaterials = new aiMaterial*[pScene->mNumMaterials];
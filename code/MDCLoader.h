@@ -106,12 +106,22 @@ protected:
 	*/
 	void ValidateSurfaceHeader(BE_NCONST MDC::Surface* pcSurf);
 
+	// -------------------------------------------------------------------
+	/** Decode the vertex positions and normals of a surface for a
+	 *  given frame, one per triangle corner
+	*/
+	void ReadFrameVertices(const MDC::Surface* pcSurf, unsigned int iFrame,
+		aiVector3D* pcVertices, aiVector3D* pcNormals) const;
+
 protected:
 
 
 	/** Configuration option: frame to be loaded */
 	unsigned int configFrameID;
 
+	/** Configuration option: import all frames as aiAnimMesh'es */
+	bool configAllFrames;
+
 	/** Header of the MDC file */
 	BE_NCONST MDC::Header* pcHeader;
 
@@ -51,6 +51,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "MDLLoader.h"
 #include "MDLDefaultColorMap.h"
 #include "MD2FileData.h" 
+#include "AnimMeshBuilder.h"
 
 using namespace Assimp;
 
@@ -81,6 +82,8 @@ static const aiImporterDesc desc = {
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 MDLImporter::MDLImporter()
+: configFrameID   (0)
+, configAllFrames (false)
 {}
 
 // ------------------------------------------------------------------------------------------------
@@ -122,6 +125,7 @@ void MDLImporter::SetupProperties(const Importer* pImp)
 	if(static_cast<unsigned int>(-1) == configFrameID)	{
 		configFrameID =  pImp->GetPropertyInteger(AI_CONFIG_IMPORT_GLOBAL_KEYFRAME,0);
 	}
+	configAllFrames = pImp->GetPropertyBool(AI_CONFIG_IMPORT_ALL_KEYFRAMES,false);
 
 	// AI_CONFIG_IMPORT_MDL_COLORMAP - pallette file
 	configPalette =  pImp->GetPropertyString(AI_CONFIG_IMPORT_MDL_COLORMAP,"colormap.lmp");
@@ -383,23 +387,19 @@ void MDLImporter::InternReadFile_Quake1( )
 	szCurrent += sizeof(MDL::Triangle) * pcHeader->num_tris;
 	VALIDATE_FILE_SIZE(szCurrent);
 
-	// now get a pointer to the first frame in the file
-	BE_NCONST MDL::Frame* pcFrames = (BE_NCONST MDL::Frame*)szCurrent;
-	BE_NCONST MDL::SimpleFrame* pcFirstFrame;
+	// now get pointers to the vertex lists of all frames we need
+	std::vector<const MDL::Vertex*> frames;
+	GetFrames_Quake1(pcHeader,const_cast<unsigned char*>(szCurrent),
+		configAllFrames ? UINT_MAX : configFrameID+1,frames);
 
-	if (0 == pcFrames->type)
-	{
-		// get address of single frame
-		pcFirstFrame = &pcFrames->frame;
+	if (frames.empty()) {
+		throw DeadlyImportError( "[Quake 1 MDL] There are no frames in the file");
 	}
-	else
-	{
-		// get the first frame in the group
-		BE_NCONST MDL::GroupFrame* pcFrames2 = (BE_NCONST MDL::GroupFrame*)pcFrames;
-		pcFirstFrame = (BE_NCONST MDL::SimpleFrame*)(&pcFrames2->time + pcFrames->type);
+	unsigned int iFrame = configFrameID;
+	if (iFrame >= frames.size()) {
+		DefaultLogger::get()->warn("[Quake 1 MDL] The requested frame is not existing the file, using the first");
+		iFrame = 0;
 	}
-	BE_NCONST MDL::Vertex* pcVertices = (BE_NCONST MDL::Vertex*) ((pcFirstFrame->name) + sizeof(pcFirstFrame->name));
-	VALIDATE_FILE_SIZE((const unsigned char*)(pcVertices + pcHeader->num_verts));
 
 #ifdef AI_BUILD_BIG_ENDIAN
 	for (int i = 0; i<pcHeader->num_verts;++i)
@@ -442,6 +442,9 @@ void MDLImporter::InternReadFile_Quake1( )
 	pScene->mMeshes = new aiMesh*[1];
 	pScene->mMeshes[0] = pcMesh;
 
+	// decode positions and normals of the requested frame
+	ReadFrameVertices_Quake1(pcHeader,pcTriangles,frames[iFrame],pcMesh->mVertices,pcMesh->mNormals);
+
 	// now iterate through all triangles
 	unsigned int iCurrent = 0;
 	for (unsigned int i = 0; i < (unsigned int) pcHeader->num_tris;++i)
@@ -454,7 +457,6 @@ void MDLImporter::InternReadFile_Quake1( )
 		{
 			pcMesh->mFaces[i].mIndices[c] = iCurrent;
 
-			// read vertices
 			unsigned int iIndex = pcTriangles->vertex[c];
 			if (iIndex >= (unsigned int)pcHeader->num_verts)
 			{
@@ -462,21 +464,6 @@ void MDLImporter::InternReadFile_Quake1( )
 				DefaultLogger::get()->warn("Index overflow in Q1-MDL vertex list.");
 			}
 
-			aiVector3D& vec = pcMesh->mVertices[iCurrent];
-			vec.x = (float)pcVertices[iIndex].v[0] * pcHeader->scale[0];
-			vec.x += pcHeader->translate[0];
-
-			vec.y = (float)pcVertices[iIndex].v[1] * pcHeader->scale[1];
-			vec.y += pcHeader->translate[1];
-			//vec.y *= -1.0f;
-
-			vec.z = (float)pcVertices[iIndex].v[2] * pcHeader->scale[2];
-			vec.z += pcHeader->translate[2];
-
-			// read the normal vector from the precalculated normal table
-			MD2::LookupNormalIndex(pcVertices[iIndex].normalIndex,pcMesh->mNormals[iCurrent]);
-			//pcMesh->mNormals[iCurrent].y *= -1.0f;
-
 			// read texture coordinates
 			float s = (float)pcTexCoords[iIndex].s;
 			float t = (float)pcTexCoords[iIndex].t;
@@ -496,7 +483,82 @@ void MDLImporter::InternReadFile_Quake1( )
 		pcMesh->mFaces[i].mIndices[2] = iTemp+0;
 		pcTriangles++;
 	}
-	return;
+
+	// read all other frames as well if requested
+	if (configAllFrames) {
+		AnimMeshBuilder builder(10.);
+		pcTriangles -= pcHeader->num_tris;
+		for (std::vector<const MDL::Vertex*>::const_iterator it = frames.begin(); it != frames.end(); ++it) {
+			aiAnimMesh* pcAnim = AnimMeshBuilder::NewFrame(pcMesh);
+			ReadFrameVertices_Quake1(pcHeader,pcTriangles,*it,pcAnim->mVertices,pcAnim->mNormals);
+			builder.AddFrame(pcMesh,pcAnim);
+		}
+		builder.Finish(pScene);
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+// Collect the vertex lists of all simple frames in a Quake1 file
+void MDLImporter::GetFrames_Quake1(const MDL::Header* pcHeader,
+	BE_NCONST unsigned char* szCurrent, unsigned int iMax,
+	std::vector<const MDL::Vertex*>& out)
+{
+	const unsigned int iFrameSize = sizeof(MDL::Vertex) * 2 + 16 + 
+		sizeof(MDL::Vertex) * pcHeader->num_verts;
+
+	for (unsigned int i = 0; i < (unsigned int)pcHeader->num_frames && out.size() < iMax;++i)	{
+		VALIDATE_FILE_SIZE(szCurrent + sizeof(int32_t));
+		BE_NCONST int32_t* piType = (BE_NCONST int32_t*)szCurrent;
+		AI_SWAP4P(piType);
+		szCurrent += sizeof(int32_t);
+
+		// a group is a number of simple frames, preceded by a bounding
+		// box and their time intervals.
+		unsigned int iNum = 1;
+		if (0 != *piType)	{
+			VALIDATE_FILE_SIZE(szCurrent + sizeof(int32_t));
+			BE_NCONST int32_t* piNum = (BE_NCONST int32_t*)szCurrent;
+			AI_SWAP4P(piNum);
+			if (*piNum < 0) {
+				throw DeadlyImportError( "[Quake 1 MDL] Invalid frame group size");
+			}
+			iNum = (unsigned int)*piNum;
+			szCurrent += sizeof(int32_t) + sizeof(MDL::Vertex) * 2 + sizeof(float) * iNum;
+		}
+
+		for (unsigned int n = 0; n < iNum && out.size() < iMax;++n)	{
+			VALIDATE_FILE_SIZE(szCurrent + iFrameSize);
+			out.push_back((const MDL::Vertex*)(szCurrent + sizeof(MDL::Vertex) * 2 + 16));
+			szCurrent += iFrameSize;
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+// Decode positions and normals of a Quake1 frame
+void MDLImporter::ReadFrameVertices_Quake1(const MDL::Header* pcHeader,
+	const MDL::Triangle* pcTriangles, const MDL::Vertex* pcVertices,
+	aiVector3D* pcPositionsOut, aiVector3D* pcNormalsOut)
+{
+	for (unsigned int i = 0; i < (unsigned int) pcHeader->num_tris;++i,++pcTriangles)	{
+		for (unsigned int c = 0; c < 3;++c,++pcPositionsOut,++pcNormalsOut)	{
+			const unsigned int iIndex = std::min((unsigned int)pcTriangles->vertex[c],
+				(unsigned int)pcHeader->num_verts-1);
+
+			aiVector3D& vec = *pcPositionsOut;
+			vec.x = (float)pcVertices[iIndex].v[0] * pcHeader->scale[0];
+			vec.x += pcHeader->translate[0];
+
+			vec.y = (float)pcVertices[iIndex].v[1] * pcHeader->scale[1];
+			vec.y += pcHeader->translate[1];
+
+			vec.z = (float)pcVertices[iIndex].v[2] * pcHeader->scale[2];
+			vec.z += pcHeader->translate[2];
+
+			// read the normal vector from the precalculated normal table
+			MD2::LookupNormalIndex(pcVertices[iIndex].normalIndex,*pcNormalsOut);
+		}
+	}
 }
 
 // ------------------------------------------------------------------------------------------------
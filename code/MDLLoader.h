@@ -164,6 +164,25 @@ protected:
 	 */
 	void ValidateHeader_Quake1(const MDL::Header* pcHeader);
 
+	// -------------------------------------------------------------------
+	/** Collect the vertex lists of the simple frames in a Quake1 file,
+	 *  frame groups are expanded to their single frames.
+	 *  \param szCurrent Start of the frame section
+	 *  \param iMax Stop after this many frames have been found
+	 *  \param out Receives one pointer per frame
+	 */
+	void GetFrames_Quake1(const MDL::Header* pcHeader,
+		BE_NCONST unsigned char* szCurrent, unsigned int iMax,
+		std::vector<const MDL::Vertex*>& out);
+
+	// -------------------------------------------------------------------
+	/** Decode positions and normals of a Quake1 frame, one per
+	 *  triangle corner
+	 */
+	void ReadFrameVertices_Quake1(const MDL::Header* pcHeader,
+		const MDL::Triangle* pcTriangles, const MDL::Vertex* pcVertices,
+		aiVector3D* pcPositionsOut, aiVector3D* pcNormalsOut);
+
 
 	// -------------------------------------------------------------------
 	/** Try to load a  palette from the current directory (colormap.lmp)
@@ -431,6 +450,10 @@ protected:
 	/** Configuration option: frame to be loaded */
 	unsigned int configFrameID;
 
+	/** Configuration option: import all frames as aiAnimMesh'es.
+	 *  Supported for Quake1 files only. */
+	bool configAllFrames;
+
 	/** Configuration option: palette to be used to decode palletized images*/
 	std::string configPalette;
 
@@ -257,15 +257,14 @@ void MS3DImporter::InternReadFile( const std::string& pFile,
 			t.indices[i] = stream.GetI2();
 		}
 
-		for (unsigned int i = 0; i < 3; ++i) {
-			ReadVector(stream,t.normals[i]);
-		}
+		stream.GetArray((float*)t.normals,9); // see note in ReadColor()
 
+		// all u coordinates first, then all v coordinates
+		float uv[6];
+		stream.GetArray(uv,6);
 		for (unsigned int i = 0; i < 3; ++i) {
-			stream >> (float&)(t.uv[i].x); // see note in ReadColor()
-		}
-		for (unsigned int i = 0; i < 3; ++i) {
-			stream >> (float&)(t.uv[i].y);
+			t.uv[i].x = uv[i];
+			t.uv[i].y = uv[i+3];
 		}
 
 		t.sg    = stream.GetI1(); 
@@ -43,6 +43,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AssimpPCH.h"
 #include "MakeVerboseFormat.h"
+#include "ProcessHelper.h"
 
 using namespace Assimp;
 
@@ -115,6 +116,13 @@ bool MakeVerboseFormatProcess::MakeVerboseFormat(aiMesh* pcMesh)
 		newWeights[i].reserve(pcMesh->mBones[i]->mNumWeights*3);
 	}
 
+	// remember where each output vertex came from to rebuild the attachment meshes
+	std::vector<unsigned int> vertexSource;
+	if (pcMesh->mNumAnimMeshes)
+	{
+		vertexSource.resize(iNumVerts);
+	}
+
 	// iterate through all faces and build a clean list
 	unsigned int iIndex = 0;
 	for (unsigned int a = 0; a< pcMesh->mNumFaces;++a)
@@ -140,6 +148,11 @@ bool MakeVerboseFormatProcess::MakeVerboseFormat(aiMesh* pcMesh)
 
 			pvPositions[iIndex] = pcMesh->mVertices[pcFace->mIndices[q]];
 
+			if (!vertexSource.empty())
+			{
+				vertexSource[iIndex] = pcFace->mIndices[q];
+			}
+
 			if (pcMesh->HasNormals()) 
 			{
 				pvNormals[iIndex] = pcMesh->mNormals[pcFace->mIndices[q]];
@@ -211,5 +224,17 @@ bool MakeVerboseFormatProcess::MakeVerboseFormat(aiMesh* pcMesh)
 		delete[] pcMesh->mBitangents;
 		pcMesh->mBitangents = pvBitangents;
 	}
+
+	// attachment meshes share the vertex layout of their host, so expand them as well
+	if (pcMesh->mNumAnimMeshes)
+	{
+		aiAnimMesh** anims = MakeSubAnimMeshes(pcMesh,vertexSource);
+		for (unsigned int i = 0; i < pcMesh->mNumAnimMeshes;++i)
+		{
+			delete pcMesh->mAnimMeshes[i];
+		}
+		delete[] pcMesh->mAnimMeshes;
+		pcMesh->mAnimMeshes = anims;
+	}
 	return (pcMesh->mNumVertices != iOldNumVertices);
 }
@@ -47,7 +47,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "OgreImporter.h"
 #include "TinyFormatter.h"
-#include "irrXMLWrapper.h"
+#include "FastXMLReader.h"
 
 static const aiImporterDesc desc = {
 	"Ogre XML Mesh Importer",
@@ -101,11 +101,7 @@ void OgreImporter::InternReadFile(const std::string &pFile, aiScene *pScene, Ass
 	}
 
 	// Read
-	boost::scoped_ptr<CIrrXML_IOStreamReader> xmlStream(new CIrrXML_IOStreamReader(file.get()));
-	boost::scoped_ptr<XmlReader> reader(irr::io::createIrrXMLReader(xmlStream.get()));
-	if (!reader) {
-		throw DeadlyImportError("Failed to create XML Reader for " + pFile);
-	}
+	boost::scoped_ptr<XmlReader> reader(new FastXMLReader(file.get()));
 
 	DefaultLogger::get()->debug("Opened a XML reader for " + pFile);
 
@@ -5,7 +5,7 @@
 #ifndef ASSIMP_BUILD_NO_OGRE_IMPORTER
 
 #include "ParsingUtils.h"
-#include "irrXMLWrapper.h"
+#include "FastXMLReader.h"
 #include "fast_atof.h"
 #include <functional>
 namespace Assimp
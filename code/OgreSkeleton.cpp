@@ -73,11 +73,8 @@ void OgreImporter::ReadSkeleton(const std::string &pFile, Assimp::IOSystem *pIOH
 		throw DeadlyImportError("Failed to open skeleton file " + filename);
 	}
 
-	boost::scoped_ptr<CIrrXML_IOStreamReader> stream(new CIrrXML_IOStreamReader(file.get()));
-	XmlReader* reader = irr::io::createIrrXMLReader(stream.get());
-	if (!reader) {
-		throw DeadlyImportError("Failed to create XML reader for skeleton file " + filename);
-	}
+	boost::scoped_ptr<XmlReader> readerPtr(new FastXMLReader(file.get()));
+	XmlReader* reader = readerPtr.get();
 
 	DefaultLogger::get()->debug("Reading skeleton '" + filename + "'");
 
@@ -215,6 +215,10 @@ bool OptimizeMeshesProcess::CanJoin ( unsigned int a, unsigned int b, unsigned i
 	if (ma->mMaterialIndex != mb->mMaterialIndex || ma->HasBones() != mb->HasBones())
 		return false;
 
+	// Vertex animations refer to meshes by their names, so keep animated meshes as they are
+	if (ma->mNumAnimMeshes || mb->mNumAnimMeshes)
+		return false;
+
 	// Never merge meshes with different kinds of primitives if SortByPType did already
 	// do its work. We would destroy everything again ...
 	if (pts && ma->mPrimitiveTypes != mb->mPrimitiveTypes)
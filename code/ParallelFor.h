@@ -0,0 +1,175 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2012, assimp team
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms, 
+with or without modification, are permitted provided that the 
+following conditions are met:
+
+* Redistributions of source code must retain the above
+copyright notice, this list of conditions and the
+following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the
+following disclaimer in the documentation and/or other
+materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+contributors may be used to endorse or promote products
+derived from this software without specific prior
+written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS 
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT 
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT 
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  ParallelFor.h
+ *  @brief Minimal helper to run independent jobs on all hardware threads
+ */
+#ifndef INCLUDED_AI_PARALLEL_FOR_H
+#define INCLUDED_AI_PARALLEL_FOR_H
+
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+#	include <boost/thread/thread.hpp>
+#	include <boost/thread/mutex.hpp>
+#endif
+
+namespace Assimp	{
+
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+namespace Detail	{
+
+	// ---------------------------------------------------------------------------------
+	/** Worker thread body for ParallelFor(), picks job indices until there are
+	 *  none left or another worker failed. */
+	template <typename Job>
+	class ParallelForWorker
+	{
+	public:
+
+		struct Shared
+		{
+			Shared(Job& job, size_t count) 
+				: job(job), count(count), next(), failed() 
+			{}
+
+			Job& job;
+			const size_t count;
+			size_t next;
+			bool failed;
+			std::string error;
+			boost::mutex mutex;
+		};
+
+		explicit ParallelForWorker(Shared& shared)
+			: shared(shared)
+		{}
+
+		void operator()() 
+		{
+			for(;;) {
+				size_t index;
+				{
+					boost::mutex::scoped_lock lock(shared.mutex);
+					if (shared.failed || shared.next == shared.count) {
+						return;
+					}
+					index = shared.next++;
+				}
+
+				try {
+					shared.job(index);
+				}
+				catch(const std::exception& e) {
+					boost::mutex::scoped_lock lock(shared.mutex);
+					if (!shared.failed) {
+						shared.failed = true;
+						shared.error = e.what();
+					}
+					return;
+				}
+			}
+		}
+
+	private:
+		Shared& shared;
+	};
+}
+#endif
+
+// ---------------------------------------------------------------------------------
+/** @brief Returns the number of threads ParallelFor() uses to run count jobs.
+ *
+ *  A value <= 1 means the jobs run one after another on the calling thread, which
+ *  is always the case in single-threaded builds. Callers whose parallel algorithm 
+ *  does more work than the serial one use this to pick the serial one instead. */
+inline size_t ParallelForThreadCount(size_t count)
+{
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+	return std::min(count, static_cast<size_t>(boost::thread::hardware_concurrency()));
+#else
+	(void)count;
+	return 1;
+#endif
+}
+
+// ---------------------------------------------------------------------------------
+/** @brief Calls job(i) for all i in [0,count).
+ *
+ *  The jobs are distributed over all hardware threads, so they must be independent
+ *  of each other and the order in which they are executed is undefined. Single-
+ *  threaded builds (see ASSIMP_BUILD_SINGLETHREADED) run them one after another 
+ *  on the calling thread. If a job throws, no further jobs are started and the 
+ *  error is rethrown on the calling thread as DeadlyImportError once all running 
+ *  jobs have finished.
+ *
+ *  @code
+ *  struct InflateJob {
+ *    void operator()(size_t i) { ... }
+ *  };
+ *  InflateJob job;
+ *  ParallelFor(arrays.size(), job);
+ *  @endcode */
+template <typename Job>
+void ParallelFor(size_t count, Job& job)
+{
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+	const size_t num_threads = ParallelForThreadCount(count);
+	if (num_threads > 1) {
+		typename Detail::ParallelForWorker<Job>::Shared shared(job,count);
+
+		boost::thread_group threads;
+		for (size_t i = 0; i < num_threads; ++i) {
+			threads.create_thread(Detail::ParallelForWorker<Job>(shared));
+		}
+		threads.join_all();
+
+		if (shared.failed) {
+			throw DeadlyImportError(shared.error);
+		}
+		return;
+	}
+#endif
+	for (size_t i = 0; i < count; ++i) {
+		job(i);
+	}
+}
+
+} // ! Assimp
+
+#endif // !! INCLUDED_AI_PARALLEL_FOR_H
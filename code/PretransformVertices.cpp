@@ -461,6 +461,15 @@ void PretransformVertices::Execute( aiScene* pScene)
 
 		delete[] mesh->mBones;
 		mesh->mBones = NULL;
+
+		// All animations are removed, vertex animations as well. Their
+		// attachment meshes would not survive the merging of meshes anyway.
+		for (unsigned int a = 0; a < mesh->mNumAnimMeshes;++a)
+			delete mesh->mAnimMeshes[a];
+
+		delete[] mesh->mAnimMeshes;
+		mesh->mAnimMeshes = NULL;
+		mesh->mNumAnimMeshes = 0;
 	}
 
 	// now build a list of output meshes
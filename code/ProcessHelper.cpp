@@ -409,7 +409,86 @@ aiMesh* MakeSubmesh(const aiMesh *pMesh, const std::vector<unsigned int> &subMes
 		}
 	}					 
 
+	if(pMesh->mNumAnimMeshes) {
+		std::vector<unsigned int> vertexSource(numSubVerts);
+		for(unsigned int srcIndex = 0; srcIndex < pMesh->mNumVertices; ++srcIndex) {
+			if(vMap[srcIndex]!=UINT_MAX) {
+				vertexSource[vMap[srcIndex]] = srcIndex;
+			}
+		}
+		oMesh->mAnimMeshes = MakeSubAnimMeshes(pMesh,vertexSource);
+		oMesh->mNumAnimMeshes = pMesh->mNumAnimMeshes;
+	}
+
 	return oMesh;
 }
 
+// -------------------------------------------------------------------------------
+aiAnimMesh** MakeSubAnimMeshes(const aiMesh* srcMesh, const std::vector<unsigned int>& vertexSource)
+{
+	if(!srcMesh->mNumAnimMeshes) {
+		return NULL;
+	}
+
+	const unsigned int numVerts = static_cast<unsigned int>(vertexSource.size());
+	aiAnimMesh** out = new aiAnimMesh*[srcMesh->mNumAnimMeshes];
+	for(unsigned int i = 0; i < srcMesh->mNumAnimMeshes; ++i) {
+		const aiAnimMesh* src = srcMesh->mAnimMeshes[i];
+		aiAnimMesh* anim = out[i] = new aiAnimMesh();
+		anim->mNumVertices = numVerts;
+
+		if(src->mVertices) {
+			anim->mVertices = new aiVector3D[numVerts];
+		}
+		if(src->mNormals) {
+			anim->mNormals = new aiVector3D[numVerts];
+		}
+		if(src->mTangents) {
+			anim->mTangents = new aiVector3D[numVerts];
+		}
+		if(src->mBitangents) {
+			anim->mBitangents = new aiVector3D[numVerts];
+		}
+		for(unsigned int c = 0; c < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++c) {
+			if(src->mTextureCoords[c]) {
+				anim->mTextureCoords[c] = new aiVector3D[numVerts];
+			}
+		}
+		for(unsigned int c = 0; c < AI_MAX_NUMBER_OF_COLOR_SETS; ++c) {
+			if(src->mColors[c]) {
+				anim->mColors[c] = new aiColor4D[numVerts];
+			}
+		}
+
+		for(unsigned int v = 0; v < numVerts; ++v) {
+			const unsigned int srcIndex = vertexSource[v];
+			ai_assert(srcIndex < src->mNumVertices);
+
+			if(src->mVertices) {
+				anim->mVertices[v] = src->mVertices[srcIndex];
+			}
+			if(src->mNormals) {
+				anim->mNormals[v] = src->mNormals[srcIndex];
+			}
+			if(src->mTangents) {
+				anim->mTangents[v] = src->mTangents[srcIndex];
+			}
+			if(src->mBitangents) {
+				anim->mBitangents[v] = src->mBitangents[srcIndex];
+			}
+			for(unsigned int c = 0; c < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++c) {
+				if(src->mTextureCoords[c]) {
+					anim->mTextureCoords[c][v] = src->mTextureCoords[c][srcIndex];
+				}
+			}
+			for(unsigned int c = 0; c < AI_MAX_NUMBER_OF_COLOR_SETS; ++c) {
+				if(src->mColors[c]) {
+					anim->mColors[c][v] = src->mColors[c][srcIndex];
+				}
+			}
+		}
+	}
+	return out;
+}
+
 } // namespace Assimp
@@ -315,6 +315,12 @@ const char* MappingTypeToString(aiTextureMapping in);
 // Split a mesh given a list of faces to be contained in the sub mesh
 aiMesh* MakeSubmesh(const aiMesh *superMesh, const std::vector<unsigned int> &subMeshFaces, unsigned int subFlags);
 
+// -------------------------------------------------------------------------------
+// Build the attachment meshes for a mesh whose vertex i was taken from vertex
+// vertexSource[i] of srcMesh. Returns NULL if srcMesh has no attachment meshes,
+// otherwise an array of srcMesh->mNumAnimMeshes new attachment meshes.
+aiAnimMesh** MakeSubAnimMeshes(const aiMesh* srcMesh, const std::vector<unsigned int>& vertexSource);
+
 // -------------------------------------------------------------------------------
 // Utility postprocess step to share the spatial sort tree between
 // all steps which use it to speedup its computations.
@@ -144,7 +144,8 @@ Q3BSPFileImporter::Q3BSPFileImporter() :
 	m_pCurrentMesh( NULL ),
 	m_pCurrentFace( NULL ),
 	m_MaterialLookupMap(),
-	mTextures()
+	mTextures(),
+	m_pZipCache( new ZipEntryCache )
 {
 	// empty
 }
@@ -163,6 +164,9 @@ Q3BSPFileImporter::~Q3BSPFileImporter() {
 		}
 	}
 	m_MaterialLookupMap.clear();
+
+	delete m_pZipCache;
+	m_pZipCache = NULL;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -187,7 +191,7 @@ const aiImporterDesc* Q3BSPFileImporter::GetInfo () const
 //	Import method.
 void Q3BSPFileImporter::InternReadFile(const std::string &rFile, aiScene* pScene, IOSystem* pIOHandler)
 {
-	Q3BSPZipArchive Archive( pIOHandler, rFile );
+	Q3BSPZipArchive Archive( pIOHandler, rFile, m_pZipCache );
 	if ( !Archive.isOpen() )
 	{
 		throw DeadlyImportError( "Failed to open file " + rFile + "." );
@@ -649,7 +653,7 @@ bool Q3BSPFileImporter::importTextureFromArchive( const Q3BSP::Q3BSPModel *pMode
 	std::string textureName, ext;
 	if ( expandFile( pArchive, pTexture->strName, supportedExtensions, textureName, ext ) ) {
 		IOStream *pTextureStream = pArchive->Open( textureName.c_str() );
-		if ( !pTextureStream ) {
+		if ( pTextureStream ) {
 			size_t texSize = pTextureStream->FileSize();
 			aiTexture *pTexture = new aiTexture;
 			pTexture->mHeight = 0;
@@ -50,6 +50,7 @@ namespace Q3BSP
 {
 
 class Q3BSPZipArchive;
+class ZipEntryCache;
 struct Q3BSPModel;
 struct sQ3BSPFace;
 
@@ -106,6 +107,7 @@ private:
 	aiFace *m_pCurrentFace;
 	FaceMap m_MaterialLookupMap;
 	std::vector<aiTexture*> mTextures;
+	Q3BSP::ZipEntryCache *m_pZipCache;
 };
 
 // ------------------------------------------------------------------------------------------------
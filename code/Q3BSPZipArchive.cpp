@@ -135,24 +135,24 @@ zlib_filefunc_def IOSystem2Unzip::get(IOSystem* pIOHandler) {
 }
 
 // ------------------------------------------------------------------------------------------------
-ZipFile::ZipFile(size_t size) : m_Size(size) {
+ZipFile::ZipFile(const boost::shared_array<uint8_t>& buffer, size_t size) : m_Buffer(buffer), m_Size(size), m_SeekPtr(0) {
 	ai_assert(m_Size != 0);
-
-	m_Buffer = std::malloc(m_Size);
 }
 	
 ZipFile::~ZipFile() {
-	std::free(m_Buffer);
-	m_Buffer = NULL;
+	// the buffer may still be referenced by the entry cache
 }
 
 size_t ZipFile::Read(void* pvBuffer, size_t pSize, size_t pCount) {
-	const size_t size = pSize * pCount;
-	assert(size <= m_Size);
-			
-	std::memcpy(pvBuffer, m_Buffer, size);
+	if (!pSize) {
+		return 0;
+	}
 
-	return size;
+	const size_t count = std::min(pCount, (m_Size - m_SeekPtr) / pSize), size = pSize * count;
+	std::memcpy(pvBuffer, m_Buffer.get() + m_SeekPtr, size);
+	m_SeekPtr += size;
+
+	return count;
 }
 
 size_t ZipFile::Write(const void* /*pvBuffer*/, size_t /*pSize*/, size_t /*pCount*/) {
@@ -163,21 +163,103 @@ size_t ZipFile::FileSize() const {
 	return m_Size;
 }
 
-aiReturn ZipFile::Seek(size_t /*pOffset*/, aiOrigin /*pOrigin*/) {
-	return aiReturn_FAILURE;
+aiReturn ZipFile::Seek(size_t pOffset, aiOrigin pOrigin) {
+	size_t target;
+	switch (pOrigin) {
+		case aiOrigin_SET:
+			target = pOffset;
+			break;
+		case aiOrigin_CUR:
+			target = m_SeekPtr + pOffset;
+			break;
+		case aiOrigin_END:
+			target = m_Size - pOffset;
+			break;
+		default:
+			return aiReturn_FAILURE;
+	}
+
+	if (target > m_Size) {
+		return aiReturn_FAILURE;
+	}
+
+	m_SeekPtr = target;
+	return aiReturn_SUCCESS;
 }
 
 size_t ZipFile::Tell() const {
-	return 0;
+	return m_SeekPtr;
 }
 
 void ZipFile::Flush() {
 	// empty
 }
 
+// ------------------------------------------------------------------------------------------------
+ZipEntryCache::ZipEntryCache(size_t maxSize) : m_Entries(), m_MaxSize(maxSize), m_Size(0), m_Clock(0) {
+	// empty
+}
+
+ZipEntryCache::~ZipEntryCache() {
+	// empty
+}
+
+// ------------------------------------------------------------------------------------------------
+//	Looks up a cached entry. Returns false if there is none or if its CRC doesn't match.
+bool ZipEntryCache::get(const std::string &rKey, uLong crc, boost::shared_array<uint8_t> &rBuffer, size_t &rSize) {
+	std::map<std::string, Entry>::iterator it = m_Entries.find(rKey);
+	if (it == m_Entries.end() || it->second.m_Crc != crc) {
+		return false;
+	}
+
+	it->second.m_LastUse = ++m_Clock;
+	rBuffer = it->second.m_Buffer;
+	rSize = it->second.m_Size;
+	return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+//	Adds an entry, evicting the least recently used ones until the size limit is met again.
+void ZipEntryCache::put(const std::string &rKey, uLong crc, const boost::shared_array<uint8_t> &rBuffer, size_t size) {
+	if (size > m_MaxSize) {
+		return;
+	}
+
+	std::map<std::string, Entry>::iterator it = m_Entries.find(rKey);
+	if (it != m_Entries.end()) {
+		m_Size -= it->second.m_Size;
+		m_Entries.erase(it);
+	}
+
+	while (m_Size + size > m_MaxSize) {
+		std::map<std::string, Entry>::iterator lru = m_Entries.begin();
+		for (std::map<std::string, Entry>::iterator cur = m_Entries.begin(); cur != m_Entries.end(); ++cur) {
+			if (cur->second.m_LastUse < lru->second.m_LastUse) {
+				lru = cur;
+			}
+		}
+		m_Size -= lru->second.m_Size;
+		m_Entries.erase(lru);
+	}
+
+	Entry &entry = m_Entries[rKey];
+	entry.m_Buffer = rBuffer;
+	entry.m_Size = size;
+	entry.m_Crc = crc;
+	entry.m_LastUse = ++m_Clock;
+	m_Size += size;
+}
+
+// ------------------------------------------------------------------------------------------------
+void ZipEntryCache::clear() {
+	m_Entries.clear();
+	m_Size = 0;
+}
+
 // ------------------------------------------------------------------------------------------------
 //	Constructor.
-Q3BSPZipArchive::Q3BSPZipArchive(IOSystem* pIOHandler, const std::string& rFile) : m_ZipFileHandle(NULL), m_ArchiveMap() {
+Q3BSPZipArchive::Q3BSPZipArchive(IOSystem* pIOHandler, const std::string& rFile, ZipEntryCache* pCache) : 
+	m_ZipFileHandle(NULL), m_ArchiveMap(), m_ArchiveName(rFile), m_pCache(pCache) {
 	if (! rFile.empty()) {
 		zlib_filefunc_def mapping = IOSystem2Unzip::get(pIOHandler);
 
@@ -192,9 +274,6 @@ Q3BSPZipArchive::Q3BSPZipArchive(IOSystem* pIOHandler, const std::string& rFile)
 // ------------------------------------------------------------------------------------------------
 //	Destructor.
 Q3BSPZipArchive::~Q3BSPZipArchive() {
-	for( std::map<std::string, ZipFile*>::iterator it(m_ArchiveMap.begin()), end(m_ArchiveMap.end()); it != end; ++it ) {
-		delete it->second;
-	}
 	m_ArchiveMap.clear();
 
 	if(m_ZipFileHandle != NULL) {
@@ -217,8 +296,7 @@ bool Q3BSPZipArchive::Exists(const char* pFile) const {
 	bool exist = false;
 
 	if (pFile != NULL) {
-		std::string rFile(pFile);
-		std::map<std::string, ZipFile*>::const_iterator it = m_ArchiveMap.find(rFile);
+		std::map<std::string, ZipFileInfo>::const_iterator it = m_ArchiveMap.find(normalizePath(pFile));
 
 		if(it != m_ArchiveMap.end()) {
 			exist = true;
@@ -239,19 +317,53 @@ char Q3BSPZipArchive::getOsSeparator() const {
 }
 
 // ------------------------------------------------------------------------------------------------
-//	Opens a file, which is part of the archive.
-IOStream *Q3BSPZipArchive::Open(const char* pFile, const char* /*pMode*/) {
+//	Opens a file, which is part of the archive. The entry is decompressed now (or fetched from 
+//	the entry cache) and its data is released again when the stream is closed.
+IOStream *Q3BSPZipArchive::Open(const char* pFile, const char* pMode) {
 	ai_assert(pFile != NULL);
 
-	IOStream* result = NULL;
+	// The archive is read-only
+	if (pMode != NULL && (strchr(pMode, 'w') || strchr(pMode, 'a') || strchr(pMode, '+'))) {
+		return NULL;
+	}
+
+	const std::string name = normalizePath(pFile);
+	std::map<std::string, ZipFileInfo>::iterator it = m_ArchiveMap.find(name);
+	if(it == m_ArchiveMap.end()) {
+		return NULL;
+	}
 
-	std::map<std::string, ZipFile*>::iterator it = m_ArchiveMap.find(pFile);
+	ZipFileInfo &info = it->second;
+	const std::string key = m_ArchiveName + '\0' + name;
 
-	if(it != m_ArchiveMap.end()) {
-		result = (IOStream*) it->second;
+	boost::shared_array<uint8_t> buffer;
+	size_t size = 0;
+	if (m_pCache != NULL && m_pCache->get(key, info.m_Crc, buffer, size)) {
+		return new ZipFile(buffer, size);
 	}
 
-	return result;
+	// Empty entries (i.e. directories) can't be opened as streams
+	if (info.m_Size == 0) {
+		return NULL;
+	}
+
+	if (unzGoToFilePos(m_ZipFileHandle, &info.m_Pos) != UNZ_OK || unzOpenCurrentFile(m_ZipFileHandle) != UNZ_OK) {
+		return NULL;
+	}
+
+	buffer.reset(new uint8_t[info.m_Size]);
+	const int read = unzReadCurrentFile(m_ZipFileHandle, buffer.get(), static_cast<unsigned int>(info.m_Size));
+
+	// unzCloseCurrentFile also verifies the CRC once the entry has been read completely
+	if (unzCloseCurrentFile(m_ZipFileHandle) != UNZ_OK || read != static_cast<int>(info.m_Size)) {
+		return NULL;
+	}
+
+	if (m_pCache != NULL) {
+		m_pCache->put(key, info.m_Crc, buffer, info.m_Size);
+	}
+
+	return new ZipFile(buffer, info.m_Size);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -259,20 +371,30 @@ IOStream *Q3BSPZipArchive::Open(const char* pFile, const char* /*pMode*/) {
 void Q3BSPZipArchive::Close(IOStream *pFile) {
 	ai_assert(pFile != NULL);
 
-	// We don't do anything in case the file would be opened again in the future
+	delete pFile;
 }
 // ------------------------------------------------------------------------------------------------
 //	Returns the file-list of the archive.
 void Q3BSPZipArchive::getFileList(std::vector<std::string> &rFileList) {
 	rFileList.clear();
 
-	for(std::map<std::string, ZipFile*>::iterator it(m_ArchiveMap.begin()), end(m_ArchiveMap.end()); it != end; ++it) {
+	for(std::map<std::string, ZipFileInfo>::iterator it(m_ArchiveMap.begin()), end(m_ArchiveMap.end()); it != end; ++it) {
 		rFileList.push_back(it->first);
 	}
 }
 
 // ------------------------------------------------------------------------------------------------
-//	Maps the archive content.
+//	Entry names in zip files always use forward slashes.
+std::string Q3BSPZipArchive::normalizePath(const char* pFile) {
+	std::string name(pFile);
+	std::replace(name.begin(), name.end(), '\\', '/');
+
+	return name;
+}
+
+// ------------------------------------------------------------------------------------------------
+//	Maps the archive content. Only the central directory is read, entries are decompressed 
+//	on demand.
 bool Q3BSPZipArchive::mapArchive() {
 	bool success = false;
 
@@ -286,17 +408,11 @@ bool Q3BSPZipArchive::mapArchive() {
 					unz_file_info fileInfo;
 
 					if(unzGetCurrentFileInfo(m_ZipFileHandle, &fileInfo, filename, FileNameSize, NULL, 0, NULL, 0) == UNZ_OK) {
-						// The file has EXACTLY the size of uncompressed_size. In C
-						// you need to mark the last character with '\0', so add
-						// another character
-						if(unzOpenCurrentFile(m_ZipFileHandle) == UNZ_OK) {
-							std::pair<std::map<std::string, ZipFile*>::iterator, bool> result = m_ArchiveMap.insert(std::make_pair(filename, new ZipFile(fileInfo.uncompressed_size)));
-
-							if(unzReadCurrentFile(m_ZipFileHandle, result.first->second->m_Buffer, fileInfo.uncompressed_size) == (long int) fileInfo.uncompressed_size) {
-								if(unzCloseCurrentFile(m_ZipFileHandle) == UNZ_OK) {
-									// Nothing to do anymore...
-								}
-							}
+						ZipFileInfo info;
+						if(unzGetFilePos(m_ZipFileHandle, &info.m_Pos) == UNZ_OK) {
+							info.m_Size = fileInfo.uncompressed_size;
+							info.m_Crc = fileInfo.crc;
+							m_ArchiveMap.insert(std::make_pair(std::string(filename), info));
 						}
 					}
 				} while(unzGoToNextFile(m_ZipFileHandle) != UNZ_END_OF_LIST_OF_FILE);
@@ -48,6 +48,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <map>
 #include <cassert>
 
+#include <boost/shared_array.hpp>
+
 namespace Assimp {
 namespace Q3BSP {
 
@@ -82,7 +84,7 @@ class IOSystem2Unzip {
 ///	\class		ZipFile
 ///	\ingroup	Assimp::Q3BSP
 ///
-///	\brief
+///	\brief	A single decompressed archive entry. The data may be shared with a ZipEntryCache.
 // ------------------------------------------------------------------------------------------------
 class ZipFile : public IOStream {
 
@@ -90,7 +92,7 @@ class ZipFile : public IOStream {
 
 	public:
 
-		ZipFile(size_t size);
+		ZipFile(const boost::shared_array<uint8_t>& buffer, size_t size);
 	
 		~ZipFile();
 
@@ -100,7 +102,7 @@ class ZipFile : public IOStream {
 
 		size_t FileSize() const;
 
-		aiReturn Seek(size_t /*pOffset*/, aiOrigin /*pOrigin*/);
+		aiReturn Seek(size_t pOffset, aiOrigin pOrigin);
 
 		size_t Tell() const;
 
@@ -108,9 +110,57 @@ class ZipFile : public IOStream {
 
 	private:
 
-		void* m_Buffer;
+		boost::shared_array<uint8_t> m_Buffer;
 
 		size_t m_Size;
+
+		size_t m_SeekPtr;
+};
+
+// ------------------------------------------------------------------------------------------------
+///	\class		ZipEntryCache
+///	\ingroup	Assimp::Q3BSP
+///
+///	\brief	Keeps recently decompressed archive entries around, up to a given total size. Entries 
+///	are keyed by archive and entry name and validated by their CRC. The least recently used 
+///	entries are dropped first. A cache may be shared by any number of (sequentially used) 
+///	Q3BSPZipArchive instances, so repeated imports from the same archive avoid inflating 
+///	the same entries again.
+// ------------------------------------------------------------------------------------------------
+class ZipEntryCache {
+
+	public:
+
+		static const size_t DefaultMaxSize = 64 * 1024 * 1024;
+
+	public:
+
+		ZipEntryCache(size_t maxSize = DefaultMaxSize);
+
+		~ZipEntryCache();
+
+		bool get(const std::string &rKey, uLong crc, boost::shared_array<uint8_t> &rBuffer, size_t &rSize);
+
+		void put(const std::string &rKey, uLong crc, const boost::shared_array<uint8_t> &rBuffer, size_t size);
+
+		void clear();
+
+	private:
+
+		struct Entry {
+			boost::shared_array<uint8_t> m_Buffer;
+			size_t m_Size;
+			uLong m_Crc;
+			unsigned int m_LastUse;
+		};
+
+		std::map<std::string, Entry> m_Entries;
+
+		size_t m_MaxSize;
+
+		size_t m_Size;
+
+		unsigned int m_Clock;
 };
 
 // ------------------------------------------------------------------------------------------------
@@ -119,6 +169,10 @@ class ZipFile : public IOStream {
 ///	
 ///	\brief	IMplements a zip archive like the WinZip archives. Will be also used to import data 
 ///	from a P3K archive ( Quake level format ).
+///
+///	Only the central directory is read when the archive is opened. Entries are inflated when 
+///	they are opened and released again when they are closed, so the archive can also serve as 
+///	a generic read-only zip IOSystem for other loaders.
 // ------------------------------------------------------------------------------------------------
 class Q3BSPZipArchive : public Assimp::IOSystem {
 
@@ -128,7 +182,7 @@ class Q3BSPZipArchive : public Assimp::IOSystem {
 
 	public:
 
-		Q3BSPZipArchive(IOSystem* pIOHandler, const std::string & rFile);
+		Q3BSPZipArchive(IOSystem* pIOHandler, const std::string & rFile, ZipEntryCache* pCache = NULL);
 
 		~Q3BSPZipArchive();
 
@@ -146,14 +200,25 @@ class Q3BSPZipArchive : public Assimp::IOSystem {
 
 	private:
 
+		struct ZipFileInfo {
+			unz_file_pos m_Pos;
+			size_t m_Size;
+			uLong m_Crc;
+		};
+
 		bool mapArchive();
 
+		static std::string normalizePath(const char* pFile);
+
 	private:
 
 		unzFile m_ZipFileHandle;
 
-		std::map<std::string, ZipFile*> m_ArchiveMap;
+		std::map<std::string, ZipFileInfo> m_ArchiveMap;
+
+		std::string m_ArchiveName;
 
+		ZipEntryCache* m_pCache;
 };
 
 // ------------------------------------------------------------------------------------------------
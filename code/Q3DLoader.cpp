@@ -164,13 +164,7 @@ void Q3DImporter::InternReadFile( const std::string& pFile,
 
 					std::vector<aiVector3D>& verts = mesh.verts;
 					verts.resize(numVerts);
-
-					for (unsigned int i = 0; i < numVerts;++i)
-					{
-						verts[i].x = stream.GetF4();
-						verts[i].y = stream.GetF4();
-						verts[i].z = stream.GetF4();
-					}
+					stream.GetArray((float*)&verts[0],numVerts*3);
 
 					// read all faces
 					numVerts = (unsigned int)stream.GetI4();
@@ -192,27 +186,23 @@ void Q3DImporter::InternReadFile( const std::string& pFile,
 					for (unsigned int i = 0; i < numVerts;++i)
 					{
 						Face& vec = faces[i];
-						for (unsigned int a = 0; a < (unsigned int)vec.indices.size();++a)
-							vec.indices[a] = stream.GetI4();
+						stream.GetArray((uint32_t*)&vec.indices[0],vec.indices.size());
 					}
 
 					// material indices
+					std::vector<uint32_t> mats(numVerts);
+					stream.GetArray(&mats[0],numVerts);
 					for (unsigned int i = 0; i < numVerts;++i)
 					{
-						faces[i].mat = (unsigned int)stream.GetI4();
+						faces[i].mat = mats[i];
 					}
 
 					// read all normals
 					numVerts = (unsigned int)stream.GetI4();
 					std::vector<aiVector3D>& normals = mesh.normals;
 					normals.resize(numVerts);
-
-					for (unsigned int i = 0; i < numVerts;++i)
-					{
-						normals[i].x = stream.GetF4();
-						normals[i].y = stream.GetF4();
-						normals[i].z = stream.GetF4();
-					}
+					if (numVerts)
+						stream.GetArray((float*)&normals[0],numVerts*3);
 
 					numVerts = (unsigned int)stream.GetI4();
 					if (numTextures && numVerts)
@@ -221,19 +211,21 @@ void Q3DImporter::InternReadFile( const std::string& pFile,
 						std::vector<aiVector3D>& uv = mesh.uv;
 						uv.resize(numVerts);
 
+						std::vector<float> coords(numVerts*2);
+						stream.GetArray(&coords[0],coords.size());
 						for (unsigned int i = 0; i < numVerts;++i)
 						{
-							uv[i].x = stream.GetF4();
-							uv[i].y = stream.GetF4();
+							uv[i].x = coords[i*2];
+							uv[i].y = coords[i*2+1];
 						}
 
 						// UV indices
 						for (unsigned int i = 0; i < (unsigned int)faces.size();++i)
 						{
 							Face& vec = faces[i];
+							stream.GetArray((uint32_t*)&vec.uvindices[0],vec.uvindices.size());
 							for (unsigned int a = 0; a < (unsigned int)vec.indices.size();++a)
 							{
-								vec.uvindices[a] = stream.GetI4();
 								if (!i && !a)
 									mesh.prevUVIdx = vec.uvindices[a];
 								else if (vec.uvindices[a] != mesh.prevUVIdx)
@@ -46,6 +46,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <memory>
 #include <typeinfo>
 
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+#	include <boost/thread/recursive_mutex.hpp>
+#	include <boost/atomic.hpp>
+#endif
+
 //
 #if _MSC_VER > 1500 || (defined __GNUC___)
 #	define ASSIMP_STEP_USE_UNORDERED_MULTIMAP
@@ -593,21 +598,8 @@ namespace STEP {
 
 	public:
 
-		Object& operator * () {
-			if (!obj) {
-				LazyInit();
-				ai_assert(obj);
-			}
-			return *obj;
-		}
-
-		const Object& operator * () const {
-			if (!obj) {
-				LazyInit();
-				ai_assert(obj);
-			}
-			return *obj;
-		}
+		Object& operator * ();
+		const Object& operator * () const;
 
 		template <typename T>
 		const T& To() const {
@@ -660,7 +652,12 @@ namespace STEP {
 		DB& db;
 	
 		mutable const char* args;
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+		// only set once the object is complete, see operator*
+		mutable boost::atomic<Object*> obj;
+#else
 		mutable Object* obj;
+#endif
 	};
 
 	template <typename T>
@@ -831,12 +828,13 @@ namespace STEP {
 
 	public:
 
-		// objects indexed by ID - this can grow pretty large (i.e some hundred million 
-		// entries), so use raw pointers to avoid *any* overhead.
-		typedef std::map<uint64_t,const LazyObject* > ObjectMap;
+		// all objects in the order in which they appear in the file. This can grow 
+		// pretty large (i.e some hundred million entries), so use raw pointers to 
+		// avoid *any* overhead.
+		typedef std::vector<const LazyObject* > ObjectList;
 
 		// objects indexed by their declarative type, but only for those that we truly want
-		typedef std::set< const LazyObject*> ObjectSet;
+		typedef std::vector< const LazyObject*> ObjectSet;
 		typedef std::map<std::string, ObjectSet > ObjectMapByType;
 
 		// list of types for which to keep inverse indices for all references
@@ -846,11 +844,62 @@ namespace STEP {
 
 		// references - for each object id the ids of all objects which reference it
 		// this is used to simulate STEP inverse indices for selected types.
-		typedef std::step_unordered_multimap<uint64_t, uint64_t > RefMap;
+		// The referencing ids are stored in one array, grouped by the id they 
+		// reference (compressed sparse rows), so a lookup is a binary search
+		// on the ids followed by a linear range.
+		class RefMap
+		{
+			friend class DB;
+
+		public:
+
+			typedef const uint64_t* const_iterator;
+
+		public:
+
+			// get the ids of all objects referencing the given id, in file order
+			std::pair<const_iterator,const_iterator> GetReferrers(uint64_t id) const {
+				const std::vector<uint64_t>::const_iterator it = std::lower_bound(ids.begin(),ids.end(),id);
+				if (it == ids.end() || *it != id) {
+					const const_iterator none = NULL;
+					return std::make_pair(none,none);
+				}
+
+				const size_t n = std::distance(ids.begin(),it);
+				const const_iterator base = &referrers[0];
+				return std::make_pair(base + offsets[n], base + offsets[n+1]);
+			}
+
+			// total number of references
+			size_t size() const {
+				return referrers.size();
+			}
+
+		private:
+
+			// sorted ids of all referenced objects 
+			std::vector<uint64_t> ids;
+
+			// referrers of ids[i] are referrers[offsets[i]] .. referrers[offsets[i+1]-1]
+			std::vector<size_t> offsets;
+			std::vector<uint64_t> referrers;
+		};
+
 		typedef std::pair<RefMap::const_iterator,RefMap::const_iterator> RefMapRange;
 
+		// a single reference as collected while reading, (who, by_whom)
+		typedef std::pair<uint64_t, uint64_t> Ref;
+
 	private:
 
+		// ids below (object count * DENSE_ID_FACTOR + DENSE_ID_SLACK) are looked up 
+		// in a dense array, all others in a map. STEP ids are usually nearly
+		// contiguous, so the latter only catches outliers.
+		enum {
+			DENSE_ID_FACTOR = 4,
+			DENSE_ID_SLACK = 1024
+		};
+
 		DB(boost::shared_ptr<StreamReaderLE> reader) 
 			: reader(reader)
 			, splitter(*reader,true,true)
@@ -860,8 +909,8 @@ namespace STEP {
 	public:
 
 		~DB() {
-			BOOST_FOREACH(ObjectMap::value_type& o, objects) {
-				delete o.second;
+			BOOST_FOREACH(const LazyObject* o, objects) {
+				delete o;
 			}
 		}
 
@@ -883,7 +932,7 @@ namespace STEP {
 			return *schema;
 		}
 
-		const ObjectMap& GetObjects() const {
+		const ObjectList& GetObjects() const {
 			return objects;
 		}
 
@@ -903,9 +952,14 @@ namespace STEP {
 
 		// get the yet unevaluated object record with a given id
 		const LazyObject* GetObject(uint64_t id) const {
-			const ObjectMap::const_iterator it = objects.find(id);
-			if (it != objects.end()) {
-				return (*it).second;
+			if (id < objects_dense.size() && objects_dense[id]) {
+				return objects_dense[id];
+			}
+			if (!objects_sparse.empty()) {
+				const std::map<uint64_t,const LazyObject*>::const_iterator it = objects_sparse.find(id);
+				if (it != objects_sparse.end()) {
+					return (*it).second;
+				}
 			}
 			return NULL;
 		}
@@ -942,8 +996,8 @@ namespace STEP {
 
 		// evaluate *all* entities in the file. this is a power test for the loader
 		void EvaluateAll() {
-			BOOST_FOREACH(ObjectMap::value_type& e,objects) {
-				**e.second;
+			BOOST_FOREACH(const LazyObject* o,objects) {
+				**o;
 			}
 			ai_assert(evaluated_count == objects.size());
 		}
@@ -959,12 +1013,41 @@ namespace STEP {
 			return splitter;
 		}
 
+		StreamReaderLE& GetReader() {
+			return *reader;
+		}
+
+		// prepare for inserting a number of objects with ids up to max_id
+		void ReserveObjects(size_t count, uint64_t max_id) {
+			objects.reserve(objects.size() + count);
+
+			const uint64_t dense_limit = static_cast<uint64_t>(objects.size() + count) * DENSE_ID_FACTOR + DENSE_ID_SLACK;
+			if (max_id < dense_limit && max_id >= objects_dense.size()) {
+				objects_dense.resize(static_cast<size_t>(max_id) + 1);
+			}
+		}
+
+		// note: if an object with the same id exists, it is superseded but kept alive
 		void InternInsert(const LazyObject* lz) {
-			objects[lz->GetID()] = lz;
+			objects.push_back(lz);
+
+			const uint64_t id = lz->GetID();
+			if (id < objects_dense.size()) {
+				objects_dense[id] = lz;
+			}
+			else if (id < static_cast<uint64_t>(objects.size()) * DENSE_ID_FACTOR + DENSE_ID_SLACK) {
+				objects_dense.resize(static_cast<size_t>(id) + 1);
+				objects_dense[id] = lz;
+			}
+			else {
+				objects_sparse[id] = lz;
+			}
 
-			const ObjectMapByType::iterator it = objects_bytype.find( lz->type );
-			if (it != objects_bytype.end()) {
-				(*it).second.insert(lz);
+			for(std::vector<TrackedType>::iterator it = tracked_types.begin(); it != tracked_types.end(); ++it) {
+				if ((*it).first == lz->type) {
+					(*it).second->push_back(lz);
+					break;
+				}
 			}
 		}
 
@@ -975,7 +1058,13 @@ namespace STEP {
 		
 		void SetTypesToTrack(const char* const* types, size_t N) {
 			for(size_t i = 0; i < N;++i) {
-				objects_bytype[types[i]] = ObjectSet();
+				ObjectSet& set = objects_bytype[types[i]];
+
+				// objects are matched by their static type string
+				const char* const sz = schema->GetStaticStringForToken(types[i]);
+				if (sz) {
+					tracked_types.push_back(TrackedType(sz,&set));
+				}
 			}
 		}
 
@@ -991,17 +1080,40 @@ namespace STEP {
 			return header;
 		}
 
-		void MarkRef(uint64_t who, uint64_t by_whom) {
-			refs.insert(std::make_pair(who,by_whom));
+		// build the inverse indices from a list of all references, in file order
+		void SetRefs(std::vector<Ref>& all_refs) {
+			std::stable_sort(all_refs.begin(), all_refs.end(), CompareRefTarget);
+
+			refs.ids.clear();
+			refs.offsets.clear();
+			refs.referrers.clear();
+			refs.referrers.reserve(all_refs.size());
+
+			BOOST_FOREACH(const Ref& r, all_refs) {
+				if (refs.ids.empty() || refs.ids.back() != r.first) {
+					refs.ids.push_back(r.first);
+					refs.offsets.push_back(refs.referrers.size());
+				}
+				refs.referrers.push_back(r.second);
+			}
+			refs.offsets.push_back(refs.referrers.size());
 		}
 
+		static bool CompareRefTarget(const Ref& a, const Ref& b) {
+			return a.first < b.first;
+		}
 
 
 	private:
 
+		typedef std::pair<const char*, ObjectSet*> TrackedType;
+
 		HeaderInfo header;
-		ObjectMap objects;
+		ObjectList objects;
+		std::vector<const LazyObject*> objects_dense;
+		std::map<uint64_t,const LazyObject*> objects_sparse;
 		ObjectMapByType objects_bytype;
+		std::vector<TrackedType> tracked_types;
 		RefMap refs;
 		InverseWhitelist inv_whitelist;
 
@@ -1011,8 +1123,36 @@ namespace STEP {
 		uint64_t evaluated_count;
 
 		const EXPRESS::ConversionSchema* schema;
+
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+		// guards lazy evaluation, objects may be dereferenced from several
+		// threads at once (i.e. IFC ProcessContainedProducts). Recursive
+		// because converting an object may evaluate the objects it references.
+		mutable boost::recursive_mutex evaluation_mutex;
+#endif
 	};
 
+	// ------------------------------------------------------------------------------
+	inline Object& LazyObject::operator * () {
+		return const_cast<Object&>( *static_cast<const LazyObject&>(*this) );
+	}
+
+	// ------------------------------------------------------------------------------
+	inline const Object& LazyObject::operator * () const {
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+		// objects are evaluated only once, so the lock is needed only until then
+		if (const Object* const o = obj.load(boost::memory_order_acquire)) {
+			return *o;
+		}
+		boost::recursive_mutex::scoped_lock lock(db.evaluation_mutex);
+#endif
+		if (!obj) {
+			LazyInit();
+			ai_assert(obj);
+		}
+		return *static_cast<const Object*>(obj);
+	}
+
 }
 
 
@@ -47,6 +47,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "STEPFileEncoding.h"
 #include "TinyFormatter.h"
 #include "fast_atof.h"
+#include "ParallelFor.h"
 
 
 using namespace Assimp;
@@ -120,8 +121,8 @@ STEP::DB* STEP::ReadFileHeader(boost::shared_ptr<IOStream> stream)
 	for(++splitter; splitter; ++splitter) {
 		const std::string& s = *splitter;
 		if (s == "DATA;") {
-			// here we go, header done, start of data section
-			++splitter;
+			// here we go, header done, start of data section. The underlying
+			// reader is now at the beginning of the first entity.
 			break;
 		}
 
@@ -164,158 +165,405 @@ STEP::DB* STEP::ReadFileHeader(boost::shared_ptr<IOStream> stream)
 
 namespace {
 
-// ------------------------------------------------------------------------------------------------
-// check whether the given line contains an entity definition (i.e. starts with "#<number>=")
-bool IsEntityDef(const std::string& snext)
-{
-	if (snext[0] == '#') {
-		// it is only a new entity if it has a '=' after the
-		// entity ID.
-		for(std::string::const_iterator it = snext.begin()+1; it != snext.end(); ++it) {
-			if (*it == '=') {
+	// DATA sections are scanned in chunks of roughly this size
+	const size_t SCAN_CHUNK_SIZE = 1 << 22;
+
+
+	// ------------------------------------------------------------------------------------------------
+	// an entity record found while scanning the DATA section, the object is created later
+	struct EntityRecord
+	{
+		uint64_t id;
+		uint64_t line;
+		const char* type;
+		char* args;
+	};
+
+
+	// ------------------------------------------------------------------------------------------------
+	struct ScanWarning
+	{
+		uint64_t line;
+		const char* message;
+	};
+
+
+	// ------------------------------------------------------------------------------------------------
+	// a part of the DATA section which contains only complete entity definitions
+	struct ScanChunk
+	{
+		ScanChunk(const char* begin, const char* end) 
+			: begin(begin), end(end), lines(), max_id(), endsec() 
+		{}
+
+		const char* begin;
+		const char* end;
+
+		std::vector<EntityRecord> entities;
+		std::vector<ScanWarning> warnings;
+
+		// references held by entities for which we keep inverse indices
+		std::vector<STEP::DB::Ref> refs;
+
+		// number of line breaks in [begin,end), line numbers in 
+		// entities and warnings are relative to the chunk begin.
+		uint64_t lines;
+
+		// maximum entity id in the chunk
+		uint64_t max_id;
+
+		// chunk contains the ENDSEC; terminator, entities following it are not scanned
+		bool endsec;
+	};
+
+
+	// ------------------------------------------------------------------------------------------------
+	// check whether the given position starts an entity definition (i.e. "#<number>=")
+	bool IsEntityDef(const char* cur, const char* end)
+	{
+		if (cur == end || *cur != '#') {
+			return false;
+		}
+		// it is only a new entity if it has a '=' after the entity ID.
+		for(++cur; cur != end; ++cur) {
+			if (*cur == '=') {
 				return true;
 			}
-			if ((*it < '0' || *it > '9') && *it != ' ') {
+			if ((*cur < '0' || *cur > '9') && *cur != ' ') {
 				break;
 			}
 		}
+		return false;
 	}
-	return false;
-}
 
-}
 
+	// ------------------------------------------------------------------------------------------------
+	// find the first line starting after cur which begins a new entity definition
+	// and follows a completed one. Returns end if there is no such line.
+	const char* FindEntityBoundary(const char* begin, const char* cur, const char* end)
+	{
+		for(;;) {
+			cur = std::find(cur, end, '\n');
+			if (cur == end) {
+				return end;
+			}
 
-// ------------------------------------------------------------------------------------------------
-void STEP::ReadFile(DB& db,const EXPRESS::ConversionSchema& scheme,
-	const char* const* types_to_track, size_t len,
-	const char* const* inverse_indices_to_track, size_t len2)
-{
-	db.SetSchema(scheme);
-	db.SetTypesToTrack(types_to_track,len);
-	db.SetInverseIndicesToTrack(inverse_indices_to_track,len2);
+			const char* prev = cur;
+			while(prev != begin && IsSpaceOrNewLine(*prev)) {
+				--prev;
+			}
 
-	const DB::ObjectMap& map = db.GetObjects();
-	LineSplitter& splitter = db.GetSplitter();
-	
-	while (splitter) {
-		bool has_next = false;
-		std::string s = *splitter;
-		if (s == "ENDSEC;") {
-			break;
+			for(++cur; cur != end && IsSpaceOrNewLine(*cur); ++cur);
+			if (*prev == ';' && IsEntityDef(cur, end)) {
+				return cur;
+			}
 		}
-		s.erase(std::remove(s.begin(), s.end(), ' '), s.end());
+	}
 
-		// want one-based line numbers for human readers, so +1
-		const uint64_t line = splitter.get_index()+1;
-		// LineSplitter already ignores empty lines
-		ai_assert(s.length());
-		if (s[0] != '#') {
-			DefaultLogger::get()->warn(AddLineNumber("expected token \'#\'",line));
-			++splitter;
-			continue;
-		}
-		// ---
-		// extract id, entity class name and argument string,
-		// but don't create the actual object yet. 
-		// ---
-		const std::string::size_type n0 = s.find_first_of('=');
-		if (n0 == std::string::npos) {
-			DefaultLogger::get()->warn(AddLineNumber("expected token \'=\'",line));
-			++splitter;
-			continue;
+
+	// ------------------------------------------------------------------------------------------------
+	// ParallelFor() job to extract all entity records from a number of chunks
+	struct ScanEntitiesJob
+	{
+		ScanEntitiesJob(const STEP::DB& db, const EXPRESS::ConversionSchema& scheme, const char* data_end)
+			: db(db)
+			, scheme(scheme)
+			, data_end(data_end)
+		{}
+
+		~ScanEntitiesJob() {
+			// args not handed over to a LazyObject yet
+			BOOST_FOREACH(ScanChunk& chunk, chunks) {
+				BOOST_FOREACH(EntityRecord& rec, chunk.entities) {
+					delete[] rec.args;
+				}
+			}
 		}
 
-		const uint64_t id = strtoul10_64(s.substr(1,n0-1).c_str());
-		if (!id) {
-			DefaultLogger::get()->warn(AddLineNumber("expected positive, numeric entity id",line));
-			++splitter;
-			continue;
+		void operator()(size_t i) {
+			Scan(chunks[i]);
 		}
-		std::string::size_type n1 = s.find_first_of('(',n0);
-		if (n1 == std::string::npos) {
-			has_next = true;
-			bool ok = false;
-			for( ++splitter; splitter; ++splitter) {
-				const std::string& snext = *splitter;
-				if (snext.empty()) {
+
+		const STEP::DB& db;
+		const EXPRESS::ConversionSchema& scheme;
+		const char* const data_end;
+		std::vector<ScanChunk> chunks;
+
+	private:
+
+		// --------------------------------------------------------------------------------------------
+		void Scan(ScanChunk& chunk) const
+		{
+			chunk.lines = std::count(chunk.begin, chunk.end, '\n');
+
+			const char* cur = chunk.begin;
+			uint64_t line = 0;
+
+			// lowercase entity type, kept to avoid reallocating for every entity
+			std::string type;
+			while(true) {
+				SkipWhitespace(cur, line);
+				if (cur >= chunk.end) {
+					break;
+				}
+
+				if (*cur != '#') {
+					if (data_end - cur >= 7 && !strncmp(cur, "ENDSEC;", 7)) {
+						chunk.endsec = true;
+						break;
+					}
+					Warn(chunk, line, "expected token \'#\'");
+					SkipLine(cur, line);
+					continue;
+				}
+
+				// ---
+				// extract id, entity class name and argument string,
+				// but don't create the actual object yet. 
+				// ---
+				const uint64_t entity_line = line;
+
+				uint64_t id = 0;
+				for(++cur; cur != data_end && (*cur == ' ' || (*cur >= '0' && *cur <= '9')); ++cur) {
+					if (*cur != ' ') {
+						id = id * 10 + static_cast<uint64_t>(*cur - '0');
+					}
+				}
+
+				if (cur == data_end || *cur != '=') {
+					Warn(chunk, line, "expected token \'=\'");
+					SkipLine(cur, line);
 					continue;
 				}
 
-				// the next line doesn't start an entity, so maybe it is 
-				// just a continuation  for this line, keep going
-				if (!IsEntityDef(snext)) {
-					s.append(snext);
-					n1 = s.find_first_of('(',n0);
-					ok = (n1 != std::string::npos);
+				if (!id) {
+					Warn(chunk, line, "expected positive, numeric entity id");
+					SkipLine(cur, line);
+					continue;
 				}
-				else {
-					break;
+
+				++cur;
+				SkipWhitespace(cur, line);
+
+				const char* const type_begin = cur;
+				for(; cur != data_end && *cur != '(' && *cur != ';' && !IsSpaceOrNewLine(*cur); ++cur);
+				const char* const type_end = cur;
+
+				SkipWhitespace(cur, line);
+				if (cur == data_end || *cur != '(') {
+					Warn(chunk, line, "expected token \'(\'");
+					SkipLine(cur, line);
+					continue;
+				}
+
+				const char* const args_begin = cur;
+				if (!SkipArguments(cur, line)) {
+					Warn(chunk, entity_line, "expected token \')\'");
+					SkipLine(cur, line);
+					continue;
+				}
+				const char* const args_end = cur;
+
+				SkipWhitespace(cur, line);
+				if (cur == data_end || *cur != ';') {
+					// drop the entity, but keep whatever follows
+					Warn(chunk, entity_line, "expected token \';\'");
+					continue;
+				}
+				++cur;
+
+				type.assign(type_begin, type_end);
+				std::transform(type.begin(), type.end(), type.begin(), &Assimp::ToLower<char>);
+
+				const char* const sz = scheme.GetStaticStringForToken(type);
+				if (!sz) {
+					continue;
+				}
+
+				// spaces are not significant outside of strings, but the code interpreting
+				// the argument list has always seen them stripped entirely.
+				char* const copysz = new char[args_end - args_begin + 1];
+				char* out = copysz;
+				for(const char* in = args_begin; in != args_end; ++in) {
+					if (*in != ' ' && *in != '\r' && *in != '\n') {
+						*out++ = *in;
+					}
+				}
+				*out = '\0';
+
+				const EntityRecord rec = {id, entity_line, sz, copysz};
+				chunk.entities.push_back(rec);
+				chunk.max_id = std::max(chunk.max_id, id);
+
+				// find any external references and store them in the database.
+				// this helps us emulate STEPs INVERSE fields.
+				if (db.KeepInverseIndicesForType(sz)) {
+					CollectRefs(chunk, id, copysz);
 				}
 			}
+		}
+
+		// --------------------------------------------------------------------------------------------
+		// do a quick scan through the argument tuple and watch out for entity references
+		static void CollectRefs(ScanChunk& chunk, uint64_t id, const char* a)
+		{
+			int64_t skip_depth = 0;
+			while(*a) {
+				if (*a == '(') {
+					++skip_depth;
+				}
+				else if (*a == ')') {
+					--skip_depth;
+				}
 
-			if(!ok) {
-				DefaultLogger::get()->warn(AddLineNumber("expected token \'(\'",line));
-				continue;
+				if (skip_depth >= 1 && *a=='#') {
+					const char* tmp;
+					const uint64_t num = strtoul10_64(a+1,&tmp);
+					chunk.refs.push_back(STEP::DB::Ref(num,id));
+				}
+				++a;
 			}
 		}
 
-		std::string::size_type n2 = s.find_last_of(')');
-		if (n2 == std::string::npos || n2 < n1 || n2 == s.length() - 1 || s[n2 + 1] != ';') {
-			
-			has_next = true;
-			bool ok = false;
-			for( ++splitter; splitter; ++splitter) {
-				const std::string& snext = *splitter;
-				if (snext.empty()) {
+		// --------------------------------------------------------------------------------------------
+		// skip a parenthesized argument list, including nested lists and string literals.
+		bool SkipArguments(const char*& cur, uint64_t& line) const
+		{
+			ai_assert(*cur == '(');
+
+			size_t depth = 0;
+			bool in_string = false;
+			for(; cur != data_end; ++cur) {
+				if (*cur == '\n') {
+					++line;
+				}
+
+				if (in_string) {
+					// escaped quotes ('') just toggle twice
+					in_string = *cur != '\'';
 					continue;
 				}
-				// the next line doesn't start an entity, so maybe it is 
-				// just a continuation  for this line, keep going
-				if (!IsEntityDef(snext)) {
-					s.append(snext);
-					n2 = s.find_last_of(')');
-					ok = !(n2 == std::string::npos || n2 < n1 || n2 == s.length() - 1 || s[n2 + 1] != ';');
+
+				if (*cur == '\'') {
+					in_string = true;
+				}
+				else if (*cur == '(') {
+					++depth;
 				}
-				else {
-					break;
+				else if (*cur == ')' && !--depth) {
+					++cur;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// --------------------------------------------------------------------------------------------
+		void SkipWhitespace(const char*& cur, uint64_t& line) const
+		{
+			for(; cur != data_end && IsSpaceOrNewLine(*cur); ++cur) {
+				if (*cur == '\n') {
+					++line;
 				}
 			}
-			if(!ok) {
-				DefaultLogger::get()->warn(AddLineNumber("expected token \')\'",line));
-				continue;
+		}
+
+		// --------------------------------------------------------------------------------------------
+		void SkipLine(const char*& cur, uint64_t& line) const
+		{
+			cur = std::find(cur, data_end, '\n');
+			if (cur != data_end) {
+				++cur;
+				++line;
 			}
 		}
 
-		if (map.find(id) != map.end()) {
-			DefaultLogger::get()->warn(AddLineNumber((Formatter::format(),"an object with the id #",id," already exists"),line));
+		// --------------------------------------------------------------------------------------------
+		static void Warn(ScanChunk& chunk, uint64_t line, const char* message)
+		{
+			const ScanWarning w = {line, message};
+			chunk.warnings.push_back(w);
 		}
+	};
+}
+
+
+// ------------------------------------------------------------------------------------------------
+void STEP::ReadFile(DB& db,const EXPRESS::ConversionSchema& scheme,
+	const char* const* types_to_track, size_t len,
+	const char* const* inverse_indices_to_track, size_t len2)
+{
+	db.SetSchema(scheme);
+	db.SetTypesToTrack(types_to_track,len);
+	db.SetInverseIndicesToTrack(inverse_indices_to_track,len2);
+
+	// ReadFileHeader() left the reader at the first line of the DATA section
+	StreamReaderLE& reader = db.GetReader();
+	const char* const data_begin = reinterpret_cast<const char*>(reader.GetPtr());
+	const char* const data_end = data_begin + reader.GetRemainingSize();
+
+	// want one-based line numbers for human readers, so +1
+	uint64_t line = std::count(data_begin - reader.GetCurrentPos(), data_begin, '\n') + 1;
+
+	// split the DATA section at entity boundaries and scan the chunks in parallel,
+	// the object records are collected in file order regardless.
+	ScanEntitiesJob job(db, scheme, data_end);
+	for(const char* cur = data_begin; cur != data_end; ) {
+		const char* const next = static_cast<size_t>(data_end - cur) > SCAN_CHUNK_SIZE ? 
+			FindEntityBoundary(cur, cur + SCAN_CHUNK_SIZE, data_end) : data_end;
+
+		job.chunks.push_back(ScanChunk(cur, next));
+		cur = next;
+	}
+
+	ParallelFor(job.chunks.size(), job);
+
+	// ignore everything after the first ENDSEC;
+	bool endsec = false;
+	size_t num_chunks = 0, num_entities = 0, num_refs = 0;
+	uint64_t max_id = 0;
+	while(num_chunks < job.chunks.size() && !endsec) {
+		const ScanChunk& chunk = job.chunks[num_chunks++];
+
+		num_entities += chunk.entities.size();
+		num_refs += chunk.refs.size();
+		max_id = std::max(max_id, chunk.max_id);
+		endsec = chunk.endsec;
+	}
 
-		std::string::size_type ns = n0;
-		do ++ns; while( IsSpace(s.at(ns)));
-		std::string::size_type ne = n1;
-		do --ne; while( IsSpace(s.at(ne)));
-		std::string type = s.substr(ns,ne-ns+1);
-		std::transform( type.begin(), type.end(), type.begin(), &Assimp::ToLower<char>  );
-		const char* sz = scheme.GetStaticStringForToken(type);
-		if(sz) {
-			const std::string::size_type len = n2-n1+1;
-			char* const copysz = new char[len+1];
-			std::copy(s.c_str()+n1,s.c_str()+n2+1,copysz);
-			copysz[len] = '\0';
-			db.InternInsert(new LazyObject(db,id,line,sz,copysz));
+	db.ReserveObjects(num_entities, max_id);
+
+	std::vector<DB::Ref> refs;
+	refs.reserve(num_refs);
+
+	for(size_t i = 0; i < num_chunks; ++i) {
+		ScanChunk& chunk = job.chunks[i];
+
+		BOOST_FOREACH(const ScanWarning& w, chunk.warnings) {
+			DefaultLogger::get()->warn(AddLineNumber(w.message,line + w.line));
 		}
-		if(!has_next) {
-			++splitter;
+
+		BOOST_FOREACH(EntityRecord& rec, chunk.entities) {
+			if (db.GetObject(rec.id)) {
+				DefaultLogger::get()->warn(AddLineNumber((Formatter::format(),"an object with the id #",rec.id," already exists"),line + rec.line));
+			}
+
+			db.InternInsert(new LazyObject(db,rec.id,line + rec.line,rec.type,rec.args));
+			rec.args = NULL;
 		}
+
+		refs.insert(refs.end(), chunk.refs.begin(), chunk.refs.end());
+		line += chunk.lines;
 	}
 
-	if (!splitter) {
+	db.SetRefs(refs);
+
+	if (!endsec) {
 		DefaultLogger::get()->warn("STEP: ignoring unexpected EOF");
 	}
 
 	if ( !DefaultLogger::isNullLogger()){
-		DefaultLogger::get()->debug((Formatter::format(),"STEP: got ",map.size()," object records with ",
+		DefaultLogger::get()->debug((Formatter::format(),"STEP: got ",db.GetObjectCount()," object records with ",
 			db.GetRefs().size()," inverse index entries"));
 	}
 }
@@ -494,32 +742,9 @@ STEP::LazyObject::LazyObject(DB& db, uint64_t id,uint64_t /*line*/, const char*
 	, type(type)
 	, db(db)
 	, args(args)
-	, obj()
+	, obj(NULL)
 {
-	// find any external references and store them in the database.
-	// this helps us emulate STEPs INVERSE fields.
-	if (db.KeepInverseIndicesForType(type)) {
-		const char* a  = args;
-	
-		// do a quick scan through the argument tuple and watch out for entity references
-		int64_t skip_depth = 0;
-		while(*a) {
-			if (*a == '(') {
-				++skip_depth;
-			}
-			else if (*a == ')') {
-				--skip_depth;
-			}
-
-			if (skip_depth >= 1 && *a=='#') {
-				const char* tmp;
-				const int64_t num = static_cast<int64_t>( strtoul10_64(a+1,&tmp) );
-				db.MarkRef(num,id);
-			}
-			++a;
-		}
-
-	}
+	// note: references to other objects are collected by ReadFile() 
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -548,17 +773,20 @@ void STEP::LazyObject::LazyInit() const
 	args = NULL;
 
 	// if the converter fails, it should throw an exception, but it should never return NULL
+	Object* o;
 	try {
-		obj = proc(db,*conv_args);
+		o = proc(db,*conv_args);
 	}
 	catch(const TypeError& t) {
 		// augment line and entity information
 		throw TypeError(t.what(),id);
 	}
 	++db.evaluated_count;
-	ai_assert(obj);
+	ai_assert(o);
 
-	// store the original id in the object instance
-	obj->SetID(id);
+	// store the original id in the object instance, other threads may
+	// use the object as soon as we publish it
+	o->SetID(id);
+	obj = o;
 }
 
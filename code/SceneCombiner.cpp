@@ -634,6 +634,16 @@ void SceneCombiner::MergeScenes(aiScene** _dest, aiScene* master,
 
 		aiScene* deleteMe = src[n].scene;
 
+		// Meshes and animation channels which share their arrays with other 
+		// scenes keep doing so as part of the output scene
+		ScenePrivateData* priv = ScenePriv(deleteMe);
+		if (priv) {
+			ScenePriv(dest)->mSharedMeshes.insert(priv->mSharedMeshes.begin(),priv->mSharedMeshes.end());
+			ScenePriv(dest)->mSharedChannels.insert(priv->mSharedChannels.begin(),priv->mSharedChannels.end());
+			priv->mSharedMeshes.clear();
+			priv->mSharedChannels.clear();
+		}
+
 		// We need to delete the arrays before the destructor is called -
 		// we are reusing the array members
 		delete[] deleteMe->mMeshes;     deleteMe->mMeshes     = NULL;
@@ -1050,6 +1060,9 @@ void SceneCombiner::Copy     (aiMesh** _dest, const aiMesh* src)
 	// make a deep copy of all bones
 	CopyPtrArray(dest->mBones,dest->mBones,dest->mNumBones);
 
+	// make a deep copy of all attachment meshes
+	CopyPtrArray(dest->mAnimMeshes,dest->mAnimMeshes,dest->mNumAnimMeshes);
+
 	// make a deep copy of all faces
 	GetArrayCopy(dest->mFaces,dest->mNumFaces);
 	for (unsigned int i = 0; i < dest->mNumFaces;++i)
@@ -1130,6 +1143,7 @@ void SceneCombiner::Copy     (aiAnimation** _dest, const aiAnimation* src)
 
 	// and reallocate all arrays
 	CopyPtrArray( dest->mChannels, src->mChannels, dest->mNumChannels );
+	CopyPtrArray( dest->mMeshChannels, src->mMeshChannels, dest->mNumMeshChannels );
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1148,6 +1162,43 @@ void SceneCombiner::Copy     (aiNodeAnim** _dest, const aiNodeAnim* src)
 	GetArrayCopy( dest->mRotationKeys, dest->mNumRotationKeys );
 }
 
+// ------------------------------------------------------------------------------------------------
+void SceneCombiner::Copy     (aiAnimMesh** _dest, const aiAnimMesh* src)
+{
+	ai_assert(NULL != _dest && NULL != src);
+
+	aiAnimMesh* dest = *_dest = new aiAnimMesh();
+
+	// get a flat copy
+	::memcpy(dest,src,sizeof(aiAnimMesh));
+
+	// and reallocate all arrays
+	GetArrayCopy( dest->mVertices,   dest->mNumVertices );
+	GetArrayCopy( dest->mNormals ,   dest->mNumVertices );
+	GetArrayCopy( dest->mTangents,   dest->mNumVertices );
+	GetArrayCopy( dest->mBitangents, dest->mNumVertices );
+
+	for (unsigned int n = 0; n < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++n)
+		GetArrayCopy( dest->mTextureCoords[n], dest->mNumVertices );
+
+	for (unsigned int n = 0; n < AI_MAX_NUMBER_OF_COLOR_SETS; ++n)
+		GetArrayCopy( dest->mColors[n], dest->mNumVertices );
+}
+
+// ------------------------------------------------------------------------------------------------
+void SceneCombiner::Copy     (aiMeshAnim** _dest, const aiMeshAnim* src)
+{
+	ai_assert(NULL != _dest && NULL != src);
+
+	aiMeshAnim* dest = *_dest = new aiMeshAnim();
+
+	// get a flat copy
+	::memcpy(dest,src,sizeof(aiMeshAnim));
+
+	// and reallocate all arrays
+	GetArrayCopy( dest->mKeys, dest->mNumKeys );
+}
+
 // ------------------------------------------------------------------------------------------------
 void SceneCombiner::Copy   (aiCamera** _dest,const  aiCamera* src)
 {
@@ -1199,5 +1250,254 @@ void SceneCombiner::Copy     (aiNode** _dest, const aiNode* src)
 	CopyPtrArray( dest->mChildren, src->mChildren,dest->mNumChildren);
 }
 
+// ------------------------------------------------------------------------------------------------
+// Detach an array from the storage it is shared with, either by copying or by forgetting it
+template <typename Type>
+inline void DetachArray (Type*& dest, const Type* shared, unsigned int num, bool copy)
+{
+	if (!dest || dest != shared) {
+		return;
+	}
+	if (copy) {
+		GetArrayCopy(dest,num);
+	}
+	else dest = NULL;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Detach all arrays of a mesh that it shares with a storage mesh
+inline void DetachMesh (aiMesh* mesh, const aiMesh* storage, bool copy)
+{
+	DetachArray( mesh->mVertices,   storage->mVertices,   mesh->mNumVertices, copy );
+	DetachArray( mesh->mNormals,    storage->mNormals,    mesh->mNumVertices, copy );
+	DetachArray( mesh->mTangents,   storage->mTangents,   mesh->mNumVertices, copy );
+	DetachArray( mesh->mBitangents, storage->mBitangents, mesh->mNumVertices, copy );
+
+	for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+		DetachArray( mesh->mTextureCoords[i], storage->mTextureCoords[i], mesh->mNumVertices, copy );
+	}
+	for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_COLOR_SETS; ++i) {
+		DetachArray( mesh->mColors[i], storage->mColors[i], mesh->mNumVertices, copy );
+	}
+
+	if (mesh->mFaces && mesh->mFaces == storage->mFaces) {
+		DetachArray( mesh->mFaces, storage->mFaces, mesh->mNumFaces, copy );
+		for (unsigned int i = 0; copy && i < mesh->mNumFaces; ++i) {
+			aiFace& f = mesh->mFaces[i];
+			GetArrayCopy(f.mIndices,f.mNumIndices);
+		}
+	}
+
+	if (mesh->mBones) {
+		for (unsigned int i = 0; i < std::min(mesh->mNumBones,storage->mNumBones); ++i) {
+			aiBone* bone = mesh->mBones[i];
+			DetachArray( bone->mWeights, storage->mBones[i]->mWeights, bone->mNumWeights, copy );
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+// Detach all key arrays of an animation channel that it shares with a storage channel
+inline void DetachChannel (aiNodeAnim* channel, const aiNodeAnim* storage, bool copy)
+{
+	DetachArray( channel->mPositionKeys, storage->mPositionKeys, channel->mNumPositionKeys, copy );
+	DetachArray( channel->mRotationKeys, storage->mRotationKeys, channel->mNumRotationKeys, copy );
+	DetachArray( channel->mScalingKeys,  storage->mScalingKeys,  channel->mNumScalingKeys,  copy );
+}
+
+// ------------------------------------------------------------------------------------------------
+// Get the storage which owns the arrays of a mesh. If the mesh still owns them
+// itself, they are handed over to a new storage and the mesh borrows them from it.
+inline boost::shared_ptr<aiMesh> GetSharedStorage (ScenePrivateData* priv, aiMesh* mesh)
+{
+	std::map<aiMesh*, boost::shared_ptr<aiMesh> >::const_iterator it = priv->mSharedMeshes.find(mesh);
+	if (it != priv->mSharedMeshes.end()) {
+		return (*it).second;
+	}
+
+	aiMesh* storage = new aiMesh();
+	storage->mNumVertices = mesh->mNumVertices;
+	storage->mVertices    = mesh->mVertices;
+	storage->mNormals     = mesh->mNormals;
+	storage->mTangents    = mesh->mTangents;
+	storage->mBitangents  = mesh->mBitangents;
+
+	std::copy(mesh->mTextureCoords,mesh->mTextureCoords+AI_MAX_NUMBER_OF_TEXTURECOORDS,storage->mTextureCoords);
+	std::copy(mesh->mColors,mesh->mColors+AI_MAX_NUMBER_OF_COLOR_SETS,storage->mColors);
+
+	storage->mNumFaces = mesh->mNumFaces;
+	storage->mFaces    = mesh->mFaces;
+
+	if (mesh->mNumBones && mesh->mBones) {
+		storage->mBones = new aiBone*[storage->mNumBones = mesh->mNumBones];
+		for (unsigned int i = 0; i < storage->mNumBones; ++i) {
+			aiBone* bone = storage->mBones[i] = new aiBone();
+			bone->mNumWeights = mesh->mBones[i]->mNumWeights;
+			bone->mWeights    = mesh->mBones[i]->mWeights;
+		}
+	}
+
+	return priv->mSharedMeshes[mesh] = boost::shared_ptr<aiMesh>(storage);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Same for animation channels
+inline boost::shared_ptr<aiNodeAnim> GetSharedStorage (ScenePrivateData* priv, aiNodeAnim* channel)
+{
+	std::map<aiNodeAnim*, boost::shared_ptr<aiNodeAnim> >::const_iterator it = priv->mSharedChannels.find(channel);
+	if (it != priv->mSharedChannels.end()) {
+		return (*it).second;
+	}
+
+	aiNodeAnim* storage = new aiNodeAnim();
+	storage->mNumPositionKeys = channel->mNumPositionKeys;
+	storage->mPositionKeys    = channel->mPositionKeys;
+	storage->mNumRotationKeys = channel->mNumRotationKeys;
+	storage->mRotationKeys    = channel->mRotationKeys;
+	storage->mNumScalingKeys  = channel->mNumScalingKeys;
+	storage->mScalingKeys     = channel->mScalingKeys;
+
+	return priv->mSharedChannels[channel] = boost::shared_ptr<aiNodeAnim>(storage);
+}
+
+// ------------------------------------------------------------------------------------------------
+void SceneCombiner::CopySceneShared(aiScene** _dest, aiScene* src)
+{
+	ai_assert(NULL != _dest && NULL != src && NULL != ScenePriv(src));
+
+	aiScene* dest = *_dest = new aiScene();
+	ScenePrivateData* srcPriv = ScenePriv(src), *destPriv = ScenePriv(dest);
+
+	// materials, lights, cameras, textures and the node graph are usually small, copy them
+	dest->mNumTextures = src->mNumTextures;
+	CopyPtrArray(dest->mTextures,src->mTextures,dest->mNumTextures);
+
+	dest->mNumMaterials = src->mNumMaterials;
+	CopyPtrArray(dest->mMaterials,src->mMaterials,dest->mNumMaterials);
+
+	dest->mNumLights = src->mNumLights;
+	CopyPtrArray(dest->mLights,src->mLights,dest->mNumLights);
+
+	dest->mNumCameras = src->mNumCameras;
+	CopyPtrArray(dest->mCameras,src->mCameras,dest->mNumCameras);
+
+	Copy( &dest->mRootNode, src->mRootNode);
+
+	// meshes get their own bones, but these reference the shared weights
+	if ((dest->mNumMeshes = src->mNumMeshes)) {
+		dest->mMeshes = new aiMesh*[dest->mNumMeshes];
+	}
+	for (unsigned int i = 0; i < dest->mNumMeshes; ++i) {
+		const aiMesh* srcMesh = src->mMeshes[i];
+		aiMesh* mesh = dest->mMeshes[i] = new aiMesh();
+		mesh->mPrimitiveTypes = srcMesh->mPrimitiveTypes;
+		mesh->mMaterialIndex  = srcMesh->mMaterialIndex;
+		mesh->mName           = srcMesh->mName;
+
+		mesh->mNumVertices = srcMesh->mNumVertices;
+		mesh->mVertices    = srcMesh->mVertices;
+		mesh->mNormals     = srcMesh->mNormals;
+		mesh->mTangents    = srcMesh->mTangents;
+		mesh->mBitangents  = srcMesh->mBitangents;
+
+		std::copy(srcMesh->mTextureCoords,srcMesh->mTextureCoords+AI_MAX_NUMBER_OF_TEXTURECOORDS,mesh->mTextureCoords);
+		std::copy(srcMesh->mNumUVComponents,srcMesh->mNumUVComponents+AI_MAX_NUMBER_OF_TEXTURECOORDS,mesh->mNumUVComponents);
+		std::copy(srcMesh->mColors,srcMesh->mColors+AI_MAX_NUMBER_OF_COLOR_SETS,mesh->mColors);
+
+		mesh->mNumFaces = srcMesh->mNumFaces;
+		mesh->mFaces    = srcMesh->mFaces;
+
+		if (srcMesh->mNumBones && srcMesh->mBones) {
+			mesh->mBones = new aiBone*[mesh->mNumBones = srcMesh->mNumBones];
+			for (unsigned int a = 0; a < mesh->mNumBones; ++a) {
+				const aiBone* srcBone = srcMesh->mBones[a];
+				aiBone* bone = mesh->mBones[a] = new aiBone();
+				bone->mName         = srcBone->mName;
+				bone->mOffsetMatrix = srcBone->mOffsetMatrix;
+				bone->mNumWeights   = srcBone->mNumWeights;
+				bone->mWeights      = srcBone->mWeights;
+			}
+		}
+
+		mesh->mNumAnimMeshes = srcMesh->mNumAnimMeshes;
+		CopyPtrArray(mesh->mAnimMeshes,srcMesh->mAnimMeshes,mesh->mNumAnimMeshes);
+
+		destPriv->mSharedMeshes[mesh] = GetSharedStorage(srcPriv,src->mMeshes[i]);
+	}
+
+	// same for the node animation channels
+	if ((dest->mNumAnimations = src->mNumAnimations)) {
+		dest->mAnimations = new aiAnimation*[dest->mNumAnimations];
+	}
+	for (unsigned int i = 0; i < dest->mNumAnimations; ++i) {
+		const aiAnimation* srcAnim = src->mAnimations[i];
+		aiAnimation* anim = dest->mAnimations[i] = new aiAnimation();
+		anim->mName           = srcAnim->mName;
+		anim->mDuration       = srcAnim->mDuration;
+		anim->mTicksPerSecond = srcAnim->mTicksPerSecond;
+
+		anim->mNumMeshChannels = srcAnim->mNumMeshChannels;
+		CopyPtrArray( anim->mMeshChannels, srcAnim->mMeshChannels, anim->mNumMeshChannels );
+		if (srcAnim->mNumChannels && srcAnim->mChannels) {
+			anim->mChannels = new aiNodeAnim*[anim->mNumChannels = srcAnim->mNumChannels];
+		}
+		for (unsigned int a = 0; a < anim->mNumChannels; ++a) {
+			const aiNodeAnim* srcChannel = srcAnim->mChannels[a];
+			aiNodeAnim* channel = anim->mChannels[a] = new aiNodeAnim();
+			channel->mNodeName        = srcChannel->mNodeName;
+			channel->mPreState        = srcChannel->mPreState;
+			channel->mPostState       = srcChannel->mPostState;
+			channel->mNumPositionKeys = srcChannel->mNumPositionKeys;
+			channel->mPositionKeys    = srcChannel->mPositionKeys;
+			channel->mNumRotationKeys = srcChannel->mNumRotationKeys;
+			channel->mRotationKeys    = srcChannel->mRotationKeys;
+			channel->mNumScalingKeys  = srcChannel->mNumScalingKeys;
+			channel->mScalingKeys     = srcChannel->mScalingKeys;
+
+			destPriv->mSharedChannels[channel] = GetSharedStorage(srcPriv,srcAnim->mChannels[a]);
+		}
+	}
+
+	dest->mFlags = src->mFlags;
+	destPriv->mPPStepsApplied = srcPriv->mPPStepsApplied;
+}
+
+// ------------------------------------------------------------------------------------------------
+void SceneCombiner::UnshareScene(aiScene* scene)
+{
+	ai_assert(NULL != scene);
+	ScenePrivateData* priv = ScenePriv(scene);
+	if (!priv) {
+		return;
+	}
+
+	for (std::map<aiMesh*, boost::shared_ptr<aiMesh> >::iterator it = priv->mSharedMeshes.begin(); it != priv->mSharedMeshes.end(); ++it) {
+		DetachMesh((*it).first,(*it).second.get(),true);
+	}
+	for (std::map<aiNodeAnim*, boost::shared_ptr<aiNodeAnim> >::iterator it = priv->mSharedChannels.begin(); it != priv->mSharedChannels.end(); ++it) {
+		DetachChannel((*it).first,(*it).second.get(),true);
+	}
+	priv->mSharedMeshes.clear();
+	priv->mSharedChannels.clear();
+}
+
+// ------------------------------------------------------------------------------------------------
+void SceneCombiner::ReleaseSharedData(aiScene* scene)
+{
+	ai_assert(NULL != scene);
+	ScenePrivateData* priv = ScenePriv(scene);
+	if (!priv) {
+		return;
+	}
+
+	for (std::map<aiMesh*, boost::shared_ptr<aiMesh> >::iterator it = priv->mSharedMeshes.begin(); it != priv->mSharedMeshes.end(); ++it) {
+		DetachMesh((*it).first,(*it).second.get(),false);
+	}
+	for (std::map<aiNodeAnim*, boost::shared_ptr<aiNodeAnim> >::iterator it = priv->mSharedChannels.begin(); it != priv->mSharedChannels.end(); ++it) {
+		DetachChannel((*it).first,(*it).second.get(),false);
+	}
+	priv->mSharedMeshes.clear();
+	priv->mSharedChannels.clear();
+}
 
 }
@@ -178,7 +178,7 @@ struct SceneHelper
  * The class is currently being used by various postprocessing steps
  * and loaders (ie. LWS).
  */
-class SceneCombiner
+class ASSIMP_API SceneCombiner
 {
 	// class cannot be instanced
 	SceneCombiner() {}
@@ -333,6 +333,39 @@ public:
 	static void CopySceneFlat(aiScene** dest,const aiScene* source);
 
 
+	// -------------------------------------------------------------------
+	/** Get a copy of a scene which shares the vertex channels, faces,
+	 *  bone weights and animation keys with the source scene.
+	 *
+	 *  The shared arrays are reference-counted, they are deleted together
+	 *  with the last scene that uses them. Everything else is copied.
+	 *  Both scenes must treat the shared data as immutable: call 
+	 *  UnshareScene() before modifying any of it. aiScene keeps its 
+	 *  layout, the bookkeeping is done in the private scene data.
+	 *  @param dest Receives a pointer to the new scene
+	 *  @param src Source scene. Its data remains unmodified, but it
+	 *    doesn't own its arrays exclusively anymore afterwards.
+	 */
+	static void CopySceneShared(aiScene** dest, aiScene* source);
+
+
+	// -------------------------------------------------------------------
+	/** Give a scene its own copy of all arrays it shares with other
+	 *  scenes, so it can be modified. Does nothing for scenes which
+	 *  don't share any data.
+	 *  @param scene Scene to be detached from the shared arrays
+	 */
+	static void UnshareScene(aiScene* scene);
+
+
+	// -------------------------------------------------------------------
+	/** Drop the references to the arrays shared with other scenes
+	 *  without copying them. Called by the destructor of aiScene.
+	 *  @param scene Scene that is about to be deleted
+	 */
+	static void ReleaseSharedData(aiScene* scene);
+
+
 	// -------------------------------------------------------------------
 	/** Get a deep copy of a mesh
 	 *
@@ -349,6 +382,8 @@ public:
 	static void Copy  (aiBone** dest, const aiBone* src);
 	static void Copy  (aiLight** dest, const aiLight* src);
 	static void Copy  (aiNodeAnim** dest, const aiNodeAnim* src);
+	static void Copy  (aiAnimMesh** dest, const aiAnimMesh* src);
+	static void Copy  (aiMeshAnim** dest, const aiMeshAnim* src);
 
 	// recursive, of course
 	static void Copy     (aiNode** dest, const aiNode* src);
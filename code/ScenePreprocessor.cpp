@@ -102,14 +102,18 @@ void ScenePreprocessor::ProcessMesh (aiMesh* mesh)
 
 			// Ensure unsued components are zeroed. This will make 1D texture channels work
 			// as if they were 2D channels .. just in case an application doesn't handle
-			// this case
+			// this case. Only write if necessary, the array may be shared with other scenes.
 			if (2 == mesh->mNumUVComponents[i]) {
-				for (; p != end; ++p)
-					p->z = 0.f;
+				for (; p != end; ++p) {
+					if (p->z != 0.f)
+						p->z = 0.f;
+				}
 			}
 			else if (1 == mesh->mNumUVComponents[i]) {
-				for (; p != end; ++p)
-					p->z = p->y = 0.f;
+				for (; p != end; ++p) {
+					if (p->z != 0.f || p->y != 0.f)
+						p->z = p->y = 0.f;
+				}
 			}
 			else if (3 == mesh->mNumUVComponents[i]) {
 			
@@ -251,6 +255,17 @@ void ScenePreprocessor::ProcessAnimation (aiAnimation* anim)
 		}
 	}
 
+	// vertex animation channels count for the duration as well
+	if (anim->mDuration == -1.)	{
+		for (unsigned int i = 0; i < anim->mNumMeshChannels;++i)	{
+			const aiMeshAnim* channel = anim->mMeshChannels[i];
+			for (unsigned int j = 0; j < channel->mNumKeys;++j)	{
+				first = std::min (first, channel->mKeys[j].mTime);
+				last  = std::max (last,  channel->mKeys[j].mTime);
+			}
+		}
+	}
+
 	if (anim->mDuration == -1.)		{
 		DefaultLogger::get()->debug("ScenePreprocessor: Setting animation duration");
 		anim->mDuration = last - std::min( first, 0. );
@@ -69,6 +69,12 @@ struct ScenePrivateData {
 	// and mOrigImporter are no longer safe to rely on and only
 	// serve informative purposes.
 	bool mIsCopy;
+
+	// Meshes and animation channels whose arrays are shared with other
+	// scenes (see SceneCombiner::CopySceneShared()). The keys don't own
+	// these arrays, the values do. The values are never part of a scene.
+	std::map<aiMesh*, boost::shared_ptr<aiMesh> > mSharedMeshes;
+	std::map<aiNodeAnim*, boost::shared_ptr<aiNodeAnim> > mSharedChannels;
 };
 
 // Access private data stored in the scene
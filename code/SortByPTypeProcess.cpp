@@ -266,6 +266,29 @@ void SortByPTypeProcess::Execute( aiScene* pScene)
 				else cols[i] = NULL;
 			}
 
+			// attachment meshes are split along with their host
+			if (mesh->mNumAnimMeshes)
+			{
+				out->mNumAnimMeshes = mesh->mNumAnimMeshes;
+				out->mAnimMeshes = new aiAnimMesh*[out->mNumAnimMeshes];
+				for (unsigned int q = 0; q < mesh->mNumAnimMeshes;++q)
+				{
+					const aiAnimMesh* srcAnim = mesh->mAnimMeshes[q];
+					aiAnimMesh* anim = out->mAnimMeshes[q] = new aiAnimMesh();
+					anim->mNumVertices = out->mNumVertices;
+
+					if (srcAnim->mVertices)
+						anim->mVertices = new aiVector3D[out->mNumVertices];
+					if (srcAnim->mNormals)
+						anim->mNormals  = new aiVector3D[out->mNumVertices];
+					if (srcAnim->mTangents)
+					{
+						anim->mTangents   = new aiVector3D[out->mNumVertices];
+						anim->mBitangents = new aiVector3D[out->mNumVertices];
+					}
+				}
+			}
+
 			typedef std::vector< aiVertexWeight > TempBoneInfo;
 			std::vector< TempBoneInfo > tempBones(mesh->mNumBones);
 
@@ -326,6 +349,20 @@ void SortByPTypeProcess::Execute( aiScene* pScene)
 						*cols[pp]++ = mesh->mColors[pp][idx];
 					}
 
+					for (unsigned int pp = 0; pp < out->mNumAnimMeshes; ++pp)
+					{
+						const aiAnimMesh* srcAnim = mesh->mAnimMeshes[pp];
+						aiAnimMesh* anim = out->mAnimMeshes[pp];
+
+						if (anim->mVertices) anim->mVertices[outIdx] = srcAnim->mVertices[idx];
+						if (anim->mNormals)  anim->mNormals [outIdx] = srcAnim->mNormals [idx];
+						if (anim->mTangents)
+						{
+							anim->mTangents  [outIdx] = srcAnim->mTangents  [idx];
+							anim->mBitangents[outIdx] = srcAnim->mBitangents[idx];
+						}
+					}
+
 					in.mIndices[q] = outIdx++;
 				}
 
@@ -46,6 +46,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 // internal headers of the post-processing framework
 #include "SplitByBoneCountProcess.h"
+#include "ProcessHelper.h"
 
 #include <limits>
 
@@ -304,6 +305,13 @@ void SplitByBoneCountProcess::SplitMesh( const aiMesh* pMesh, std::vector<aiMesh
 
 		ai_assert( nvi == numSubMeshVertices );
 
+		// attachment meshes are split along with their host
+		if( pMesh->mNumAnimMeshes )
+		{
+			newMesh->mNumAnimMeshes = pMesh->mNumAnimMeshes;
+			newMesh->mAnimMeshes = MakeSubAnimMeshes( pMesh, std::vector<unsigned int>( previousVertexIndices.begin(), previousVertexIndices.end()));
+		}
+
 		// Create the bones for the new submesh: first create the bone array
 		newMesh->mNumBones = 0;
 		newMesh->mBones = new aiBone*[numBones];
@@ -271,6 +271,11 @@ void SplitLargeMeshesProcess_Triangle::SplitMesh(
 				}
 			}
 
+			// remember where each output vertex came from to split the attachment meshes
+			std::vector<unsigned int> vertexSource;
+			if (pMesh->mNumAnimMeshes)
+				vertexSource.resize(iCnt);
+
 			// (we will also need to copy the array of indices)
 			unsigned int iCurrent = 0;
 			for (unsigned int p = 0; p < pcMesh->mNumFaces;++p)
@@ -308,6 +313,9 @@ void SplitLargeMeshesProcess_Triangle::SplitMesh(
 					unsigned int iIndexOut = iCurrent++;
 					piOut[v] = iIndexOut;
 
+					if (!vertexSource.empty())
+						vertexSource[iIndexOut] = iIndex;
+
 					// copy positions
 					if (pMesh->mVertices != NULL)
 						pcMesh->mVertices[iIndexOut] = pMesh->mVertices[iIndex];
@@ -338,6 +346,13 @@ void SplitLargeMeshesProcess_Triangle::SplitMesh(
 				}
 			}
 
+			// attachment meshes are split along with their host
+			if (pMesh->mNumAnimMeshes)
+			{
+				pcMesh->mNumAnimMeshes = pMesh->mNumAnimMeshes;
+				pcMesh->mAnimMeshes = MakeSubAnimMeshes(pMesh,vertexSource);
+			}
+
 			// add the newly created mesh to the list
 			avList.push_back(std::pair<aiMesh*, unsigned int>(pcMesh,a));
 		}
@@ -495,6 +510,11 @@ void SplitLargeMeshesProcess_Vertex::SplitMesh(
 			}
 			vFaces.reserve(iEstimatedSize);
 
+			// remember where each output vertex came from to split the attachment meshes
+			std::vector<unsigned int> vertexSource;
+			if (pMesh->mNumAnimMeshes)
+				vertexSource.reserve(iOutVertexNum);
+
 			// (we will also need to copy the array of indices)
 			while (iBase < pMesh->mNumFaces)
 			{
@@ -608,6 +628,9 @@ void SplitLargeMeshesProcess_Vertex::SplitMesh(
 						}
 					}
 
+					if (pMesh->mNumAnimMeshes)
+						vertexSource.push_back(iIndex);
+
 					avWasCopied[iIndex] = pcMesh->mNumVertices;
 					pcMesh->mNumVertices++;
 				}
@@ -655,6 +678,13 @@ void SplitLargeMeshesProcess_Vertex::SplitMesh(
 			for (unsigned int p = 0; p < pcMesh->mNumFaces;++p)
 				pcMesh->mFaces[p] = vFaces[p];
 
+			// attachment meshes are split along with their host
+			if (pMesh->mNumAnimMeshes)
+			{
+				pcMesh->mNumAnimMeshes = pMesh->mNumAnimMeshes;
+				pcMesh->mAnimMeshes = MakeSubAnimMeshes(pMesh,vertexSource);
+			}
+
 			// add the newly created mesh to the list
 			avList.push_back(std::pair<aiMesh*, unsigned int>(pcMesh,a));
 
@@ -103,6 +103,29 @@ public:
 		InternBegin();
 	}
 
+	// ---------------------------------------------------------------------
+	/** Construction from a memory buffer which has already been loaded
+	 *  (i.e. decompressed) by the caller. 
+	 *
+	 *  The StreamReader takes ownership of the buffer, which must have
+	 *  been allocated using new[], and releases it upon destruction.
+	 *  No copy of the data is made.
+	 *  @param data Input buffer. 
+	 *  @param size Size of the input buffer, in bytes.
+	 *  @param le See the stream-based constructors. */
+	StreamReader(int8_t* data, size_t size, bool le = false)
+		: le(le)
+	{
+		ai_assert(data);
+		if (!size) {
+			delete[] data;
+			throw DeadlyImportError("StreamReader: File is empty or EOF is already reached");
+		}
+
+		current = buffer = data;
+		end = limit = &buffer[size];
+	}
+
 	// ---------------------------------------------------------------------
 	~StreamReader() {
 		delete[] buffer;
@@ -233,6 +256,51 @@ public:
 		memcpy(out,ur,bytes);
 	}
 
+	// ---------------------------------------------------------------------
+	/** Read an array of values at once. This is equivalent to reading 
+	 *  them one by one using operator>>, but checks the stream limit only
+	 *  once and converts the byte order in a single tight loop.
+	 *  @param out Destination array, must hold at least n elements
+	 *  @param n Number of elements to read */
+	template <typename T>
+	void GetArray(T* out, size_t n)	{
+		if (n > GetRemainingSizeToLimit() / sizeof(T)) {
+			throw DeadlyImportError("End of file or stream limit was reached");
+		}
+
+		memcpy(out,current,n*sizeof(T));
+		current += n*sizeof(T);
+
+		for (size_t i = 0; i < n; ++i) {
+			Intern :: Getter<SwapEndianess,T,RuntimeSwitch>() (&out[i],le);
+		}
+	}
+
+	// ---------------------------------------------------------------------
+	/** Read the leading values of a number of equally sized records at 
+	 *  once, i.e. a single attribute out of an array of interleaved 
+	 *  structures. The rest of each record is skipped.
+	 *  @param out Destination array, receives n*components elements
+	 *  @param n Number of records to read
+	 *  @param components Number of values to read from each record
+	 *  @param stride Size of a record in bytes, at least 
+	 *    components*sizeof(T) */
+	template <typename T>
+	void GetStridedArray(T* out, size_t n, size_t components, size_t stride)	{
+		ai_assert(stride >= components*sizeof(T));
+		if (stride && n > GetRemainingSizeToLimit() / stride) {
+			throw DeadlyImportError("End of file or stream limit was reached");
+		}
+
+		for (size_t i = 0; i < n; ++i, current += stride) {
+			memcpy(out+i*components,current,components*sizeof(T));
+		}
+
+		for (size_t i = 0; i < n*components; ++i) {
+			Intern :: Getter<SwapEndianess,T,RuntimeSwitch>() (&out[i],le);
+		}
+	}
+
 
 	// ---------------------------------------------------------------------
 	/** Get the current offset from the beginning of the file */
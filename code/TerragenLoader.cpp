@@ -45,6 +45,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #ifndef ASSIMP_BUILD_NO_TERRAGEN_IMPORTER
 #include "TerragenLoader.h"
+#include "HeightfieldBuilder.h"
 
 using namespace Assimp;
 
@@ -65,6 +66,9 @@ static const aiImporterDesc desc = {
 // Constructor to be privately used by Importer
 TerragenImporter::TerragenImporter()
 : configComputeUVs (false)
+, configSharedVertices (false)
+, configTileSize (0)
+, configLODLevels (1)
 {}
 
 // ------------------------------------------------------------------------------------------------
@@ -107,6 +111,11 @@ void TerragenImporter::SetupProperties(const Importer* pImp)
 {
 	// AI_CONFIG_IMPORT_TER_MAKE_UVS
 	configComputeUVs = ( 0 != pImp->GetPropertyInteger(AI_CONFIG_IMPORT_TER_MAKE_UVS,0) );
+
+	// AI_CONFIG_IMPORT_TERRAIN_XXX
+	configSharedVertices = pImp->GetPropertyBool(AI_CONFIG_IMPORT_TERRAIN_SHARED_VERTICES,false);
+	configTileSize = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_TERRAIN_TILE_SIZE,0);
+	configLODLevels = std::max(1,pImp->GetPropertyInteger(AI_CONFIG_IMPORT_TERRAIN_LOD_LEVELS,1));
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -203,52 +212,57 @@ void TerragenImporter::InternReadFile( const std::string& pFile,
 			if (x <= 1 || y <= 1)
 				throw DeadlyImportError("TER: Invalid terrain size");
 
-			// Allocate the output mesh
-			pScene->mMeshes = new aiMesh*[pScene->mNumMeshes = 1];
-			aiMesh* m = pScene->mMeshes[0] = new aiMesh();
-
-			// We return quads
-			aiFace* f = m->mFaces = new aiFace[m->mNumFaces = (x-1)*(y-1)];
-			aiVector3D* pv = m->mVertices = new aiVector3D[m->mNumVertices = m->mNumFaces*4];
-			
-			aiVector3D *uv( NULL );
-			float step_y( 0.0f ), step_x( 0.0f );
-			if (configComputeUVs) {
-				uv = m->mTextureCoords[0] = new aiVector3D[m->mNumVertices];
-				step_y = 1.f/y;
-				step_x = 1.f/x;
+			if (configSharedVertices || configTileSize) {
+				BuildIndexedTerrain(pScene,(const int16_t*)reader.GetPtr(),x,y,hscale,bheight);
 			}
-			const int16_t* data = (const int16_t*)reader.GetPtr();
-
-			for (unsigned int yy = 0, t = 0; yy < y-1;++yy)	{
-				for (unsigned int xx = 0; xx < x-1;++xx,++f)	{
-
-					// make verts
-					const float fy = (float)yy, fx = (float)xx;
-					register unsigned tmp,tmp2;
-					*pv++ = aiVector3D(fx,fy,    (float)data[(tmp2=x*yy)    + xx] * hscale + bheight);
-					*pv++ = aiVector3D(fx,fy+1,  (float)data[(tmp=x*(yy+1)) + xx] * hscale + bheight);
-					*pv++ = aiVector3D(fx+1,fy+1,(float)data[tmp  + xx+1]         * hscale + bheight);
-					*pv++ = aiVector3D(fx+1,fy,  (float)data[tmp2 + xx+1]         * hscale + bheight);
-
-					// also make texture coordinates, if necessary
-					if (configComputeUVs) {
-						*uv++ = aiVector3D( step_x*xx,     step_y*yy,     0.f );
-						*uv++ = aiVector3D( step_x*xx,     step_y*(yy+1), 0.f );
-						*uv++ = aiVector3D( step_x*(xx+1), step_y*(yy+1), 0.f );
-						*uv++ = aiVector3D( step_x*(xx+1), step_y*yy,     0.f );
+			else {
+				// Allocate the output mesh
+				pScene->mMeshes = new aiMesh*[pScene->mNumMeshes = 1];
+				aiMesh* m = pScene->mMeshes[0] = new aiMesh();
+
+				// We return quads
+				aiFace* f = m->mFaces = new aiFace[m->mNumFaces = (x-1)*(y-1)];
+				aiVector3D* pv = m->mVertices = new aiVector3D[m->mNumVertices = m->mNumFaces*4];
+			
+				aiVector3D *uv( NULL );
+				float step_y( 0.0f ), step_x( 0.0f );
+				if (configComputeUVs) {
+					uv = m->mTextureCoords[0] = new aiVector3D[m->mNumVertices];
+					step_y = 1.f/y;
+					step_x = 1.f/x;
+				}
+				const int16_t* data = (const int16_t*)reader.GetPtr();
+
+				for (unsigned int yy = 0, t = 0; yy < y-1;++yy)	{
+					for (unsigned int xx = 0; xx < x-1;++xx,++f)	{
+
+						// make verts
+						const float fy = (float)yy, fx = (float)xx;
+						register unsigned tmp,tmp2;
+						*pv++ = aiVector3D(fx,fy,    (float)data[(tmp2=x*yy)    + xx] * hscale + bheight);
+						*pv++ = aiVector3D(fx,fy+1,  (float)data[(tmp=x*(yy+1)) + xx] * hscale + bheight);
+						*pv++ = aiVector3D(fx+1,fy+1,(float)data[tmp  + xx+1]         * hscale + bheight);
+						*pv++ = aiVector3D(fx+1,fy,  (float)data[tmp2 + xx+1]         * hscale + bheight);
+
+						// also make texture coordinates, if necessary
+						if (configComputeUVs) {
+							*uv++ = aiVector3D( step_x*xx,     step_y*yy,     0.f );
+							*uv++ = aiVector3D( step_x*xx,     step_y*(yy+1), 0.f );
+							*uv++ = aiVector3D( step_x*(xx+1), step_y*(yy+1), 0.f );
+							*uv++ = aiVector3D( step_x*(xx+1), step_y*yy,     0.f );
+						}
+
+						// make indices
+						f->mIndices = new unsigned int[f->mNumIndices = 4];
+						for (unsigned int i = 0; i < 4;++i)
+							f->mIndices[i] = t++;
 					}
-
-					// make indices
-					f->mIndices = new unsigned int[f->mNumIndices = 4];
-					for (unsigned int i = 0; i < 4;++i)
-						f->mIndices[i] = t++;
 				}
-			}
 
-			// Add the mesh to the root node
-			root->mMeshes = new unsigned int[root->mNumMeshes = 1];
-			root->mMeshes[0] = 0;
+				// Add the mesh to the root node
+				root->mMeshes = new unsigned int[root->mNumMeshes = 1];
+				root->mMeshes[0] = 0;
+			}
 		}
 
 		// Get to the next chunk (4 byte aligned)
@@ -258,11 +272,52 @@ void TerragenImporter::InternReadFile( const std::string& pFile,
 	}
 
 	// Check whether we have a mesh now
-	if (pScene->mNumMeshes != 1)
+	if (!pScene->mNumMeshes)
 		throw DeadlyImportError("TER: Unable to load terrain");
 
 	// Set the AI_SCENE_FLAGS_TERRAIN bit
 	pScene->mFlags |= AI_SCENE_FLAGS_TERRAIN;
 }
 
+// ------------------------------------------------------------------------------------------------
+// Build one indexed mesh or a set of tiles from the height samples
+void TerragenImporter::BuildIndexedTerrain(aiScene* pScene, const int16_t* data,
+	unsigned int x, unsigned int y, float hscale, float bheight)
+{
+	std::vector<aiVector3D> positions(x*y), uvs;
+	if (configComputeUVs) {
+		uvs.resize(x*y);
+	}
+
+	const float step_y = 1.f/y, step_x = 1.f/x;
+	for (unsigned int yy = 0, i = 0; yy < y;++yy)	{
+		for (unsigned int xx = 0; xx < x;++xx,++i)	{
+			positions[i] = aiVector3D((float)xx,(float)yy,(float)data[i] * hscale + bheight);
+			if (configComputeUVs) {
+				uvs[i] = aiVector3D( step_x*xx, step_y*yy, 0.f );
+			}
+		}
+	}
+
+	HeightfieldBuilder builder(x,y,&positions[0],NULL,uvs.empty() ? NULL : &uvs[0]);
+
+	std::vector<aiMesh*> meshes;
+	aiNode* const root = pScene->mRootNode;
+	if (configTileSize) {
+		builder.BuildTiles(configTileSize,configLODLevels,root,meshes);
+	}
+	else {
+		meshes.push_back(builder.BuildMesh());
+
+		root->mMeshes = new unsigned int[root->mNumMeshes = 1];
+		root->mMeshes[0] = 0;
+	}
+
+	pScene->mMeshes = new aiMesh*[pScene->mNumMeshes = static_cast<unsigned int>(meshes.size())];
+	std::copy(meshes.begin(),meshes.end(),pScene->mMeshes);
+
+	// faces share their vertices now
+	pScene->mFlags |= AI_SCENE_FLAGS_NON_VERBOSE_FORMAT;
+}
+
 #endif // !! ASSIMP_BUILD_NO_TERRAGEN_IMPORTER
@@ -92,9 +92,17 @@ protected:
 	// -------------------------------------------------------------------
 	void SetupProperties(const Importer* pImp);
 
+	// -------------------------------------------------------------------
+	/** Build an indexed terrain, or a set of terrain tiles, from the
+	 *  ALTW height samples. */
+	void BuildIndexedTerrain(aiScene* pScene, const int16_t* data,
+		unsigned int x, unsigned int y, float hscale, float bheight);
+
 private:
 
 	bool configComputeUVs;
+	bool configSharedVertices;
+	unsigned int configTileSize, configLODLevels;
 
 }; //! class TerragenImporter
 
@@ -215,9 +215,10 @@ void UnrealImporter::InternReadFile( const std::string& pFile,
 
 	// collect vertices
 	std::vector<aiVector3D> vertices(numVert);
-	for (std::vector<aiVector3D>::iterator it = vertices.begin(), end = vertices.end(); it != end; ++it)	{
-		int32_t val = a_reader.GetI4();
-		Unreal::DecompressVertex(*it,val);
+	std::vector<int32_t> packed(numVert);
+	a_reader.GetArray(&packed[0],numVert);
+	for (unsigned int i = 0; i < numVert; ++i)	{
+		Unreal::DecompressVertex(vertices[i],packed[i]);
 	}
 
 	// list of textures. 
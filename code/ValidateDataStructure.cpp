@@ -51,6 +51,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "BaseImporter.h"
 #include "fast_atof.h"
 #include "ProcessHelper.h"
+#include "ParallelFor.h"
 
 // CRT headers
 #include <stdarg.h>
@@ -60,6 +61,9 @@ using namespace Assimp;
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 ValidateDSProcess::ValidateDSProcess()
+: mScene()
+, mLevel(AI_VDS_LEVEL_FULL)
+, mWarnings()
 {}
 
 // ------------------------------------------------------------------------------------------------
@@ -73,6 +77,15 @@ bool ValidateDSProcess::IsActive( unsigned int pFlags) const
 {
 	return (pFlags & aiProcess_ValidateDataStructure) != 0;
 }
+
+// ------------------------------------------------------------------------------------------------
+// Setup configuration properties for the step
+void ValidateDSProcess::SetupProperties(const Importer* pImp)
+{
+	// Get the current value of AI_CONFIG_PP_VDS_LEVEL
+	mLevel = pImp->GetPropertyInteger(AI_CONFIG_PP_VDS_LEVEL,AI_VDS_LEVEL_FULL);
+}
+
 // ------------------------------------------------------------------------------------------------
 AI_WONT_RETURN void ValidateDSProcess::ReportError(const char* msg,...)
 {
@@ -104,6 +117,10 @@ void ValidateDSProcess::ReportWarning(const char* msg,...)
 	ai_assert(iLen > 0);
 
 	va_end(args);
+	if (mWarnings) {
+		mWarnings->push_back("Validation warning: " + std::string(szBuffer,iLen));
+		return;
+	}
 	DefaultLogger::get()->warn("Validation warning: " + std::string(szBuffer,iLen));
 }
 
@@ -117,6 +134,29 @@ inline int HasNameMatch(const aiString& in, aiNode* node)
 	return result;
 }
 
+// ------------------------------------------------------------------------------------------------
+template <typename T>
+inline void ValidateDSProcess::DoArrayValidation(T** parray, unsigned int size, 
+	const char* firstName, const char* secondName)
+{
+	if (size)
+	{
+		if (!parray)
+		{
+			ReportError("aiScene::%s is NULL (aiScene::%s is %i)",
+				firstName, secondName, size);
+		}
+		for (unsigned int i = 0; i < size;++i)
+		{
+			if (!parray[i])
+			{
+				ReportError("aiScene::%s[%i] is NULL (aiScene::%s is %i)",
+					firstName,i,secondName,size);
+			}
+		}
+	}
+}
+
 // ------------------------------------------------------------------------------------------------
 template <typename T>
 inline void ValidateDSProcess::DoValidation(T** parray, unsigned int size, 
@@ -164,7 +204,7 @@ inline void ValidateDSProcess::DoValidationEx(T** parray, unsigned int size,
 			Validate(parray[i]);
 
 			// check whether there are duplicate names
-			for (unsigned int a = i+1; a < size;++a)
+			for (unsigned int a = i+1; mLevel >= AI_VDS_LEVEL_STRUCTURE && a < size;++a)
 			{
 				if (parray[i]->mName == parray[a]->mName)
 				{
@@ -185,7 +225,7 @@ inline void ValidateDSProcess::DoValidationWithNameCheck(T** array,
 	// validate all entries
 	DoValidationEx(array,size,firstName,secondName);
 	
-	for (unsigned int i = 0; i < size;++i)
+	for (unsigned int i = 0; mLevel >= AI_VDS_LEVEL_STRUCTURE && i < size;++i)
 	{
 		int res = HasNameMatch(array[i]->mName,mScene->mRootNode);
 		if (!res)	{
@@ -199,6 +239,43 @@ inline void ValidateDSProcess::DoValidationWithNameCheck(T** array,
 	}
 }
 
+// ------------------------------------------------------------------------------------------------
+// Validates each mesh and animation of the scene on a copy of the step, which collects the 
+// warnings for this item. They are logged afterwards, in the original order.
+class ValidateDSProcess::MeshAndAnimationJob
+{
+public:
+
+	MeshAndAnimationJob(const ValidateDSProcess& process)
+		: process(process)
+		, warnings(process.mScene->mNumMeshes + process.mScene->mNumAnimations)
+	{}
+
+	void operator()(size_t i) {
+		ValidateDSProcess item(process);
+		item.mWarnings = &warnings[i];
+
+		const aiScene* const scene = process.mScene;
+		if (i < scene->mNumMeshes) {
+			item.Validate(scene->mMeshes[i]);
+		}
+		else {
+			item.Validate(scene->mAnimations[i - scene->mNumMeshes]);
+		}
+	}
+
+	void LogWarnings() {
+		BOOST_FOREACH(const std::vector<std::string>& w, warnings) {
+			BOOST_FOREACH(const std::string& s, w) {
+				DefaultLogger::get()->warn(s);
+			}
+		}
+	}
+
+	const ValidateDSProcess& process;
+	std::vector< std::vector<std::string> > warnings;
+};
+
 // ------------------------------------------------------------------------------------------------
 // Executes the post processing step on the given imported data.
 void ValidateDSProcess::Execute( aiScene* pScene)
@@ -207,11 +284,16 @@ void ValidateDSProcess::Execute( aiScene* pScene)
 	DefaultLogger::get()->debug("ValidateDataStructureProcess begin");
 	
 	// validate the node graph of the scene
-	Validate(pScene->mRootNode);
+	if (!pScene->mRootNode) {
+		ReportError("aiScene::mRootNode is NULL");
+	}
+	if (mLevel >= AI_VDS_LEVEL_STRUCTURE) {
+		Validate(pScene->mRootNode);
+	}
 	
 	// validate all meshes
 	if (pScene->mNumMeshes) {
-		DoValidation(pScene->mMeshes,pScene->mNumMeshes,"mMeshes","mNumMeshes");
+		DoArrayValidation(pScene->mMeshes,pScene->mNumMeshes,"mMeshes","mNumMeshes");
 	}
 	else if (!(mScene->mFlags & AI_SCENE_FLAGS_INCOMPLETE))	{
 		ReportError("aiScene::mNumMeshes is 0. At least one mesh must be there");
@@ -222,13 +304,33 @@ void ValidateDSProcess::Execute( aiScene* pScene)
 	
 	// validate all animations
 	if (pScene->mNumAnimations) {
-		DoValidation(pScene->mAnimations,pScene->mNumAnimations,
+		DoArrayValidation(pScene->mAnimations,pScene->mNumAnimations,
 			"mAnimations","mNumAnimations");
 	}
 	else if (pScene->mAnimations)	{
 		ReportError("aiScene::mAnimations is non-null although there are no animations");
 	}
 
+	// Meshes and animations hold most of the data of a scene and can be validated 
+	// independently of each other. This is only worth a thread if all faces, weights
+	// and keys are checked, though.
+	MeshAndAnimationJob job(*this);
+	try {
+		if (mLevel >= AI_VDS_LEVEL_FULL) {
+			ParallelFor(job.warnings.size(),job);
+		}
+		else {
+			for (size_t i = 0; i < job.warnings.size(); ++i) {
+				job(i);
+			}
+		}
+	}
+	catch(...) {
+		job.LogWarnings();
+		throw;
+	}
+	job.LogWarnings();
+
 	// validate all cameras
 	if (pScene->mNumCameras) {
 		DoValidationWithNameCheck(pScene->mCameras,pScene->mNumCameras,
@@ -320,51 +422,6 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh)
 
 	Validate(&pMesh->mName);
 
-	for (unsigned int i = 0; i < pMesh->mNumFaces; ++i)
-	{
-		aiFace& face = pMesh->mFaces[i];
-
-		if (pMesh->mPrimitiveTypes)
-		{
-			switch (face.mNumIndices)
-			{
-			case 0:
-				ReportError("aiMesh::mFaces[%i].mNumIndices is 0",i);
-			case 1:
-				if (0 == (pMesh->mPrimitiveTypes & aiPrimitiveType_POINT))
-				{
-					ReportError("aiMesh::mFaces[%i] is a POINT but aiMesh::mPrimtiveTypes "
-						"does not report the POINT flag",i);
-				}
-				break;
-			case 2:
-				if (0 == (pMesh->mPrimitiveTypes & aiPrimitiveType_LINE))
-				{
-					ReportError("aiMesh::mFaces[%i] is a LINE but aiMesh::mPrimtiveTypes "
-						"does not report the LINE flag",i);
-				}
-				break;
-			case 3:
-				if (0 == (pMesh->mPrimitiveTypes & aiPrimitiveType_TRIANGLE))
-				{
-					ReportError("aiMesh::mFaces[%i] is a TRIANGLE but aiMesh::mPrimtiveTypes "
-						"does not report the TRIANGLE flag",i);
-				}
-				break;
-			default:
-				if (0 == (pMesh->mPrimitiveTypes & aiPrimitiveType_POLYGON))
-				{
-					this->ReportError("aiMesh::mFaces[%i] is a POLYGON but aiMesh::mPrimtiveTypes "
-						"does not report the POLYGON flag",i);
-				}
-				break;
-			};
-		}
-
-		if (!face.mIndices)
-			ReportError("aiMesh::mFaces[%i].mIndices is NULL",i);
-	}
-
 	// positions must always be there ...
 	if (!pMesh->mNumVertices || (!pMesh->mVertices && !mScene->mFlags))	{
 		ReportError("The mesh contains no vertices");
@@ -387,42 +444,6 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh)
 		ReportError("Mesh contains no faces");
 	}
 
-	// now check whether the face indexing layout is correct:
-	// unique vertices, pseudo-indexed.
-	std::vector<bool> abRefList;
-	abRefList.resize(pMesh->mNumVertices,false);
-	for (unsigned int i = 0; i < pMesh->mNumFaces;++i)
-	{
-		aiFace& face = pMesh->mFaces[i];
-		if (face.mNumIndices > AI_MAX_FACE_INDICES) {
-			ReportError("Face %u has too many faces: %u, but the limit is %u",i,face.mNumIndices,AI_MAX_FACE_INDICES);
-		}
-
-		for (unsigned int a = 0; a < face.mNumIndices;++a)
-		{
-			if (face.mIndices[a] >= pMesh->mNumVertices)	{
-				ReportError("aiMesh::mFaces[%i]::mIndices[%i] is out of range",i,a);
-			}
-			// the MSB flag is temporarily used by the extra verbose
-			// mode to tell us that the JoinVerticesProcess might have 
-			// been executed already.
-			if ( !(this->mScene->mFlags & AI_SCENE_FLAGS_NON_VERBOSE_FORMAT ) && abRefList[face.mIndices[a]])
-			{
-				ReportError("aiMesh::mVertices[%i] is referenced twice - second "
-					"time by aiMesh::mFaces[%i]::mIndices[%i]",face.mIndices[a],i,a);
-			}
-			abRefList[face.mIndices[a]] = true;
-		}
-	}
-
-	// check whether there are vertices that aren't referenced by a face
-	bool b = false;
-	for (unsigned int i = 0; i < pMesh->mNumVertices;++i)	{
-		if (!abRefList[i])b = true;
-	}
-	abRefList.clear();
-	if (b)ReportWarning("There are unreferenced vertices");
-
 	// texture channel 2 may not be set if channel 1 is zero ...
 	{
 		unsigned int i = 0;
@@ -452,17 +473,31 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh)
 			}
 	}
 
+	if (pMesh->mNumBones && !pMesh->mBones)	{
+		ReportError("aiMesh::mBones is NULL (aiMesh::mNumBones is %i)",
+			pMesh->mNumBones);
+	}
+	else if (!pMesh->mNumBones && pMesh->mBones)	{
+		ReportError("aiMesh::mBones is non-null although there are no bones");
+	}
+
+	if (pMesh->mNumAnimMeshes && !pMesh->mAnimMeshes)	{
+		ReportError("aiMesh::mAnimMeshes is NULL (aiMesh::mNumAnimMeshes is %i)",
+			pMesh->mNumAnimMeshes);
+	}
+	else if (!pMesh->mNumAnimMeshes && pMesh->mAnimMeshes)	{
+		ReportError("aiMesh::mAnimMeshes is non-null although there are no attachment meshes");
+	}
+
+	if (mLevel < AI_VDS_LEVEL_STRUCTURE) {
+		return;
+	}
 
 	// now validate all bones
 	if (pMesh->mNumBones)
 	{
-		if (!pMesh->mBones)
-		{
-			ReportError("aiMesh::mBones is NULL (aiMesh::mNumBones is %i)",
-				pMesh->mNumBones);
-		}
 		boost::scoped_array<float> afSum(NULL);
-		if (pMesh->mNumVertices)
+		if (mLevel >= AI_VDS_LEVEL_FULL)
 		{
 			afSum.reset(new float[pMesh->mNumVertices]);
 			for (unsigned int i = 0; i < pMesh->mNumVertices;++i)
@@ -473,20 +508,19 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh)
 		for (unsigned int i = 0; i < pMesh->mNumBones;++i)
 		{
 			const aiBone* bone = pMesh->mBones[i];
-			if (bone->mNumWeights > AI_MAX_BONE_WEIGHTS) {
-				ReportError("Bone %u has too many weights: %u, but the limit is %u",i,bone->mNumWeights,AI_MAX_BONE_WEIGHTS);
-			}
-
-			if (!pMesh->mBones[i])
+			if (!bone)
 			{
 				ReportError("aiMesh::mBones[%i] is NULL (aiMesh::mNumBones is %i)",
 					i,pMesh->mNumBones);
 			}
-			Validate(pMesh,pMesh->mBones[i],afSum.get());
+			if (bone->mNumWeights > AI_MAX_BONE_WEIGHTS) {
+				ReportError("Bone %u has too many weights: %u, but the limit is %u",i,bone->mNumWeights,AI_MAX_BONE_WEIGHTS);
+			}
+			Validate(pMesh,bone,afSum.get());
 
 			for (unsigned int a = i+1; a < pMesh->mNumBones;++a)
 			{
-				if (pMesh->mBones[i]->mName == pMesh->mBones[a]->mName)
+				if (bone->mName == pMesh->mBones[a]->mName)
 				{
 					ReportError("aiMesh::mBones[%i] has the same name as "
 						"aiMesh::mBones[%i]",i,a);
@@ -494,17 +528,111 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh)
 			}
 		}
 		// check whether all bone weights for a vertex sum to 1.0 ...
-		for (unsigned int i = 0; i < pMesh->mNumVertices;++i)
+		for (unsigned int i = 0; afSum.get() && i < pMesh->mNumVertices;++i)
 		{
 			if (afSum[i] && (afSum[i] <= 0.94 || afSum[i] >= 1.05))	{
 				ReportWarning("aiMesh::mVertices[%i]: bone weight sum != 1.0 (sum is %f)",i,afSum[i]);
 			}
 		}
 	}
-	else if (pMesh->mBones)
+
+	// validate all attachment meshes
+	for (unsigned int i = 0; i < pMesh->mNumAnimMeshes;++i)
 	{
-		ReportError("aiMesh::mBones is non-null although there are no bones");
+		const aiAnimMesh* anim = pMesh->mAnimMeshes[i];
+		if (!anim)	{
+			ReportError("aiMesh::mAnimMeshes[%i] is NULL (aiMesh::mNumAnimMeshes is %i)",
+				i,pMesh->mNumAnimMeshes);
+		}
+		if (anim->mNumVertices != pMesh->mNumVertices)	{
+			ReportError("aiMesh::mAnimMeshes[%i]::mNumVertices is %i, but the host mesh has %i vertices",
+				i,anim->mNumVertices,pMesh->mNumVertices);
+		}
+		if (anim->HasNormals() && !pMesh->HasNormals())	{
+			ReportError("aiMesh::mAnimMeshes[%i] has normals, but the host mesh has none",i);
+		}
+	}
+
+	if (mLevel < AI_VDS_LEVEL_FULL || !pMesh->mFaces) {
+		return;
+	}
+
+	// now check the faces and whether the face indexing layout is correct:
+	// unique vertices, pseudo-indexed. This is done in a single pass.
+	std::vector<bool> abRefList;
+	abRefList.resize(pMesh->mNumVertices,false);
+	for (unsigned int i = 0; i < pMesh->mNumFaces; ++i)
+	{
+		aiFace& face = pMesh->mFaces[i];
+
+		if (pMesh->mPrimitiveTypes)
+		{
+			switch (face.mNumIndices)
+			{
+			case 0:
+				ReportError("aiMesh::mFaces[%i].mNumIndices is 0",i);
+			case 1:
+				if (0 == (pMesh->mPrimitiveTypes & aiPrimitiveType_POINT))
+				{
+					ReportError("aiMesh::mFaces[%i] is a POINT but aiMesh::mPrimtiveTypes "
+						"does not report the POINT flag",i);
+				}
+				break;
+			case 2:
+				if (0 == (pMesh->mPrimitiveTypes & aiPrimitiveType_LINE))
+				{
+					ReportError("aiMesh::mFaces[%i] is a LINE but aiMesh::mPrimtiveTypes "
+						"does not report the LINE flag",i);
+				}
+				break;
+			case 3:
+				if (0 == (pMesh->mPrimitiveTypes & aiPrimitiveType_TRIANGLE))
+				{
+					ReportError("aiMesh::mFaces[%i] is a TRIANGLE but aiMesh::mPrimtiveTypes "
+						"does not report the TRIANGLE flag",i);
+				}
+				break;
+			default:
+				if (0 == (pMesh->mPrimitiveTypes & aiPrimitiveType_POLYGON))
+				{
+					this->ReportError("aiMesh::mFaces[%i] is a POLYGON but aiMesh::mPrimtiveTypes "
+						"does not report the POLYGON flag",i);
+				}
+				break;
+			};
+		}
+
+		if (!face.mIndices)
+			ReportError("aiMesh::mFaces[%i].mIndices is NULL",i);
+
+		if (face.mNumIndices > AI_MAX_FACE_INDICES) {
+			ReportError("Face %u has too many faces: %u, but the limit is %u",i,face.mNumIndices,AI_MAX_FACE_INDICES);
+		}
+
+		for (unsigned int a = 0; a < face.mNumIndices;++a)
+		{
+			if (face.mIndices[a] >= pMesh->mNumVertices)	{
+				ReportError("aiMesh::mFaces[%i]::mIndices[%i] is out of range",i,a);
+			}
+			// the MSB flag is temporarily used by the extra verbose
+			// mode to tell us that the JoinVerticesProcess might have 
+			// been executed already.
+			if ( !(this->mScene->mFlags & AI_SCENE_FLAGS_NON_VERBOSE_FORMAT ) && abRefList[face.mIndices[a]])
+			{
+				ReportError("aiMesh::mVertices[%i] is referenced twice - second "
+					"time by aiMesh::mFaces[%i]::mIndices[%i]",face.mIndices[a],i,a);
+			}
+			abRefList[face.mIndices[a]] = true;
+		}
+	}
+
+	// check whether there are vertices that aren't referenced by a face
+	bool b = false;
+	for (unsigned int i = 0; i < pMesh->mNumVertices;++i)	{
+		if (!abRefList[i])b = true;
 	}
+	abRefList.clear();
+	if (b)ReportWarning("There are unreferenced vertices");
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -517,6 +645,10 @@ void ValidateDSProcess::Validate( const aiMesh* pMesh,
 		ReportError("aiBone::mNumWeights is zero");
 	}
 
+	if (mLevel < AI_VDS_LEVEL_FULL) {
+		return;
+	}
+
 	// check whether all vertices affected by this bone are valid
 	for (unsigned int i = 0; i < pBone->mNumWeights;++i)
 	{
@@ -542,7 +674,7 @@ void ValidateDSProcess::Validate( const aiAnimation* pAnimation)
 			ReportError("aiAnimation::mChannels is NULL (aiAnimation::mNumChannels is %i)",
 				pAnimation->mNumChannels);
 		}
-		for (unsigned int i = 0; i < pAnimation->mNumChannels;++i)
+		for (unsigned int i = 0; mLevel >= AI_VDS_LEVEL_STRUCTURE && i < pAnimation->mNumChannels;++i)
 		{
 			if (!pAnimation->mChannels[i])
 			{
@@ -552,7 +684,27 @@ void ValidateDSProcess::Validate( const aiAnimation* pAnimation)
 			Validate(pAnimation, pAnimation->mChannels[i]);
 		}
 	}
-	else ReportError("aiAnimation::mNumChannels is 0. At least one node animation channel must be there.");
+	else if (!pAnimation->mNumMeshChannels) {
+		ReportError("aiAnimation::mNumChannels is 0. At least one node or mesh animation channel must be there.");
+	}
+
+	// validate all vertex animation channels
+	if (pAnimation->mNumMeshChannels)
+	{
+		if (!pAnimation->mMeshChannels)	{
+			ReportError("aiAnimation::mMeshChannels is NULL (aiAnimation::mNumMeshChannels is %i)",
+				pAnimation->mNumMeshChannels);
+		}
+		for (unsigned int i = 0; mLevel >= AI_VDS_LEVEL_STRUCTURE && i < pAnimation->mNumMeshChannels;++i)
+		{
+			if (!pAnimation->mMeshChannels[i])
+			{
+				ReportError("aiAnimation::mMeshChannels[%i] is NULL (aiAnimation::mNumMeshChannels is %i)",
+					i, pAnimation->mNumMeshChannels);
+			}
+			Validate(pAnimation, pAnimation->mMeshChannels[i]);
+		}
+	}
 
 	// Animation duration is allowed to be zero in cases where the anim contains only a single key frame.
 	// if (!pAnimation->mDuration)this->ReportError("aiAnimation::mDuration is zero");
@@ -673,6 +825,10 @@ void ValidateDSProcess::SearchForInvalidTextures(const aiMaterial* pMaterial,
 // ------------------------------------------------------------------------------------------------
 void ValidateDSProcess::Validate( const aiMaterial* pMaterial)
 {
+	if (mLevel < AI_VDS_LEVEL_STRUCTURE) {
+		return;
+	}
+
 	// check whether there are material keys that are obviously not legal
 	for (unsigned int i = 0; i < pMaterial->mNumProperties;++i)
 	{
@@ -813,7 +969,7 @@ void ValidateDSProcess::Validate( const aiAnimation* pAnimation,
 				pNodeAnim->mNumPositionKeys);
 		}
 		double dLast = -10e10;
-		for (unsigned int i = 0; i < pNodeAnim->mNumPositionKeys;++i)
+		for (unsigned int i = 0; mLevel >= AI_VDS_LEVEL_FULL && i < pNodeAnim->mNumPositionKeys;++i)
 		{
 			// ScenePreprocessor will compute the duration if still the default value
 			// (Aramis) Add small epsilon, comparison tended to fail if max_time == duration,
@@ -844,7 +1000,7 @@ void ValidateDSProcess::Validate( const aiAnimation* pAnimation,
 				pNodeAnim->mNumRotationKeys);
 		}
 		double dLast = -10e10;
-		for (unsigned int i = 0; i < pNodeAnim->mNumRotationKeys;++i)
+		for (unsigned int i = 0; mLevel >= AI_VDS_LEVEL_FULL && i < pNodeAnim->mNumRotationKeys;++i)
 		{
 			if (pAnimation->mDuration > 0. && pNodeAnim->mRotationKeys[i].mTime > pAnimation->mDuration+0.001)
 			{
@@ -871,7 +1027,7 @@ void ValidateDSProcess::Validate( const aiAnimation* pAnimation,
 				pNodeAnim->mNumScalingKeys);
 		}
 		double dLast = -10e10;
-		for (unsigned int i = 0; i < pNodeAnim->mNumScalingKeys;++i)
+		for (unsigned int i = 0; mLevel >= AI_VDS_LEVEL_FULL && i < pNodeAnim->mNumScalingKeys;++i)
 		{
 			if (pAnimation->mDuration > 0. && pNodeAnim->mScalingKeys[i].mTime > pAnimation->mDuration+0.001)
 			{
@@ -898,6 +1054,64 @@ void ValidateDSProcess::Validate( const aiAnimation* pAnimation,
 	}
 }
 
+// ------------------------------------------------------------------------------------------------
+void ValidateDSProcess::Validate( const aiAnimation* pAnimation,
+	 const aiMeshAnim* pMeshAnim)
+{
+	Validate(&pMeshAnim->mName);
+
+	if (!pMeshAnim->mNumKeys)	{
+		ReportError("Empty mesh animation channel");
+	}
+	if (!pMeshAnim->mKeys)	{
+		ReportError("aiMeshAnim::mKeys is NULL (aiMeshAnim::mNumKeys is %i)",
+			pMeshAnim->mNumKeys);
+	}
+
+	// find the mesh this channel refers to
+	const aiMesh* pMesh = NULL;
+	for (unsigned int i = 0; i < mScene->mNumMeshes;++i)	{
+		if (mScene->mMeshes[i]->mName == pMeshAnim->mName)	{
+			pMesh = mScene->mMeshes[i];
+			break;
+		}
+	}
+	if (!pMesh)	{
+		ReportWarning("aiMeshAnim::mName (%s) does not refer to an existing mesh",pMeshAnim->mName.data);
+	}
+
+	if (mLevel < AI_VDS_LEVEL_FULL) {
+		return;
+	}
+
+	double dLast = -10e10;
+	for (unsigned int i = 0; i < pMeshAnim->mNumKeys;++i)
+	{
+		const aiMeshKey& key = pMeshAnim->mKeys[i];
+		if (pAnimation->mDuration > 0. && key.mTime > pAnimation->mDuration+0.001)
+		{
+			ReportError("aiMeshAnim::mKeys[%i].mTime (%.5f) is larger "
+				"than aiAnimation::mDuration (which is %.5f)",i,
+				(float)key.mTime,
+				(float)pAnimation->mDuration);
+		}
+		if (i && key.mTime <= dLast)
+		{
+			ReportWarning("aiMeshAnim::mKeys[%i].mTime (%.5f) is smaller "
+				"than aiMeshAnim::mKeys[%i] (which is %.5f)",i,
+				(float)key.mTime,
+				i-1, (float)dLast);
+		}
+		dLast = key.mTime;
+
+		if (pMesh && key.mValue >= pMesh->mNumAnimMeshes)
+		{
+			ReportError("aiMeshAnim::mKeys[%i].mValue (%i) is out of range (aiMesh::mNumAnimMeshes is %i)",
+				i,key.mValue,pMesh->mNumAnimMeshes);
+		}
+	}
+}
+
 // ------------------------------------------------------------------------------------------------
 void ValidateDSProcess::Validate( const aiNode* pNode)
 {
@@ -62,7 +62,7 @@ namespace Assimp	{
 /** Validates the whole ASSIMP scene data structure for correctness.
  *  ImportErrorException is thrown of the scene is corrupt.*/
 // --------------------------------------------------------------------------------------
-class ValidateDSProcess : public BaseProcess
+class ASSIMP_API ValidateDSProcess : public BaseProcess
 {
 public:
 
@@ -76,6 +76,9 @@ public:
 	// -------------------------------------------------------------------
 	void Execute( aiScene* pScene);
 
+	// -------------------------------------------------------------------
+	void SetupProperties(const Importer* pImp);
+
 protected:
 
 	// -------------------------------------------------------------------
@@ -87,7 +90,8 @@ protected:
 
 	// -------------------------------------------------------------------
 	/** Report a validation warning. This won't throw an exception,
-	 *  control will return to the callera.
+	 *  control will return to the callera. The warning is logged
+	 *  immediately, unless mWarnings is set.
 	 * @param msg Format string for sprintf().*/
 	void ReportWarning(const char* msg,...);
 
@@ -144,6 +148,13 @@ protected:
 	void Validate( const aiAnimation* pAnimation,
 		const aiNodeAnim* pBoneAnim);
 
+	// -------------------------------------------------------------------
+	/** Validates a vertex animation channel
+	 * @param pAnimation Animation channel.
+	 * @param pMeshAnim Input mesh animation */
+	void Validate( const aiAnimation* pAnimation,
+		const aiMeshAnim* pMeshAnim);
+
 	// -------------------------------------------------------------------
 	/** Validates a node and all of its subnodes
 	 * @param Node Input node*/
@@ -156,6 +167,15 @@ protected:
 
 private:
 
+	// ParallelFor() job to validate all meshes and animations
+	class MeshAndAnimationJob;
+
+	// template to check one of the aiScene::mXXX arrays for NULL
+	// entries, without validating the entries themselves
+	template <typename T>
+	inline void DoArrayValidation(T** array, unsigned int size, 
+		const char* firstName, const char* secondName);
+
 	// template to validate one of the aiScene::mXXX arrays
 	template <typename T>
 	inline void DoValidation(T** array, unsigned int size, 
@@ -173,6 +193,12 @@ private:
 		const char* firstName, const char* secondName);
 
 	aiScene* mScene;
+
+	// one of the AI_VDS_LEVEL_XXX constants
+	unsigned int mLevel;
+
+	// if not NULL, warnings are collected here instead of being logged
+	std::vector<std::string>* mWarnings;
 };
 
 
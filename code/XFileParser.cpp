@@ -47,6 +47,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "XFileParser.h"
 #include "XFileHelper.h"
 #include "fast_atof.h"
+#include "ParallelFor.h"
 
 using namespace Assimp;
 using namespace Assimp::XFile;
@@ -73,6 +74,55 @@ static void  dummy_free  (void* /*opaque*/, void* address)	{
 	return ::operator delete(address);
 }
 
+namespace {
+
+	// ------------------------------------------------------------------------------------------------
+	// ParallelFor() job to inflate all blocks of a MSZIP compressed file into slots of MSZIP_BLOCK bytes
+	struct InflateMSZIPBlocksJob
+	{
+		struct Block
+		{
+			const char* data;
+			uint16_t comp_len;
+			unsigned int out_len;
+			bool ok;
+		};
+
+		void operator()(size_t i) {
+			Block& b = blocks[i];
+			b.ok = InflateBlock(b, out + i * MSZIP_BLOCK, NULL, 0);
+		}
+
+		// Inflate a single block, optionally using the output of the previous block as dictionary.
+		// Without the dictionary, back-references into the previous block are rejected by zlib.
+		static bool InflateBlock(Block& b, char* dest, const char* dict, unsigned int dict_len) {
+			z_stream stream;
+			stream.opaque = NULL;
+			stream.zalloc = &dummy_alloc;
+			stream.zfree  = &dummy_free;
+
+			::inflateInit2(&stream, -MAX_WBITS);
+			if (dict) {
+				::inflateSetDictionary( &stream, (const Bytef*)dict, dict_len );
+			}
+
+			stream.next_in   = (Bytef*)b.data;
+			stream.avail_in  = b.comp_len;
+			stream.next_out  = (Bytef*)dest;
+			stream.avail_out = MSZIP_BLOCK;
+
+			const int ret = ::inflate( &stream, Z_SYNC_FLUSH );
+			b.out_len = MSZIP_BLOCK - stream.avail_out;
+
+			::inflateEnd(&stream);
+			return ret == Z_OK || ret == Z_STREAM_END;
+		}
+
+		std::vector<Block> blocks;
+		char* out;
+	};
+}
+
 #endif // !! ASSIMP_BUILD_NO_COMPRESSED_X
 
 // ------------------------------------------------------------------------------------------------
@@ -167,75 +217,108 @@ XFileParser::XFileParser( const std::vector<char>& pBuffer)
 		 * ///////////////////////////////////////////////////////////////////////
 		 */
 
-		// build a zlib stream
-		z_stream stream;
-		stream.opaque = NULL;
-		stream.zalloc = &dummy_alloc;
-		stream.zfree  = &dummy_free;
-		stream.data_type = (mIsBinaryFormat ? Z_BINARY : Z_ASCII);
-
-		// initialize the inflation algorithm
-		::inflateInit2(&stream, -MAX_WBITS);
-
 		// skip unknown data (checksum, flags?)
 		P += 6;
 
-		// First find out how much storage we'll need. Count sections.
-		const char* P1       = P;
-		unsigned int est_out = 0;
-
-		while (P1 + 3 < End)
+		// First collect all sections so we know how much storage we'll need.
+		InflateMSZIPBlocksJob job;
+		while (P + 3 < End)
 		{
 			// read next offset
-			uint16_t ofs = *((uint16_t*)P1);
-			AI_SWAP2(ofs); P1 += 2;
+			uint16_t ofs = *((uint16_t*)P);
+			AI_SWAP2(ofs); P += 2;
 
 			if (ofs >= MSZIP_BLOCK)
 				throw DeadlyImportError("X: Invalid offset to next MSZIP compressed block");
 
 			// check magic word
-			uint16_t magic = *((uint16_t*)P1);
-			AI_SWAP2(magic); P1 += 2;
+			uint16_t magic = *((uint16_t*)P);
+			AI_SWAP2(magic); P += 2;
 
 			if (magic != MSZIP_MAGIC)
 				throw DeadlyImportError("X: Unsupported compressed format, expected MSZIP header");
 
+			InflateMSZIPBlocksJob::Block b;
+			b.data = P;
+			b.comp_len = ofs;
+			b.out_len = 0;
+			b.ok = false;
+			job.blocks.push_back(b);
+
 			// and advance to the next offset
-			P1 += ofs;
-			est_out += MSZIP_BLOCK; // one decompressed block is 32786 in size
+			P += ofs;
 		}
-		
-		// Allocate storage and terminating zero and do the actual uncompressing
-		uncompressed.resize(est_out + 1);
+
+		// Allocate storage (one decompressed block is at most 32786 in size) and terminating zero.
+		uncompressed.resize(job.blocks.size() * MSZIP_BLOCK + 1);
 		char* out = &uncompressed.front();
-		while (P + 3 < End)
-		{
-			uint16_t ofs = *((uint16_t*)P);
-			AI_SWAP2(ofs); 
-			P += 4;
 
-			// push data to the stream
-			stream.next_in   = (Bytef*)P;
-			stream.avail_in  = ofs;
-			stream.next_out  = (Bytef*)out;
-			stream.avail_out = MSZIP_BLOCK;
+		if (ParallelForThreadCount(job.blocks.size()) > 1)
+		{
+			// Each block may back-reference the output of its predecessor, which is passed to zlib
+			// as dictionary. Most blocks don't, though, so inflate them all concurrently without
+			// their dictionaries first and retry only the ones zlib rejected afterwards.
+			job.out = &uncompressed.front();
+			ParallelFor(job.blocks.size(), job);
+
+			// Now retry failed blocks in order and move all blocks to their final location.
+			// Blocks are packed tightly, so the dictionary for a retry is already in place.
+			for (size_t i = 0; i < job.blocks.size(); ++i)
+			{
+				InflateMSZIPBlocksJob::Block& b = job.blocks[i];
+				char* const slot = job.out + i * MSZIP_BLOCK;
 
-			// and decompress the data ....
-			int ret = ::inflate( &stream, Z_SYNC_FLUSH );
-			if (ret != Z_OK && ret != Z_STREAM_END)
-				throw DeadlyImportError("X: Failed to decompress MSZIP-compressed data");
+				if (!b.ok) {
+					const unsigned int dict_len = i ? job.blocks[i-1].out_len : 0;
+					if (!i || !InflateMSZIPBlocksJob::InflateBlock(b, slot, out - dict_len, dict_len))
+						throw DeadlyImportError("X: Failed to decompress MSZIP-compressed data");
+				}
 
-			::inflateReset( &stream );
-			::inflateSetDictionary( &stream, (const Bytef*)out , MSZIP_BLOCK - stream.avail_out );
+				::memmove(out, slot, b.out_len);
+				out += b.out_len;
+			}
+		}
+		else
+		{
+			// Without threads the speculative pass would just inflate some blocks twice,
+			// so decompress them in order, each one with its predecessor as dictionary.
+			z_stream stream;
+			stream.opaque = NULL;
+			stream.zalloc = &dummy_alloc;
+			stream.zfree  = &dummy_free;
+			stream.data_type = (mIsBinaryFormat ? Z_BINARY : Z_ASCII);
+
+			// initialize the inflation algorithm
+			::inflateInit2(&stream, -MAX_WBITS);
+
+			for (size_t i = 0; i < job.blocks.size(); ++i)
+			{
+				const InflateMSZIPBlocksJob::Block& b = job.blocks[i];
+
+				// push data to the stream
+				stream.next_in   = (Bytef*)b.data;
+				stream.avail_in  = b.comp_len;
+				stream.next_out  = (Bytef*)out;
+				stream.avail_out = MSZIP_BLOCK;
+
+				// and decompress the data ....
+				int ret = ::inflate( &stream, Z_SYNC_FLUSH );
+				if (ret != Z_OK && ret != Z_STREAM_END) {
+					::inflateEnd(&stream);
+					throw DeadlyImportError("X: Failed to decompress MSZIP-compressed data");
+				}
+
+				::inflateReset( &stream );
+				::inflateSetDictionary( &stream, (const Bytef*)out , MSZIP_BLOCK - stream.avail_out );
+
+				// and advance to the next block
+				out +=  MSZIP_BLOCK - stream.avail_out;
+			}
 
-			// and advance to the next offset
-			out +=  MSZIP_BLOCK - stream.avail_out;
-			P   += ofs;
+			// terminate zlib
+			::inflateEnd(&stream);
 		}
 
-		// terminate zlib
-		::inflateEnd(&stream);
-		
 		// ok, update pointers to point to the uncompressed file data
 		P = &uncompressed[0];
 		End = out;
@@ -447,8 +530,13 @@ void XFileParser::ParseDataObjectMesh( Mesh* pMesh)
 	pMesh->mPositions.resize( numVertices);
 
 	// read vertices
-	for( unsigned int a = 0; a < numVertices; a++)
-		pMesh->mPositions[a] = ReadVector3();
+	if( mIsBinaryFormat && numVertices)
+		ReadBinFloatArray( &pMesh->mPositions[0], numVertices * 3);
+	else
+	{
+		for( unsigned int a = 0; a < numVertices; a++)
+			pMesh->mPositions[a] = ReadVector3();
+	}
 
 	// read position faces
 	unsigned int numPosFaces = ReadInt();
@@ -461,6 +549,13 @@ void XFileParser::ParseDataObjectMesh( Mesh* pMesh)
 
 		// read indices
 		Face& face = pMesh->mPosFaces[a];
+		if( mIsBinaryFormat)
+		{
+			face.mIndices.resize( numIndices);
+			ReadBinIntArray( &face.mIndices[0], numIndices);
+			continue;
+		}
+
 		for( unsigned int b = 0; b < numIndices; b++)
 			face.mIndices.push_back( ReadInt());
 		TestForSeparator();
@@ -520,18 +615,37 @@ void XFileParser::ParseDataObjectSkinWeights( Mesh *pMesh)
 
 	// read vertex weights
 	unsigned int numWeights = ReadInt();
-	bone.mWeights.reserve( numWeights);
 
-	for( unsigned int a = 0; a < numWeights; a++)
+	if( mIsBinaryFormat && numWeights)
 	{
-		BoneWeight weight;
-		weight.mVertex = ReadInt();
-		bone.mWeights.push_back( weight);
+		// decode both lists in one go and interleave them afterwards
+		std::vector<unsigned int> vertices( numWeights);
+		std::vector<float> weights( numWeights);
+		ReadBinIntArray( &vertices[0], numWeights);
+		ReadBinFloatArray( &weights[0], numWeights);
+
+		bone.mWeights.resize( numWeights);
+		for( unsigned int a = 0; a < numWeights; a++)
+		{
+			bone.mWeights[a].mVertex = vertices[a];
+			bone.mWeights[a].mWeight = weights[a];
+		}
 	}
+	else
+	{
+		bone.mWeights.reserve( numWeights);
 
-	// read vertex weights
-	for( unsigned int a = 0; a < numWeights; a++)
-		bone.mWeights[a].mWeight = ReadFloat();
+		for( unsigned int a = 0; a < numWeights; a++)
+		{
+			BoneWeight weight;
+			weight.mVertex = ReadInt();
+			bone.mWeights.push_back( weight);
+		}
+
+		// read vertex weights
+		for( unsigned int a = 0; a < numWeights; a++)
+			bone.mWeights[a].mWeight = ReadFloat();
+	}
 
 	// read matrix offset
 	bone.mOffsetMatrix.a1 = ReadFloat(); bone.mOffsetMatrix.b1 = ReadFloat();
@@ -569,8 +683,13 @@ void XFileParser::ParseDataObjectMeshNormals( Mesh* pMesh)
 	pMesh->mNormals.resize( numNormals);
 
 	// read normal vectors
-	for( unsigned int a = 0; a < numNormals; a++)
-		pMesh->mNormals[a] = ReadVector3();
+	if( mIsBinaryFormat && numNormals)
+		ReadBinFloatArray( &pMesh->mNormals[0], numNormals * 3);
+	else
+	{
+		for( unsigned int a = 0; a < numNormals; a++)
+			pMesh->mNormals[a] = ReadVector3();
+	}
 
 	// read normal indices
 	unsigned int numFaces = ReadInt();
@@ -583,6 +702,14 @@ void XFileParser::ParseDataObjectMeshNormals( Mesh* pMesh)
 		pMesh->mNormFaces.push_back( Face());
 		Face& face = pMesh->mNormFaces.back();
 
+		if( mIsBinaryFormat)
+		{
+			face.mIndices.resize( numIndices);
+			if( numIndices)
+				ReadBinIntArray( &face.mIndices[0], numIndices);
+			continue;
+		}
+
 		for( unsigned int b = 0; b < numIndices; b++)
 			face.mIndices.push_back( ReadInt());
 
@@ -606,8 +733,13 @@ void XFileParser::ParseDataObjectMeshTextureCoords( Mesh* pMesh)
 		ThrowException( "Texture coord count does not match vertex count");
 
 	coords.resize( numCoords);
-	for( unsigned int a = 0; a < numCoords; a++)
-		coords[a] = ReadVector2();
+	if( mIsBinaryFormat && numCoords)
+		ReadBinFloatArray( &coords[0], numCoords * 2);
+	else
+	{
+		for( unsigned int a = 0; a < numCoords; a++)
+			coords[a] = ReadVector2();
+	}
 
 	CheckForClosingBrace();
 }
@@ -1314,6 +1446,77 @@ unsigned int XFileParser::ReadInt()
 	}
 }
 
+// ------------------------------------------------------------------------------------------------
+void XFileParser::ReadBinIntArray( unsigned int* pOut, unsigned int pCount)
+{
+	ai_assert( mIsBinaryFormat);
+	while( pCount > 0)
+	{
+		// let ReadInt() deal with list headers and truncated files
+		if( mBinaryNumCount == 0 || End - P < 4)
+		{
+			*pOut++ = ReadInt();
+			--pCount;
+			continue;
+		}
+
+		// decode as much of the current list as possible
+		const unsigned int num = std::min( std::min( pCount, mBinaryNumCount), 
+			static_cast<unsigned int>( (End - P) / 4));
+
+		const unsigned char* q = (const unsigned char*) P;
+		for( unsigned int a = 0; a < num; a++, q += 4)
+			pOut[a] = q[0] | (q[1] << 8) | (q[2] << 16) | (q[3] << 24);
+
+		P += num * 4;
+		pOut += num;
+		pCount -= num;
+		mBinaryNumCount -= num;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+void XFileParser::ReadBinFloatArray( void* pOut, unsigned int pCount)
+{
+	ai_assert( mIsBinaryFormat);
+
+	// byte-wise output, the destination is usually an array of packed vectors
+	char* out = static_cast<char*>( pOut);
+	while( pCount > 0)
+	{
+		// let ReadFloat() deal with list headers and truncated files
+		if( mBinaryNumCount == 0 || End - P < (ptrdiff_t)mBinaryFloatSize)
+		{
+			const float f = ReadFloat();
+			::memcpy( out, &f, 4);
+			out += 4;
+			--pCount;
+			continue;
+		}
+
+		// decode as much of the current list as possible
+		const unsigned int num = std::min( std::min( pCount, mBinaryNumCount), 
+			static_cast<unsigned int>( (End - P) / mBinaryFloatSize));
+
+		if( mBinaryFloatSize == 8)
+		{
+			for( unsigned int a = 0; a < num; a++)
+			{
+				double d;
+				::memcpy( &d, P + a * 8, 8);
+				const float f = (float) d;
+				::memcpy( out + a * 4, &f, 4);
+			}
+		}
+		else ::memcpy( out, P, num * 4);
+
+		P += num * mBinaryFloatSize;
+		out += num * 4;
+		pCount -= num;
+		mBinaryNumCount -= num;
+	}
+}
+
 // ------------------------------------------------------------------------------------------------
 float XFileParser::ReadFloat()
 {
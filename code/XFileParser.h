@@ -128,6 +128,13 @@ protected:
 	unsigned int ReadBinDWord();
 	unsigned int ReadInt();
 	float ReadFloat();
+
+	/** Reads the given number of values from binary number lists, same as calling 
+	 *  ReadInt() resp. ReadFloat() repeatedly but decoding whole lists in one loop. 
+	 *  Only valid for binary files. The floats are written byte-wise, so pOut may
+	 *  point to packed vectors. */
+	void ReadBinIntArray( unsigned int* pOut, unsigned int pCount);
+	void ReadBinFloatArray( void* pOut, unsigned int pCount);
 	aiVector2D ReadVector2();
 	aiVector3D ReadVector3();
 	aiColor3D ReadRGB();
@@ -206,9 +206,8 @@ void XGLImporter::InternReadFile( const std::string& pFile,
 #endif
 	}
 
-	// construct the irrXML parser
-	CIrrXML_IOStreamReader st(stream.get());
-	boost::scoped_ptr<IrrXMLReader> read( createIrrXMLReader((IFileReadCallBack*) &st) );
+	// construct the XML parser
+	boost::scoped_ptr<IrrXMLReader> read( new FastXMLReader(stream.get()) );
 	reader = read.get();
 
 	// parse the XML file
@@ -45,7 +45,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define AI_XGLLOADER_H_INCLUDED
 
 #include "BaseImporter.h"
-#include "irrXMLWrapper.h"
+#include "FastXMLReader.h"
 #include "LogAux.h"
 
 namespace Assimp	{
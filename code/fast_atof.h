@@ -334,6 +334,58 @@ inline double fast_atod( const char** inout)
 	return ret;
 }
 
+// ------------------------------------------------------------------------------------
+// Batch versions for long runs of whitespace-separated numbers, such as the contents 
+// of XML elements. Parses at most 'max' values into 'out' and stops early at the
+// terminating zero. Returns the number of values read, *end receives the position
+// after the last character processed.
+// ------------------------------------------------------------------------------------
+template <typename Real>
+inline size_t fast_atoreal_array( const char* c, Real* out, size_t max, const char** end = 0)
+{
+	size_t i = 0;
+	for (;;++i) {
+		while (*c == ' ' || *c == '\t' || *c == '\r' || *c == '\n') {
+			++c;
+		}
+		if (i == max || !*c) {
+			break;
+		}
+		c = fast_atoreal_move<Real>(c, out[i]);
+	}
+
+	if (end) {
+		*end = c;
+	}
+	return i;
+}
+
+// ------------------------------------------------------------------------------------
+template <typename Int>
+inline size_t strtol10_array( const char* c, Int* out, size_t max, const char** end = 0)
+{
+	size_t i = 0;
+	for (;;++i) {
+		while (*c == ' ' || *c == '\t' || *c == '\r' || *c == '\n') {
+			++c;
+		}
+		if (i == max || !*c) {
+			break;
+		}
+		const char* const start = c;
+		out[i] = static_cast<Int>( strtol10(c, &c) );
+		if (c == start) {
+			// garbage, stop here rather than looping forever
+			break;
+		}
+	}
+
+	if (end) {
+		*end = c;
+	}
+	return i;
+}
+
 } // end of namespace Assimp
 
 #endif
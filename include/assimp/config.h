@@ -487,6 +487,29 @@ enum aiComponent
 #define AI_CONFIG_PP_FID_ANIM_ACCURACY				\
 	"PP_FID_ANIM_ACCURACY"
 
+// ValidateDS checks only the scene and the headers of meshes, animations etc.
+#define AI_VDS_LEVEL_HEADERS 0x0
+
+// ValidateDS additionally checks all objects which are not per-element data,
+// i.e. the node graph, bones, animation channels and materials
+#define AI_VDS_LEVEL_STRUCTURE 0x1
+
+// ValidateDS additionally checks all faces, bone weights and keys -> default value
+#define AI_VDS_LEVEL_FULL 0x2
+
+// ---------------------------------------------------------------------------
+/** @brief Input parameter to the #aiProcess_ValidateDataStructure step:
+ *  Specifies how thoroughly the scene is validated.
+ *
+ *  This is one of the AI_VDS_LEVEL_XXX constants (integer property). A full
+ *  validation touches every face index, bone weight and animation key, which
+ *  is costly for large scenes. The lower levels omit these checks and only 
+ *  verify that the scene is structurally sound. By default the scene is
+ *  fully validated (AI_VDS_LEVEL_FULL).
+ */
+#define AI_CONFIG_PP_VDS_LEVEL				\
+	"PP_VDS_LEVEL"
+
 
 // TransformUVCoords evaluates UV scalings
 #define AI_UVTRAFO_SCALING 0x1
@@ -646,6 +669,20 @@ enum aiComponent
 #define AI_CONFIG_IMPORT_SMD_KEYFRAME		"IMPORT_SMD_KEYFRAME"
 #define AI_CONFIG_IMPORT_UNREAL_KEYFRAME	"IMPORT_UNREAL_KEYFRAME"
 
+// ---------------------------------------------------------------------------
+/** @brief  Import all vertex animation keyframes at once
+ *
+ * If enabled, the MD2, MD3, MDC and Quake 1 MDL loaders decode all keyframes
+ * in a single pass. The host meshes still contain the keyframe selected by 
+ * AI_CONFIG_IMPORT_GLOBAL_KEYFRAME (or the corresponding per-format setting),
+ * all keyframes are attached to them as #aiAnimMesh instances sharing the
+ * faces and texture coordinates of the host mesh. An #aiAnimation with one 
+ * #aiMeshAnim channel per mesh refers to them, consecutive keyframes which 
+ * don't change a mesh refer to the same #aiAnimMesh.
+ * Property type: bool. Default value: false.
+ */
+#define AI_CONFIG_IMPORT_ALL_KEYFRAMES	"IMPORT_ALL_KEYFRAMES"
+
 
 // ---------------------------------------------------------------------------
 /** @brief  Configures the AC loader to collect all surfaces which have the
@@ -689,6 +726,46 @@ enum aiComponent
 #define AI_CONFIG_IMPORT_TER_MAKE_UVS \
 	"IMPORT_TER_MAKE_UVS"
 
+// ---------------------------------------------------------------------------
+/** @brief Configures the Terragen and HMP loaders to output terrains as 
+ *  indexed meshes with one vertex per height sample.
+ *
+ * By default, terrains are returned as lists of quads with four unique
+ * vertices each, so the output has roughly four times as many vertices
+ * as the height field has samples. Neighbouring quads share their vertices
+ * if this option is enabled.
+ * Property type: bool. Default value: false.
+ */
+#define AI_CONFIG_IMPORT_TERRAIN_SHARED_VERTICES \
+	"IMPORT_TERRAIN_SHARED_VERTICES"
+
+// ---------------------------------------------------------------------------
+/** @brief Configures the Terragen and HMP loaders to split terrains into
+ *  square tiles of the given number of quads per side.
+ *
+ * Each tile is an indexed mesh (see #AI_CONFIG_IMPORT_TERRAIN_SHARED_VERTICES)
+ * attached to a node of its own. The tile's bounding box is stored in the 
+ * node's metadata as "BoundsMin" and "BoundsMax". 0 disables tiling.
+ * Property type: integer. Default value: 0.
+ */
+#define AI_CONFIG_IMPORT_TERRAIN_TILE_SIZE \
+	"IMPORT_TERRAIN_TILE_SIZE"
+
+// ---------------------------------------------------------------------------
+/** @brief Specifies the number of detail levels to generate for each
+ *  terrain tile (see #AI_CONFIG_IMPORT_TERRAIN_TILE_SIZE).
+ *
+ * Level n uses every 2^n-th height sample, level 0 is the full-resolution
+ * tile. If more than one level is generated, each level is attached to a
+ * child node of the tile node, named "<tile>_lod<n>", and the tile node 
+ * itself holds no meshes. Render only one of the children per tile. All 
+ * levels then receive a skirt to hide the cracks between neighbouring tiles
+ * of different detail.
+ * Property type: integer. Default value: 1.
+ */
+#define AI_CONFIG_IMPORT_TERRAIN_LOD_LEVELS \
+	"IMPORT_TERRAIN_LOD_LEVELS"
+
 // ---------------------------------------------------------------------------
 /** @brief  Configures the ASE loader to always reconstruct normal vectors
  *	basing on the smoothing groups loaded from the file.
@@ -801,6 +878,46 @@ enum aiComponent
 #define AI_CONFIG_IMPORT_IRR_ANIM_FPS				\
 	"IMPORT_IRR_ANIM_FPS"
 
+// ---------------------------------------------------------------------------
+/** @brief Sets the size of the cache for external files referenced by
+ *    IRR and LWS scenes, in megabytes.
+ *
+ * Scenes often share the same props. If this property is set, the IRR and
+ * LWS loaders keep the models they load in a process-wide cache, so
+ * importing further scenes which reference the same files (with identical
+ * contents, post-processing steps and properties) receives copies of the
+ * cached models. These copies share their vertex, face, bone weight and 
+ * animation key arrays with the cache, so the scene returned by ReadFile()
+ * must be treated as read-only. Importer::GetOrphanedScene() gives each
+ * mesh and animation its own arrays again before handing the scene out.
+ * The least recently used models are dropped once the cache exceeds its
+ * size. As the cache is shared by all Importer instances, the most recent
+ * non-zero value is used as its size.<br>
+ * Note that cached scenes are identified by the contents of the referenced
+ * file only. Files this file references in turn (e.g. an .mtl next to an
+ * .obj, or the props of a nested IRR scene) are not looked at, so editing
+ * them between two imports yields the stale, cached scene. Disable the 
+ * cache if such files may change. Builds using the boost workaround have
+ * no cache, this setting is ignored there.<br>
+ * Property type: integer. Default value: 0 (no caching)
+ */
+#define AI_CONFIG_IMPORT_SCENE_CACHE_SIZE			\
+	"IMPORT_SCENE_CACHE_SIZE"
+
+// ---------------------------------------------------------------------------
+/** @brief Specifies whether the DXF loader keeps BLOCKs as shared meshes.
+ *
+ * By default, the geometry of a BLOCK is copied into the scene once for
+ * each INSERT that references it. If this property is set, each BLOCK is
+ * converted to meshes only once and every INSERT becomes a node with the
+ * insertion transformation that references these meshes. Nested INSERTs
+ * become child nodes. This keeps memory usage low for drawings which reuse
+ * the same symbols many times.<br>
+ * Property type: bool. Default value: false.
+ */
+#define AI_CONFIG_IMPORT_DXF_INSTANCE_BLOCKS		\
+	"IMPORT_DXF_INSTANCE_BLOCKS"
+
 // ---------------------------------------------------------------------------
 /** @brief Ogre Importer will try to find referenced materials from this file.
  *
@@ -870,4 +987,31 @@ enum aiComponent
 
 #define AI_CONFIG_IMPORT_COLLADA_IGNORE_UP_DIRECTION "IMPORT_COLLADA_IGNORE_UP_DIRECTION"
 
+// ---------------------------------------------------------------------------
+/** @brief Specifies whether the Collada loader only parses those geometries,
+ *   controllers and animations which are actually used by the instantiated
+ *   visual scene.
+ *
+ * If enabled, the loader first records the position of every library entry
+ * and parses it only if it is reachable from the <instance_visual_scene>.
+ * This saves a lot of time and memory for files carrying large libraries
+ * which are only partially referenced. The imported scene is the same
+ * in both cases, but errors in unused library entries go unnoticed.
+ * Property type: Bool. Default value: true.
+ */
+#define AI_CONFIG_IMPORT_COLLADA_ON_DEMAND_LIBRARIES "IMPORT_COLLADA_ON_DEMAND_LIBRARIES"
+
+// ---------------------------------------------------------------------------
+/** @brief Specifies whether the Collada loader outputs indexed meshes.
+ *
+ * The loader identifies face corners which use the same set of indices into
+ * the vertex data sources anyways. If this property is set to true, such 
+ * corners share a single vertex and the scene is flagged with
+ * #AI_SCENE_FLAGS_NON_VERBOSE_FORMAT, so #aiProcess_JoinIdenticalVertices 
+ * can usually be omitted. Note that some post processing steps such as
+ * #aiProcess_GenNormals require verbose input and fail on such scenes.
+ * Property type: Bool. Default value: false.
+ */
+#define AI_CONFIG_IMPORT_COLLADA_SHARED_VERTICES "IMPORT_COLLADA_SHARED_VERTICES"
+
 #endif // !! AI_CONFIG_H_INC
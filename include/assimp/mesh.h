@@ -331,8 +331,9 @@ enum aiPrimitiveType
 
 
 // ---------------------------------------------------------------------------
-/** @brief NOT CURRENTLY IN USE. An AnimMesh is an attachment to an #aiMesh stores per-vertex 
- *  animations for a particular frame.
+/** @brief An AnimMesh is an attachment to an #aiMesh stores per-vertex 
+ *  animations for a particular frame. Currently only the MD2, MD3, MDC and
+ *  Quake 1 MDL loaders produce them, see #AI_CONFIG_IMPORT_ALL_KEYFRAMES.
  *  
  *  You may think of an #aiAnimMesh as a `patch` for the host mesh, which
  *  replaces only certain vertex data streams at a particular time. 
@@ -598,10 +599,10 @@ struct aiMesh
 	C_STRUCT aiString mName;
 
 
-	/** NOT CURRENTLY IN USE. The number of attachment meshes */
+	/** The number of attachment meshes */
 	unsigned int mNumAnimMeshes;
 
-	/** NOT CURRENTLY IN USE. Attachment meshes for this mesh, for vertex-based animation. 
+	/** Attachment meshes for this mesh, for vertex-based animation. 
 	 *  Attachment meshes carry replacement data for some of the
 	 *  mesh'es vertex components (usually positions, normals). */
 	C_STRUCT aiAnimMesh** mAnimMeshes;
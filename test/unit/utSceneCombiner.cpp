@@ -0,0 +1,227 @@
+#include "UnitTestPCH.h"
+#include "utSceneCombiner.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (SceneCombinerTest);
+
+// ------------------------------------------------------------------------------------------------
+void SceneCombinerTest::setUp (void)
+{
+	// setup a dummy scene with a single skinned triangle and a single animation channel
+	scene = new aiScene();
+	scene->mRootNode = new aiNode();
+	scene->mRootNode->mName.Set("<test>");
+
+	scene->mMaterials = new aiMaterial*[scene->mNumMaterials = 1];
+	scene->mMaterials[0] = new aiMaterial();
+
+	aiMesh* mesh = new aiMesh();
+	scene->mMeshes = new aiMesh*[scene->mNumMeshes = 1];
+	scene->mMeshes[0] = mesh;
+
+	mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+	mesh->mVertices = new aiVector3D[mesh->mNumVertices = 3];
+	mesh->mNormals = new aiVector3D[3];
+	for (unsigned int i = 0; i < 3; ++i) {
+		mesh->mVertices[i] = aiVector3D((float)i,1.f,2.f);
+		mesh->mNormals[i] = aiVector3D(0.f,0.f,1.f);
+	}
+
+	mesh->mFaces = new aiFace[mesh->mNumFaces = 1];
+	mesh->mFaces[0].mIndices = new unsigned int[mesh->mFaces[0].mNumIndices = 3];
+	for (unsigned int i = 0; i < 3; ++i) {
+		mesh->mFaces[0].mIndices[i] = i;
+	}
+
+	mesh->mBones = new aiBone*[mesh->mNumBones = 1];
+	aiBone* bone = mesh->mBones[0] = new aiBone();
+	bone->mName.Set("<test>");
+	bone->mWeights = new aiVertexWeight[bone->mNumWeights = 2];
+	bone->mWeights[0] = aiVertexWeight(0,0.25f);
+	bone->mWeights[1] = aiVertexWeight(2,0.75f);
+
+	aiAnimation* anim = new aiAnimation();
+	scene->mAnimations = new aiAnimation*[scene->mNumAnimations = 1];
+	scene->mAnimations[0] = anim;
+
+	anim->mDuration = 1.0;
+	anim->mChannels = new aiNodeAnim*[anim->mNumChannels = 1];
+	aiNodeAnim* channel = anim->mChannels[0] = new aiNodeAnim();
+	channel->mNodeName.Set("<test>");
+
+	channel->mPositionKeys = new aiVectorKey[channel->mNumPositionKeys = 2];
+	channel->mPositionKeys[0] = aiVectorKey(0.0,aiVector3D(0.f,0.f,0.f));
+	channel->mPositionKeys[1] = aiVectorKey(1.0,aiVector3D(1.f,2.f,3.f));
+
+	channel->mRotationKeys = new aiQuatKey[channel->mNumRotationKeys = 1];
+	channel->mRotationKeys[0] = aiQuatKey(0.0,aiQuaternion());
+
+	channel->mScalingKeys = new aiVectorKey[channel->mNumScalingKeys = 1];
+	channel->mScalingKeys[0] = aiVectorKey(0.0,aiVector3D(2.f,2.f,2.f));
+}
+
+// ------------------------------------------------------------------------------------------------
+void SceneCombinerTest::tearDown (void)
+{
+	delete scene;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Check whether all meshes and animation channels of a scene still hold the data setup() made
+void SceneCombinerTest::CheckContents(const aiScene* sc)
+{
+	for (unsigned int m = 0; m < sc->mNumMeshes; ++m) {
+		const aiMesh* mesh = sc->mMeshes[m];
+		CPPUNIT_ASSERT(3 == mesh->mNumVertices && mesh->mVertices && mesh->mNormals);
+		for (unsigned int i = 0; i < 3; ++i) {
+			CPPUNIT_ASSERT(mesh->mVertices[i] == aiVector3D((float)i,1.f,2.f));
+			CPPUNIT_ASSERT(mesh->mNormals[i] == aiVector3D(0.f,0.f,1.f));
+		}
+
+		CPPUNIT_ASSERT(1 == mesh->mNumFaces && mesh->mFaces);
+		CPPUNIT_ASSERT(3 == mesh->mFaces[0].mNumIndices);
+		for (unsigned int i = 0; i < 3; ++i) {
+			CPPUNIT_ASSERT(i == mesh->mFaces[0].mIndices[i]);
+		}
+
+		CPPUNIT_ASSERT(1 == mesh->mNumBones && mesh->mBones);
+		const aiBone* bone = mesh->mBones[0];
+		CPPUNIT_ASSERT(2 == bone->mNumWeights && bone->mWeights);
+		CPPUNIT_ASSERT(0 == bone->mWeights[0].mVertexId && 0.25f == bone->mWeights[0].mWeight);
+		CPPUNIT_ASSERT(2 == bone->mWeights[1].mVertexId && 0.75f == bone->mWeights[1].mWeight);
+	}
+
+	for (unsigned int a = 0; a < sc->mNumAnimations; ++a) {
+		const aiAnimation* anim = sc->mAnimations[a];
+		CPPUNIT_ASSERT(1 == anim->mNumChannels);
+
+		const aiNodeAnim* channel = anim->mChannels[0];
+		CPPUNIT_ASSERT(2 == channel->mNumPositionKeys && channel->mPositionKeys);
+		CPPUNIT_ASSERT(channel->mPositionKeys[1].mValue == aiVector3D(1.f,2.f,3.f));
+		CPPUNIT_ASSERT(1 == channel->mNumRotationKeys && channel->mRotationKeys);
+		CPPUNIT_ASSERT(channel->mRotationKeys[0].mValue == aiQuaternion());
+		CPPUNIT_ASSERT(1 == channel->mNumScalingKeys && channel->mScalingKeys);
+		CPPUNIT_ASSERT(channel->mScalingKeys[0].mValue == aiVector3D(2.f,2.f,2.f));
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+// Check whether the first mesh and channel of both scenes reference the same arrays
+void SceneCombinerTest::CheckShared(const aiScene* a, const aiScene* b, bool shared)
+{
+	const aiMesh* ma = a->mMeshes[0], *mb = b->mMeshes[0];
+	CPPUNIT_ASSERT(ma != mb);
+	CPPUNIT_ASSERT(shared == (ma->mVertices == mb->mVertices));
+	CPPUNIT_ASSERT(shared == (ma->mNormals == mb->mNormals));
+	CPPUNIT_ASSERT(shared == (ma->mFaces == mb->mFaces));
+
+	// the bones themselves are never shared, their weights are
+	CPPUNIT_ASSERT(ma->mBones != mb->mBones && ma->mBones[0] != mb->mBones[0]);
+	CPPUNIT_ASSERT(shared == (ma->mBones[0]->mWeights == mb->mBones[0]->mWeights));
+
+	const aiNodeAnim* ca = a->mAnimations[0]->mChannels[0], *cb = b->mAnimations[0]->mChannels[0];
+	CPPUNIT_ASSERT(ca != cb);
+	CPPUNIT_ASSERT(shared == (ca->mPositionKeys == cb->mPositionKeys));
+	CPPUNIT_ASSERT(shared == (ca->mRotationKeys == cb->mRotationKeys));
+	CPPUNIT_ASSERT(shared == (ca->mScalingKeys == cb->mScalingKeys));
+}
+
+// ------------------------------------------------------------------------------------------------
+// The copy shares the data of its source and keeps it alive after the source is gone
+void SceneCombinerTest::testCopySceneShared (void)
+{
+	aiScene* copy;
+	SceneCombiner::CopySceneShared(&copy,scene);
+
+	CheckShared(scene,copy,true);
+	CheckContents(copy);
+
+	delete scene;
+	scene = NULL;
+
+	CheckContents(copy);
+	delete copy;
+}
+
+// ------------------------------------------------------------------------------------------------
+// After UnshareScene() a scene may be modified without affecting the others
+void SceneCombinerTest::testUnshareScene (void)
+{
+	aiScene* copy;
+	SceneCombiner::CopySceneShared(&copy,scene);
+	SceneCombiner::UnshareScene(copy);
+
+	CheckShared(scene,copy,false);
+	CheckContents(copy);
+
+	copy->mMeshes[0]->mVertices[0].x = 10.f;
+	copy->mMeshes[0]->mBones[0]->mWeights[0].mWeight = 1.f;
+	copy->mAnimations[0]->mChannels[0]->mPositionKeys[1].mValue.x = 10.f;
+	CheckContents(scene);
+
+	// the source scene doesn't own its arrays anymore, it needs to be unshared as well
+	SceneCombiner::UnshareScene(scene);
+	scene->mMeshes[0]->mVertices[0].x = 0.f;
+	CheckContents(scene);
+
+	delete copy;
+}
+
+// ------------------------------------------------------------------------------------------------
+// ReleaseSharedData() drops the shared arrays without touching the other scenes
+void SceneCombinerTest::testReleaseSharedData (void)
+{
+	aiScene* copy;
+	SceneCombiner::CopySceneShared(&copy,scene);
+	SceneCombiner::ReleaseSharedData(copy);
+
+	const aiMesh* mesh = copy->mMeshes[0];
+	CPPUNIT_ASSERT(NULL == mesh->mVertices && NULL == mesh->mNormals && NULL == mesh->mFaces);
+	CPPUNIT_ASSERT(NULL != mesh->mBones[0] && NULL == mesh->mBones[0]->mWeights);
+
+	const aiNodeAnim* channel = copy->mAnimations[0]->mChannels[0];
+	CPPUNIT_ASSERT(NULL == channel->mPositionKeys && NULL == channel->mRotationKeys && NULL == channel->mScalingKeys);
+
+	delete copy;
+	CheckContents(scene);
+}
+
+// ------------------------------------------------------------------------------------------------
+// MergeScenes() keeps sharing the data of its inputs, duplicate inputs get deep copies
+void SceneCombinerTest::testMergeSharedScenes (void)
+{
+	aiScene* a, *b;
+	SceneCombiner::CopySceneShared(&a,scene);
+	SceneCombiner::CopySceneShared(&b,scene);
+
+	std::vector<aiScene*> src;
+	src.push_back(a);
+	src.push_back(b);
+	src.push_back(a);
+
+	aiScene* out = NULL;
+	SceneCombiner::MergeScenes(&out,src,AI_INT_MERGE_SCENE_GEN_UNIQUE_NAMES | AI_INT_MERGE_SCENE_DUPLICATES_DEEP_CPY);
+
+	CPPUNIT_ASSERT(3 == out->mNumMeshes && 3 == out->mNumAnimations);
+	CheckContents(out);
+
+	const aiMesh* mesh = scene->mMeshes[0];
+	CPPUNIT_ASSERT(out->mMeshes[0]->mVertices == mesh->mVertices);
+	CPPUNIT_ASSERT(out->mMeshes[1]->mVertices == mesh->mVertices);
+	CPPUNIT_ASSERT(out->mMeshes[2]->mVertices != mesh->mVertices);
+	CPPUNIT_ASSERT(out->mMeshes[0]->mBones[0]->mWeights == mesh->mBones[0]->mWeights);
+
+	// animations are collected in reverse order of the input scenes
+	const aiNodeAnim* channel = scene->mAnimations[0]->mChannels[0];
+	CPPUNIT_ASSERT(out->mAnimations[0]->mChannels[0]->mPositionKeys != channel->mPositionKeys);
+	CPPUNIT_ASSERT(out->mAnimations[1]->mChannels[0]->mPositionKeys == channel->mPositionKeys);
+	CPPUNIT_ASSERT(out->mAnimations[2]->mChannels[0]->mPositionKeys == channel->mPositionKeys);
+
+	// the merged scene keeps the shared data alive
+	delete scene;
+	scene = NULL;
+	CheckContents(out);
+
+	SceneCombiner::UnshareScene(out);
+	CheckContents(out);
+	delete out;
+}
@@ -0,0 +1,41 @@
+#ifndef TESTSCENECOMBINER_H
+#define TESTSCENECOMBINER_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <assimp/scene.h>
+#include <SceneCombiner.h>
+
+using namespace std;
+using namespace Assimp;
+
+class SceneCombinerTest : public CPPUNIT_NS :: TestFixture
+{
+    CPPUNIT_TEST_SUITE (SceneCombinerTest);
+    CPPUNIT_TEST (testCopySceneShared);
+	CPPUNIT_TEST (testUnshareScene);
+	CPPUNIT_TEST (testReleaseSharedData);
+	CPPUNIT_TEST (testMergeSharedScenes);
+    CPPUNIT_TEST_SUITE_END ();
+
+    public:
+		void setUp (void);
+		void tearDown (void);
+
+    protected:
+
+        void  testCopySceneShared		(void);
+		void  testUnshareScene			(void);
+		void  testReleaseSharedData		(void);
+		void  testMergeSharedScenes		(void);
+
+	private:
+
+		void CheckContents(const aiScene* sc);
+		void CheckShared(const aiScene* a, const aiScene* b, bool shared);
+
+		aiScene* scene;
+};
+
+#endif
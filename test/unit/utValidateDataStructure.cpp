@@ -0,0 +1,157 @@
+#include "UnitTestPCH.h"
+#include "utValidateDataStructure.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (ValidateDSProcessTest);
+
+// ------------------------------------------------------------------------------------------------
+void ValidateDSProcessTest::setUp (void)
+{
+	piProcess = new ValidateDSProcess();
+
+	// setup a scene with 8 triangles, each in a mesh of its own
+	scene = new aiScene();
+	scene->mRootNode = new aiNode();
+	scene->mRootNode->mName.Set("<test>");
+
+	scene->mMeshes = new aiMesh*[scene->mNumMeshes = 8];
+	scene->mRootNode->mMeshes = new unsigned int[scene->mRootNode->mNumMeshes = 8];
+
+	for (unsigned int m = 0; m < scene->mNumMeshes; ++m) {
+		aiMesh* mesh = scene->mMeshes[m] = new aiMesh();
+		scene->mRootNode->mMeshes[m] = m;
+
+		mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+		mesh->mVertices = new aiVector3D[mesh->mNumVertices = 3];
+		for (unsigned int i = 0; i < 3; ++i) {
+			mesh->mVertices[i] = aiVector3D((float)i,(float)m,0.f);
+		}
+
+		mesh->mFaces = new aiFace[mesh->mNumFaces = 1];
+		mesh->mFaces[0].mIndices = new unsigned int[mesh->mFaces[0].mNumIndices = 3];
+		for (unsigned int i = 0; i < 3; ++i) {
+			mesh->mFaces[0].mIndices[i] = i;
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+void ValidateDSProcessTest::tearDown (void)
+{
+	delete piProcess;
+	delete scene;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Run the step on the scene at the given validation level, return false if it fails
+bool ValidateDSProcessTest::Passes(unsigned int level, std::string* error)
+{
+	Importer imp;
+	imp.SetPropertyInteger(AI_CONFIG_PP_VDS_LEVEL,level);
+	piProcess->SetupProperties(&imp);
+
+	try {
+		piProcess->Execute(scene);
+	}
+	catch(const DeadlyImportError& e) {
+		if (error) {
+			*error = e.what();
+		}
+		return false;
+	}
+	return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void ValidateDSProcessTest::testValidScene (void)
+{
+	CPPUNIT_ASSERT(Passes(AI_VDS_LEVEL_HEADERS));
+	CPPUNIT_ASSERT(Passes(AI_VDS_LEVEL_STRUCTURE));
+	CPPUNIT_ASSERT(Passes(AI_VDS_LEVEL_FULL));
+}
+
+// The remaining tests make the step fail. ReportError() asserts in debug builds, 
+// so the failing runs are only done in release builds.
+
+// ------------------------------------------------------------------------------------------------
+// The headers level checks the scene and mesh headers, but neither bones nor nodes
+void ValidateDSProcessTest::testHeadersLevel (void)
+{
+	aiMesh* mesh = scene->mMeshes[2];
+	mesh->mBones = new aiBone*[mesh->mNumBones = 2];
+	mesh->mBones[0] = new aiBone();
+	mesh->mBones[1] = new aiBone();
+	mesh->mBones[0]->mName.Set("<bone>");
+	mesh->mBones[1]->mName.Set("<bone>");
+
+	CPPUNIT_ASSERT(Passes(AI_VDS_LEVEL_HEADERS));
+#ifndef ASSIMP_BUILD_DEBUG
+	CPPUNIT_ASSERT(!Passes(AI_VDS_LEVEL_STRUCTURE));
+
+	// a mesh without vertices is rejected at all levels
+	mesh->mBones[1]->mName.Set("<other bone>");
+	delete[] scene->mMeshes[5]->mVertices;
+	scene->mMeshes[5]->mVertices = NULL;
+	scene->mMeshes[5]->mNumVertices = 0;
+	CPPUNIT_ASSERT(!Passes(AI_VDS_LEVEL_HEADERS));
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
+// The structure level checks bones and nodes, but no per-element data
+void ValidateDSProcessTest::testStructureLevel (void)
+{
+	scene->mMeshes[3]->mFaces[0].mIndices[1] = 3;
+
+	CPPUNIT_ASSERT(Passes(AI_VDS_LEVEL_STRUCTURE));
+#ifndef ASSIMP_BUILD_DEBUG
+	aiMesh* mesh = scene->mMeshes[4];
+	mesh->mNumBones = 1;
+
+	std::string error;
+	CPPUNIT_ASSERT(!Passes(AI_VDS_LEVEL_STRUCTURE,&error));
+	CPPUNIT_ASSERT(std::string::npos != error.find("aiMesh::mBones is NULL"));
+	mesh->mNumBones = 0;
+
+	scene->mRootNode->mMeshes[7] = 8;
+	CPPUNIT_ASSERT(Passes(AI_VDS_LEVEL_HEADERS));
+	CPPUNIT_ASSERT(!Passes(AI_VDS_LEVEL_STRUCTURE,&error));
+	CPPUNIT_ASSERT(std::string::npos != error.find("aiNode::mMeshes[7] is out of range"));
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
+// The full level checks every face index
+void ValidateDSProcessTest::testFullLevel (void)
+{
+#ifndef ASSIMP_BUILD_DEBUG
+	scene->mMeshes[3]->mFaces[0].mIndices[1] = 3;
+
+	std::string error;
+	CPPUNIT_ASSERT(!Passes(AI_VDS_LEVEL_FULL,&error));
+	CPPUNIT_ASSERT(std::string::npos != error.find("aiMesh::mFaces[0]::mIndices[1] is out of range"));
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
+// Meshes are validated in parallel at the full level, the first error must still reach 
+// the caller as a single DeadlyImportError.
+void ValidateDSProcessTest::testErrorPropagation (void)
+{
+#ifndef ASSIMP_BUILD_DEBUG
+	scene->mMeshes[2]->mFaces[0].mIndices[0] = 3;
+	scene->mMeshes[6]->mFaces[0].mIndices[2] = 3;
+
+	std::string error;
+	CPPUNIT_ASSERT(!Passes(AI_VDS_LEVEL_FULL,&error));
+
+	const bool first = std::string::npos != error.find("mIndices[0] is out of range");
+	const bool second = std::string::npos != error.find("mIndices[2] is out of range");
+	CPPUNIT_ASSERT(0 == error.find("Validation failed: "));
+	CPPUNIT_ASSERT(first != second);
+
+	// the step is usable again afterwards
+	scene->mMeshes[2]->mFaces[0].mIndices[0] = 0;
+	scene->mMeshes[6]->mFaces[0].mIndices[2] = 2;
+	CPPUNIT_ASSERT(Passes(AI_VDS_LEVEL_FULL));
+#endif
+}
@@ -0,0 +1,44 @@
+#ifndef TESTVALIDATEDS_H
+#define TESTVALIDATEDS_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <assimp/scene.h>
+#include <assimp/Importer.hpp>
+#include <ValidateDataStructure.h>
+
+using namespace std;
+using namespace Assimp;
+
+class ValidateDSProcessTest : public CPPUNIT_NS :: TestFixture
+{
+    CPPUNIT_TEST_SUITE (ValidateDSProcessTest);
+    CPPUNIT_TEST (testValidScene);
+	CPPUNIT_TEST (testHeadersLevel);
+	CPPUNIT_TEST (testStructureLevel);
+	CPPUNIT_TEST (testFullLevel);
+	CPPUNIT_TEST (testErrorPropagation);
+    CPPUNIT_TEST_SUITE_END ();
+
+    public:
+		void setUp (void);
+		void tearDown (void);
+
+    protected:
+
+        void  testValidScene			(void);
+		void  testHeadersLevel			(void);
+		void  testStructureLevel		(void);
+		void  testFullLevel				(void);
+		void  testErrorPropagation		(void);
+
+	private:
+
+		bool Passes(unsigned int level, std::string* error = NULL);
+
+		ValidateDSProcess* piProcess;
+		aiScene* scene;
+};
+
+#endif
@@ -0,0 +1,153 @@
+#include "UnitTestPCH.h"
+#include "utVertexAnimation.h"
+
+#include <MakeVerboseFormat.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (VertexAnimationTest);
+
+// ------------------------------------------------------------------------------------------------
+void VertexAnimationTest::setUp (void)
+{
+	// import all frames of the model as vertex animation
+	pImp = new Importer();
+	pImp->SetPropertyInteger(AI_CONFIG_IMPORT_ALL_KEYFRAMES,1);
+}
+
+// ------------------------------------------------------------------------------------------------
+void VertexAnimationTest::tearDown (void)
+{
+	delete pImp;
+}
+
+// ------------------------------------------------------------------------------------------------
+void VertexAnimationTest::CheckAnimMeshes(const aiScene* sc)
+{
+	CPPUNIT_ASSERT(sc->mNumAnimations == 1);
+	const aiAnimation* anim = sc->mAnimations[0];
+	CPPUNIT_ASSERT(anim->mNumMeshChannels);
+
+	unsigned int animated = 0;
+	for (unsigned int i = 0; i < anim->mNumMeshChannels; ++i) {
+		const aiMeshAnim* channel = anim->mMeshChannels[i];
+		CPPUNIT_ASSERT(channel->mNumKeys);
+
+		for (unsigned int m = 0; m < sc->mNumMeshes; ++m) {
+			const aiMesh* mesh = sc->mMeshes[m];
+			if (mesh->mName != channel->mName) {
+				continue;
+			}
+			CPPUNIT_ASSERT(mesh->mNumAnimMeshes);
+			for (unsigned int a = 0; a < mesh->mNumAnimMeshes; ++a) {
+				CPPUNIT_ASSERT(mesh->mAnimMeshes[a]->mNumVertices == mesh->mNumVertices);
+				CPPUNIT_ASSERT(mesh->mAnimMeshes[a]->HasPositions());
+			}
+
+			// the host mesh got the first frame, its vertices must still line up with it
+			const aiAnimMesh* first = mesh->mAnimMeshes[channel->mKeys[0].mValue];
+			for (unsigned int v = 0; v < mesh->mNumVertices; ++v) {
+				CPPUNIT_ASSERT(first->mVertices[v] == mesh->mVertices[v]);
+			}
+			++animated;
+		}
+	}
+
+	// and there are no attachment meshes without a channel
+	for (unsigned int m = 0; m < sc->mNumMeshes; ++m) {
+		if (sc->mMeshes[m]->mNumAnimMeshes) {
+			--animated;
+		}
+	}
+	CPPUNIT_ASSERT(!animated);
+}
+
+// ------------------------------------------------------------------------------------------------
+void VertexAnimationTest::testSplitLargeMeshes (void)
+{
+	pImp->SetPropertyInteger(AI_CONFIG_PP_SLM_TRIANGLE_LIMIT,200);
+	pImp->SetPropertyInteger(AI_CONFIG_PP_SLM_VERTEX_LIMIT,300);
+
+	const aiScene* sc = pImp->ReadFile("../../test/models/MD2/faerie.md2",
+		aiProcess_JoinIdenticalVertices | aiProcess_SplitLargeMeshes | aiProcess_ValidateDataStructure);
+	CPPUNIT_ASSERT(sc);
+	CPPUNIT_ASSERT(sc->mNumMeshes > 1);
+	CheckAnimMeshes(sc);
+}
+
+// ------------------------------------------------------------------------------------------------
+void VertexAnimationTest::testMakeVerboseFormat (void)
+{
+	const aiScene* sc = pImp->ReadFile("../../test/models/MD2/faerie.md2",
+		aiProcess_JoinIdenticalVertices | aiProcess_ValidateDataStructure);
+	CPPUNIT_ASSERT(sc);
+
+	aiMesh* mesh = sc->mMeshes[0];
+	CPPUNIT_ASSERT(mesh->mNumVertices < mesh->mNumFaces*3);
+
+	MakeVerboseFormatProcess proc;
+	proc.Execute(const_cast<aiScene*>(sc));
+	CPPUNIT_ASSERT(mesh->mNumVertices == mesh->mNumFaces*3);
+	CheckAnimMeshes(sc);
+
+	CPPUNIT_ASSERT(pImp->ApplyPostProcessing(aiProcess_ValidateDataStructure));
+}
+
+// ------------------------------------------------------------------------------------------------
+void VertexAnimationTest::testFindDegenerates (void)
+{
+	pImp->SetPropertyInteger(AI_CONFIG_PP_FD_REMOVE,1);
+
+	const aiScene* sc = pImp->ReadFile("../../test/models/MD2/faerie.md2",aiProcess_ValidateDataStructure);
+	CPPUNIT_ASSERT(sc);
+
+	aiMesh* mesh = sc->mMeshes[0];
+	const unsigned int numFaces = mesh->mNumFaces;
+
+	// collapse an edge of the first face in the host mesh (and thus the first frame) only ...
+	const aiFace& f0 = mesh->mFaces[0];
+	mesh->mVertices[f0.mIndices[1]] = mesh->mVertices[f0.mIndices[0]];
+	aiAnimMesh* first = mesh->mAnimMeshes[sc->mAnimations[0]->mMeshChannels[0]->mKeys[0].mValue];
+	first->mVertices[f0.mIndices[1]] = first->mVertices[f0.mIndices[0]];
+
+	// ... and an edge of the second face in all frames
+	const aiFace& f1 = mesh->mFaces[1];
+	mesh->mVertices[f1.mIndices[1]] = mesh->mVertices[f1.mIndices[0]];
+	for (unsigned int a = 0; a < mesh->mNumAnimMeshes; ++a) {
+		aiAnimMesh* anim = mesh->mAnimMeshes[a];
+		anim->mVertices[f1.mIndices[1]] = anim->mVertices[f1.mIndices[0]];
+	}
+
+	CPPUNIT_ASSERT(pImp->ApplyPostProcessing(aiProcess_FindDegenerates | aiProcess_ValidateDataStructure));
+
+	// the first face moves apart during the animation, so it must be kept
+	CPPUNIT_ASSERT(mesh->mNumFaces == numFaces-1);
+	CPPUNIT_ASSERT(mesh->mFaces[0].mNumIndices == 3);
+	CheckAnimMeshes(sc);
+}
+
+// ------------------------------------------------------------------------------------------------
+void VertexAnimationTest::testPretransformVertices (void)
+{
+	for (int keepHierarchy = 0; keepHierarchy < 2; ++keepHierarchy) {
+		pImp->SetPropertyInteger(AI_CONFIG_PP_PTV_KEEP_HIERARCHY,keepHierarchy);
+
+		const aiScene* sc = pImp->ReadFile("../../test/models/MD2/faerie.md2",
+			aiProcess_PreTransformVertices | aiProcess_ValidateDataStructure);
+		CPPUNIT_ASSERT(sc);
+
+		// all animations are removed, vertex animations as well
+		CPPUNIT_ASSERT(!sc->mNumAnimations);
+		for (unsigned int m = 0; m < sc->mNumMeshes; ++m) {
+			CPPUNIT_ASSERT(!sc->mMeshes[m]->mNumAnimMeshes);
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+void VertexAnimationTest::testBoneSteps (void)
+{
+	// MD2 models have no bones, these steps must leave the vertex animation alone
+	const aiScene* sc = pImp->ReadFile("../../test/models/MD2/faerie.md2",
+		aiProcess_JoinIdenticalVertices | aiProcess_SplitByBoneCount | aiProcess_Debone | aiProcess_ValidateDataStructure);
+	CPPUNIT_ASSERT(sc);
+	CheckAnimMeshes(sc);
+}
@@ -0,0 +1,42 @@
+#ifndef TESTVERTEXANIMATION_H
+#define TESTVERTEXANIMATION_H
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+
+using namespace std;
+using namespace Assimp;
+
+class VertexAnimationTest : public CPPUNIT_NS :: TestFixture
+{
+    CPPUNIT_TEST_SUITE (VertexAnimationTest);
+    CPPUNIT_TEST (testSplitLargeMeshes);
+	CPPUNIT_TEST (testMakeVerboseFormat);
+	CPPUNIT_TEST (testFindDegenerates);
+	CPPUNIT_TEST (testPretransformVertices);
+	CPPUNIT_TEST (testBoneSteps);
+    CPPUNIT_TEST_SUITE_END ();
+
+    public:
+		void setUp (void);
+		void tearDown (void);
+
+    protected:
+
+        void  testSplitLargeMeshes		(void);
+		void  testMakeVerboseFormat		(void);
+		void  testFindDegenerates		(void);
+		void  testPretransformVertices	(void);
+		void  testBoneSteps				(void);
+
+	private:
+
+		void CheckAnimMeshes(const aiScene* sc);
+
+		Importer* pImp;
+};
+
+#endif 